@@ -0,0 +1,376 @@
+// ============================================================================
+// PixelWarBench - 引擎热点路径的微基准 (不创建窗口，不链接 GLFW)
+// 覆盖：Perlin fbm、区块生成、碰撞列表重建、射线-AABB、体素射线与方块点查询、敌人更新/回收/尸潮生成、摄像机物理
+// 输出：每项的 ns/op 与 items/s (JSON)，用于与主分支对比
+// ============================================================================
+
+#include "World.h"
+#include "Camera.h"
+#include "EnemyPool.h"
+#include "AIDirector.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr int DEFAULT_VIEW_DISTANCE_CHUNKS = 4; // 与游戏默认视距一致
+constexpr double DEFAULT_MIN_TIME = 0.5;        // 每项至少计时的秒数
+constexpr int SAMPLE_COUNT = 4096;              // 预生成的射线/坐标数量 (循环使用)
+constexpr float SIM_DT = 1.0f / 60.0f;
+
+struct BenchResult {
+    std::string name;
+    std::uint64_t iterations = 0;
+    double nsPerOp = 0.0;
+    double itemsPerOp = 0.0;
+    double itemsPerSecond = 0.0;
+};
+
+struct BenchOptions {
+    std::string outPath = "bench.json";
+    std::string filter;      // 只运行名称包含该子串的项
+    double minTime = DEFAULT_MIN_TIME;
+    int viewDistance = DEFAULT_VIEW_DISTANCE_CHUNKS;
+};
+
+// 防止结果被优化掉
+volatile double g_sink = 0.0;
+
+/**
+ * @brief 计时循环：迭代次数倍增，直到单轮耗时超过 minTime
+ * @param reset 每轮开始前 (不计时) 恢复初始状态，使各轮可比
+ * @param op 执行一次操作，参数为全局递增的迭代序号
+ */
+BenchResult Measure(const BenchOptions& options, const std::string& name, double itemsPerOp,
+                    const std::function<void()>& reset, const std::function<void(std::uint64_t)>& op)
+{
+    using Clock = std::chrono::steady_clock;
+    std::uint64_t counter = 0;
+    std::uint64_t iterations = 1;
+    double seconds = 0.0;
+
+    // 预热：填充缓存并让频率稳定
+    reset();
+    for (int i = 0; i < 3; ++i) op(counter++);
+
+    while (true) {
+        reset();
+        auto start = Clock::now();
+        for (std::uint64_t i = 0; i < iterations; ++i) op(counter++);
+        seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        if (seconds >= options.minTime || iterations >= (1ull << 40)) break;
+        // 按本轮速度估算达到 minTime 所需的次数，最多放大 10 倍
+        double scale = seconds > 0.0 ? options.minTime * 1.2 / seconds : 10.0;
+        iterations = static_cast<std::uint64_t>(static_cast<double>(iterations) * std::min(std::max(scale, 2.0), 10.0));
+    }
+
+    BenchResult result;
+    result.name = name;
+    result.iterations = iterations;
+    result.nsPerOp = seconds * 1e9 / static_cast<double>(iterations);
+    result.itemsPerOp = itemsPerOp;
+    result.itemsPerSecond = itemsPerOp * static_cast<double>(iterations) / seconds;
+    std::cout << "[Bench] " << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(14) << result.nsPerOp << " ns/op " << std::setw(16) << result.itemsPerSecond << " items/s" << std::endl;
+    return result;
+}
+
+void LoadViewWindow(int viewDistance)
+{
+    // 同步生成以原点为中心的视距窗口，并登记碰撞占用位图
+    g_loadedChunks.Clear();
+    g_collisionWorld.Clear();
+    g_loadedChunks.SetRadius(viewDistance, [](const ChunkKey&, ChunkData&) {});
+    g_heightTileCache.SetCapacity(HeightTileCache::CapacityForRadius(viewDistance));
+    g_loadedChunks.ForEachInView([](const ChunkKey& key) {
+        ChunkData* chunk = g_loadedChunks.Insert(key, GenerateChunk(key)).first;
+        RegisterChunkCollision(key, chunk->voxels);
+    });
+}
+
+std::vector<Ray> MakeTerrainRays(int viewDistance, std::uint32_t seed)
+{
+    // 与 --bench-raycast 相同的分布：站在地表上，向四周水平或略向下射击
+    float half = static_cast<float>(CHUNK_SIZE * viewDistance) * 0.5f;
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> posDist(-half, half);
+    std::uniform_real_distribution<float> angleDist(0.0f, 6.2831853f);
+    std::uniform_real_distribution<float> pitchDist(-0.6f, 0.2f);
+
+    std::vector<Ray> rays;
+    rays.reserve(SAMPLE_COUNT);
+    for (int i = 0; i < SAMPLE_COUNT; ++i) {
+        float x = posDist(rng);
+        float z = posDist(rng);
+        float y = SampleTerrainHeight(static_cast<int>(std::round(x)), static_cast<int>(std::round(z))) + 1.7f;
+        float yaw = angleDist(rng);
+        float pitch = pitchDist(rng);
+        glm::vec3 dir(std::cos(pitch) * std::cos(yaw), std::sin(pitch), std::cos(pitch) * std::sin(yaw));
+        rays.push_back({ glm::vec3(x, y, z), glm::normalize(dir) });
+    }
+    return rays;
+}
+
+glm::vec3 InverseDirection(const glm::vec3& dir)
+{
+    // 与 ProcessShooting 相同的除零处理
+    glm::vec3 invDir;
+    invDir.x = (std::abs(dir.x) < 1e-6f) ? 1e20f : 1.0f / dir.x;
+    invDir.y = (std::abs(dir.y) < 1e-6f) ? 1e20f : 1.0f / dir.y;
+    invDir.z = (std::abs(dir.z) < 1e-6f) ? 1e20f : 1.0f / dir.z;
+    return invDir;
+}
+
+glm::vec3 SpawnPosition(float x, float z)
+{
+    float y = SampleTerrainHeight(static_cast<int>(std::round(x)), static_cast<int>(std::round(z))) + 2.0f;
+    return glm::vec3(x, y, z);
+}
+
+bool WriteResults(const std::string& path, const BenchOptions& options, const std::vector<BenchResult>& results)
+{
+    std::ofstream os(path);
+    if (!os) {
+        std::cerr << "[Bench] Cannot write results to " << path << std::endl;
+        return false;
+    }
+    os << std::fixed << std::setprecision(4);
+    os << "{\n";
+    os << "  \"benchmark\": \"micro\",\n";
+    os << "  \"seed\": " << WORLD_SEED << ",\n";
+    os << "  \"viewDistance\": " << options.viewDistance << ",\n";
+    os << "  \"minTime\": " << options.minTime << ",\n";
+    os << "  \"results\": {\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        os << "    \"" << r.name << "\": { \"iterations\": " << r.iterations << ", \"nsPerOp\": " << r.nsPerOp
+           << ", \"itemsPerOp\": " << r.itemsPerOp << ", \"itemsPerSecond\": " << r.itemsPerSecond << " }"
+           << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    os << "  }\n";
+    os << "}\n";
+    std::cout << "[Bench] Wrote " << results.size() << " result(s) to " << path << std::endl;
+    return static_cast<bool>(os);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    // PixelWarBench [--out bench.json] [--filter name] [--min-time S] [--view-distance N]
+    BenchOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--out" && i + 1 < argc) options.outPath = argv[++i];
+        else if (arg == "--filter" && i + 1 < argc) options.filter = argv[++i];
+        else if (arg == "--min-time" && i + 1 < argc) options.minTime = std::max(0.01, std::atof(argv[++i]));
+        else if (arg == "--view-distance" && i + 1 < argc) options.viewDistance = std::max(1, std::atoi(argv[++i]));
+        else {
+            std::cerr << "Usage: PixelWarBench [--out bench.json] [--filter name] [--min-time S] [--view-distance N]" << std::endl;
+            return 2;
+        }
+    }
+
+    std::vector<BenchResult> results;
+    auto enabled = [&](const std::string& name) {
+        return options.filter.empty() || name.find(options.filter) != std::string::npos;
+    };
+    auto run = [&](const std::string& name, double itemsPerOp, const std::function<void()>& reset,
+                   const std::function<void(std::uint64_t)>& op) {
+        if (enabled(name)) results.push_back(Measure(options, name, itemsPerOp, reset, op));
+    };
+    const std::function<void()> noReset = []() {};
+
+    // 地形：视距窗口内的区块全部常驻 (区块磁盘缓存不参与)
+    std::cout << "[Bench] Generating " << (2 * options.viewDistance + 1) * (2 * options.viewDistance + 1)
+              << " chunk(s) (view distance " << options.viewDistance << ")" << std::endl;
+    LoadViewWindow(options.viewDistance);
+    std::vector<ChunkKey> loadedKeys;
+    size_t terrainBlocks = 0;
+    g_loadedChunks.ForEach([&](const ChunkKey& key, const ChunkData& chunk) {
+        loadedKeys.push_back(key);
+        terrainBlocks += chunk.voxels.blocks.size();
+    });
+    std::cout << "[Bench] Terrain blocks: " << terrainBlocks << std::endl;
+
+    // 1. Perlin fbm：与 terrainHeight 相同的频率与倍频程
+    run("perlin_fbm", 1.0, noReset, [](std::uint64_t i) {
+        float x = static_cast<float>(i % 1024) * g_terrainParams.baseFrequency;
+        float z = static_cast<float>(i / 1024 % 1024) * g_terrainParams.baseFrequency;
+        g_sink = g_sink + g_perlin.fbm(x, z, g_terrainParams.baseOctaves);
+    });
+
+    // 2. 区块生成 (高度图 + 方块表，不含网格)，items = 区块
+    run("generate_chunk", 1.0, noReset, [](std::uint64_t i) {
+        ChunkKey key{ static_cast<int>(i % 64) - 32, static_cast<int>(i / 64 % 64) - 32 };
+        ChunkData chunk = GenerateChunk(key);
+        g_sink = g_sink + static_cast<double>(chunk.voxels.blocks.size());
+    });
+
+    // 3. 碰撞占用位图：区块合并时的登记 (items = 区块) 与物理使用的邻域查询 (玩家周围 ±1/±2/±1)
+    run("register_chunk_collision", 1.0, noReset, [&](std::uint64_t i) {
+        const ChunkKey& key = loadedKeys[static_cast<size_t>(i % loadedKeys.size())];
+        RegisterChunkCollision(key, g_loadedChunks.Find(key)->voxels);
+        g_sink = g_sink + static_cast<double>(g_collisionWorld.GetChunkCount());
+    });
+    {
+        std::vector<glm::vec3> centers(SAMPLE_COUNT);
+        std::mt19937 rng(7u);
+        float half = static_cast<float>(CHUNK_SIZE * options.viewDistance) * 0.5f;
+        std::uniform_real_distribution<float> posDist(-half, half);
+        for (auto& c : centers) c = SpawnPosition(posDist(rng), posDist(rng)) - glm::vec3(0.0f, 1.0f, 0.0f);
+        run("collision_query", 1.0, noReset, [&](std::uint64_t i) {
+            const glm::vec3& c = centers[static_cast<size_t>(i % SAMPLE_COUNT)];
+            glm::vec3 cells[CollisionWorld::MAX_QUERY_CELLS];
+            int n = g_collisionWorld.QuerySolidCells(c - glm::vec3(1.0f, 2.0f, 1.0f), c + glm::vec3(1.0f, 2.0f, 1.0f),
+                                                     cells, CollisionWorld::MAX_QUERY_CELLS);
+            g_sink = g_sink + static_cast<double>(n);
+        });
+    }
+
+    // 4. 射线与敌人 AABB 相交 (Slab Method)
+    {
+        std::mt19937 rng(42u);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        std::vector<Ray> rays(SAMPLE_COUNT);
+        std::vector<glm::vec3> invDirs(SAMPLE_COUNT);
+        std::vector<glm::vec3> boxMins(SAMPLE_COUNT);
+        for (int i = 0; i < SAMPLE_COUNT; ++i) {
+            rays[i].origin = glm::vec3(unit(rng), unit(rng), unit(rng)) * 4.0f;
+            rays[i].direction = glm::normalize(glm::vec3(unit(rng), unit(rng), unit(rng)) + glm::vec3(0.0f, 0.0f, 1e-3f));
+            invDirs[i] = InverseDirection(rays[i].direction);
+            boxMins[i] = glm::vec3(unit(rng), unit(rng), unit(rng)) * 20.0f;
+        }
+        run("intersect_ray_aabb", 1.0, noReset, [&](std::uint64_t i) {
+            size_t idx = static_cast<size_t>(i % SAMPLE_COUNT);
+            float t = 0.0f;
+            if (intersectRayAABB(rays[idx], invDirs[idx], boxMins[idx], boxMins[idx] + glm::vec3(1.0f, 2.0f, 1.0f), t)) {
+                g_sink = g_sink + t;
+            }
+        });
+    }
+
+    // 5. 射击的地形检测 (3D DDA，最大射程与 ProcessShooting 一致)，以及它逐格调用的方块点查询
+    {
+        std::vector<Ray> rays = MakeTerrainRays(options.viewDistance, 1234u);
+        run("raycast_voxels", 1.0, noReset, [&](std::uint64_t i) {
+            const Ray& ray = rays[static_cast<size_t>(i % SAMPLE_COUNT)];
+            VoxelHit hit = RaycastVoxels(ray.origin, ray.direction, 80.0f);
+            g_sink = g_sink + hit.t;
+        });
+
+        // 查询点取地表下 3 格到地表上 8 格 (射线穿过的范围)，命中与空气各占一部分
+        struct VoxelQuery {
+            const ChunkVoxels* voxels;
+            int lx, y, lz;
+        };
+        std::vector<VoxelQuery> queries(SAMPLE_COUNT);
+        std::mt19937 rng(99u);
+        std::uniform_int_distribution<size_t> chunkDist(0, loadedKeys.size() - 1);
+        std::uniform_int_distribution<int> localDist(0, CHUNK_SIZE - 1);
+        std::uniform_int_distribution<int> offsetDist(-3, 8);
+        for (auto& q : queries) {
+            const ChunkData* chunk = g_loadedChunks.Find(loadedKeys[chunkDist(rng)]);
+            q.voxels = &chunk->voxels;
+            q.lx = localDist(rng);
+            q.lz = localDist(rng);
+            q.y = static_cast<int>(std::floor(chunk->heights.Get(q.lx * CHUNK_SIZE + q.lz))) + offsetDist(rng);
+        }
+        run("voxel_get", 1.0, noReset, [&](std::uint64_t i) {
+            const VoxelQuery& q = queries[static_cast<size_t>(i % SAMPLE_COUNT)];
+            g_sink = g_sink + static_cast<double>(q.voxels->Get(q.lx, q.y, q.lz));
+        });
+    }
+
+    // 6. 敌人更新：每轮从相同的出生布局开始 (玩家周围 8~30 格的环上)，op = 一次 UpdateAll
+    //    5000/10000 为压力测试：环的外半径按数量放大以保持与 1000 相同的密度 (近线性)，
+    //    但不超过 60 格，保证所有敌人都站在已加载的地形上 (10000 时密度约为 1000 的 2 倍)
+    for (int count : { 10, 100, 1000, 5000, 10000 }) {
+        const std::string name = "enemy_update_" + std::to_string(count);
+        if (!enabled(name)) continue;
+        const glm::vec3 playerPos = SpawnPosition(0.0f, 0.0f);
+        std::vector<glm::vec3> spawns;
+        std::mt19937 rng(static_cast<std::uint32_t>(count));
+        const float outerRadius = std::min(60.0f, std::max(30.0f, std::sqrt((count / 1000.0f) * (30.0f * 30.0f - 8.0f * 8.0f) + 8.0f * 8.0f)));
+        std::uniform_real_distribution<float> radius(8.0f, outerRadius);
+        std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+        for (int i = 0; i < count; ++i) {
+            float r = radius(rng);
+            float a = angle(rng);
+            spawns.push_back(SpawnPosition(std::cos(a) * r, std::sin(a) * r));
+        }
+
+        EnemyPool pool(static_cast<size_t>(count));
+        auto reset = [&]() {
+            while (!pool.GetActiveEnemies().empty()) pool.Release(pool.GetActiveEnemies().back());
+            for (const auto& p : spawns) pool.Acquire(p);
+        };
+        run(name, static_cast<double>(count), reset, [&](std::uint64_t) {
+            pool.UpdateAll(SIM_DT, playerPos, g_collisionWorld);
+        });
+        g_sink = g_sink + static_cast<double>(pool.GetActiveCount());
+    }
+
+    // 7. 成批回收与补充 (EnforceEnemyViewDistance 的模式)：5000 个敌人中回收一半再补回，items = 回收的敌人
+    if (enabled("enemy_cull_respawn_5000")) {
+        const int count = 5000;
+        const glm::vec3 spawn = SpawnPosition(0.0f, 0.0f);
+        EnemyPool pool(static_cast<size_t>(count));
+        for (int i = 0; i < count; ++i) pool.Acquire(spawn);
+        std::vector<Enemy> toCull;
+        toCull.reserve(count / 2);
+        run("enemy_cull_respawn_5000", static_cast<double>(count / 2), noReset, [&](std::uint64_t) {
+            toCull.clear();
+            const auto& active = pool.GetActiveEnemies();
+            for (size_t i = 0; i < active.size(); i += 2) toCull.push_back(active[i]);
+            for (const Enemy& enemy : toCull) pool.Release(enemy);
+            for (size_t i = 0; i < toCull.size(); ++i) pool.Acquire(spawn);
+        });
+        g_sink = g_sink + static_cast<double>(pool.GetActiveCount());
+    }
+
+    // 8. 尸潮生成：按导演的计划容量预热后生成整支尸潮再回收，items = 生成的敌人，生成期间不应分配
+    if (enabled("enemy_horde_spawn")) {
+        const int calmCount = 5;
+        const glm::vec3 spawn = SpawnPosition(0.0f, 0.0f);
+        EnemyPool pool(static_cast<size_t>(calmCount));
+        for (int i = 0; i < calmCount; ++i) pool.Acquire(spawn);
+        pool.Reserve(AIDirector::PlannedCapacity(pool.GetActiveCount()));
+        const size_t prewarmed = pool.GetAllocationCount();
+        const int spawnCount = static_cast<int>(pool.GetCapacity()) - calmCount;
+        run("enemy_horde_spawn", static_cast<double>(spawnCount), noReset, [&](std::uint64_t) {
+            for (int i = 0; i < spawnCount; ++i) pool.Acquire(spawn);
+            while (pool.GetActiveCount() > static_cast<size_t>(calmCount)) pool.Release(pool.GetActiveEnemies().back());
+        });
+        std::cout << "[Bench] Horde spawn allocations: " << pool.GetAllocationCount() - prewarmed
+                  << " (capacity " << pool.GetCapacity() << ")" << std::endl;
+        g_sink = g_sink + static_cast<double>(pool.GetActiveCount());
+    }
+
+    // 9. 摄像机物理 (重力 + 地形碰撞)，每秒跳跃一次
+    {
+        Camera camera;
+        const glm::vec3 spawn = SpawnPosition(0.0f, 0.0f);
+        auto reset = [&]() { camera.SetPosition(spawn); };
+        run("camera_update_physics", 1.0, reset, [&](std::uint64_t i) {
+            if (i % 60 == 0) camera.ProcessJump();
+            camera.UpdatePhysics(SIM_DT, g_collisionWorld);
+            g_sink = g_sink + camera.GetPosition().y;
+        });
+    }
+
+    std::cout << "[Bench] Checksum: " << g_sink << std::endl;
+    g_loadedChunks.Clear();
+    g_collisionWorld.Clear();
+    return WriteResults(options.outPath, options, results) ? 0 : 1;
+}
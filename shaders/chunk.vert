@@ -0,0 +1,26 @@
+#version 330 core
+
+layout (location = 0) in vec3 aPosition;  // 世界坐标 (网格已按区块偏移)
+layout (location = 1) in vec3 aNormal;    // 轴向法线
+layout (location = 2) in vec4 aColor;     // 方块颜色
+
+out VS_OUT {
+    vec3 vPosition;
+    vec3 vNormal;
+    vec2 vTexCoord;
+    vec3 vColor;
+} vs_out;
+
+uniform mat4 uView;
+uniform mat4 uProjection;
+
+void main()
+{
+    // 与 instanced.vert 输出相同，片段着色器共用 instanced.frag
+    vs_out.vPosition = aPosition;
+    vs_out.vNormal = aNormal;
+    vs_out.vTexCoord = vec2(0.0);
+    vs_out.vColor = aColor.rgb;
+
+    gl_Position = uProjection * uView * vec4(aPosition, 1.0);
+}
@@ -0,0 +1,11 @@
+#version 330 core
+layout (location = 0) in vec2 aPos;   // 已换算为 NDC
+layout (location = 1) in vec4 aColor;
+
+out vec4 Color;
+
+void main()
+{
+    gl_Position = vec4(aPos, 0.0, 1.0);
+    Color = aColor;
+}
@@ -5,6 +5,7 @@ layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoord;
 layout (location = 3) in vec3 aInstancePos;   // 实例位置
 layout (location = 4) in vec3 aInstanceColor; // 实例颜色
+layout (location = 5) in uint aFaceMask;      // 可见面掩码: bit0 +X, bit1 -X, bit2 +Y, bit3 -Y, bit4 +Z, bit5 -Z
 
 out VS_OUT {
     vec3 vPosition;
@@ -25,6 +26,18 @@ void main()
     vs_out.vNormal = aNormal;
     vs_out.vTexCoord = aTexCoord;
     vs_out.vColor = aInstanceColor;
+
+    // 立方体每个面有独立顶点，由法线确定所属的面
+    uint face;
+    if (abs(aNormal.x) > 0.5) face = aNormal.x > 0.0 ? 0u : 1u;
+    else if (abs(aNormal.y) > 0.5) face = aNormal.y > 0.0 ? 2u : 3u;
+    else face = aNormal.z > 0.0 ? 4u : 5u;
+
+    if ((aFaceMask & (1u << face)) == 0u) {
+        // 被遮挡的面：四个顶点折叠到裁剪空间外的同一点，三角形退化后被丢弃
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+        return;
+    }
     
     gl_Position = uProjection * uView * vec4(worldPos, 1.0);
 }
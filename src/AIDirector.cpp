@@ -1,5 +1,7 @@
 #include "AIDirector.h"
+#include "Profiler.h"
 #include <glm/glm.hpp>
+#include <algorithm>
 #include <random>
 #include <iostream>
 #include <cmath>
@@ -11,13 +13,15 @@ AIDirector::AIDirector(EnemyPool* enemyPool)
       m_spawnTimer(0.0f),
       m_hordeActive(false),
       m_hordeEnemiesSpawned(0),
-      m_hordeTarget(20),
+      m_hordeTarget(HORDE_SIZE),
       m_hordeDuration(0.0f),
-      m_tension(0.0f)
+      m_tension(0.0f),
+      m_rng(std::random_device{}())
 {
 }
 
 void AIDirector::Update(float deltaTime, bool playerIsShooting, const glm::vec3& playerPos, float viewDistance) {
+    PW_PROFILE_ZONE("AIDirector::Update");
     UpdateTension(playerIsShooting);
     
     m_stateTimer += deltaTime;
@@ -31,11 +35,13 @@ void AIDirector::Update(float deltaTime, bool playerIsShooting, const glm::vec3&
             if (m_tension > 3.0f) {
                 m_directorState = DirectorState::Building;
                 m_stateTimer = 0.0f;
+                // 提前按计划的尸潮规模扩容，尸潮生成期间对象池不再分配
+                m_enemyPool->Reserve(PlannedCapacity(currentCount));
                 std::cout << "[AI Director] Entering build-up phase..." << std::endl;
             }
             
             // 偶尔生成零星敌人 (每 3 秒 1 个)
-            if (m_spawnTimer > 3.0f && currentCount < 5) {
+            if (m_spawnTimer > 3.0f && currentCount < CALM_MAX_ENEMIES) {
                 SpawnWave(1, playerPos, viewDistance);
                 m_spawnTimer = 0.0f;
             }
@@ -44,11 +50,11 @@ void AIDirector::Update(float deltaTime, bool playerIsShooting, const glm::vec3&
         case DirectorState::Building: {
             // 压力继续积累或持续一定时间后触发尸潮
             if (m_tension > 8.0f || m_stateTimer > 5.0f) {
-                TriggerHorde(20);
+                TriggerHorde(HORDE_SIZE);
                 m_directorState = DirectorState::Horde;
                 std::cout << "[AI Director] ⚠️ Horde incoming! ⚠️" << std::endl;
-            } else if (m_spawnTimer > 1.5f && currentCount < 10) {
-                SpawnWave(2, playerPos, viewDistance);
+            } else if (m_spawnTimer > 1.5f && currentCount < BUILDING_MAX_ENEMIES) {
+                SpawnWave(BUILDING_WAVE_SIZE, playerPos, viewDistance);
                 m_spawnTimer = 0.0f;
             }
             break;
@@ -86,7 +92,14 @@ void AIDirector::UpdateTension(bool playerIsShooting) {
     m_tension = glm::max(0.0f, m_tension - 0.01f);
 }
 
+size_t AIDirector::PlannedCapacity(size_t currentCount) {
+    const size_t buildingPeak = BUILDING_MAX_ENEMIES - 1 + BUILDING_WAVE_SIZE;
+    return std::max(currentCount, buildingPeak) + HORDE_SIZE;
+}
+
 void AIDirector::TriggerHorde(int enemyCount) {
+    // 通常积累期入口已预留，这里只兜底 (例如 enemyCount 大于计划规模)
+    m_enemyPool->Reserve(m_enemyPool->GetActiveCount() + static_cast<size_t>(enemyCount));
     m_hordeTarget = enemyCount;
     m_hordeEnemiesSpawned = 0;
     m_hordeActive = true;
@@ -101,12 +114,11 @@ void AIDirector::SpawnWave(int count, const glm::vec3& playerPos, float viewDist
 }
 
 glm::vec3 AIDirector::GetRandomSpawnPosition(const glm::vec3& playerPos, float viewDistance) {
-    static std::mt19937 rng(std::random_device{}());
     std::uniform_real_distribution<float> distRadius(viewDistance * 0.35f, viewDistance * 0.85f);
     std::uniform_real_distribution<float> distAngle(0.0f, 6.2831853f);
 
-    float r = distRadius(rng);
-    float a = distAngle(rng);
+    float r = distRadius(m_rng);
+    float a = distAngle(m_rng);
 
     glm::vec3 pos(0.0f);
     pos.x = playerPos.x + std::cos(a) * r;
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "EnemyPool.h"
+#include <cstdint>
+#include <random>
 
 class AIDirector {
 public:
@@ -12,6 +14,17 @@ public:
     // 查询状态
     bool IsHordeActive() const { return m_hordeActive; }
 
+    // 固定生成点随机序列 (基准测试复现用)
+    void SetSeed(std::uint32_t seed) { m_rng.seed(seed); }
+
+    static constexpr int CALM_MAX_ENEMIES = 5;      // 平静期零星生成的上限
+    static constexpr int BUILDING_MAX_ENEMIES = 10; // 积累期成组生成的上限
+    static constexpr int BUILDING_WAVE_SIZE = 2;
+    static constexpr int HORDE_SIZE = 20;
+
+    // 进入积累期时对象池应预留的容量：积累期最多的敌人加上随后整支尸潮
+    static size_t PlannedCapacity(size_t currentCount);
+
 private:
     enum class DirectorState {
         Calm,      // 平静期
@@ -34,6 +47,8 @@ private:
     
     // 压力值系统
     float m_tension;
+
+    std::mt19937 m_rng;
     
     // 辅助函数
     void TriggerHorde(int enemyCount);
@@ -109,7 +109,7 @@ static bool CheckCollision(const AABB& one, const AABB& two) {
     return collisionX && collisionY && collisionZ;
 }
 
-void Camera::UpdatePhysics(float deltaTime, const std::vector<glm::vec3>& terrainBlocks)
+void Camera::UpdatePhysics(float deltaTime, const CollisionWorld& collision)
 {
     // 1. 应用重力
     m_velocity.y -= m_gravity * deltaTime;
@@ -152,20 +152,11 @@ void Camera::UpdatePhysics(float deltaTime, const std::vector<glm::vec3>& terrai
     playerBox.min = playerCenter - playerSize;
     playerBox.max = playerCenter + playerSize;
 
-    // 寻找最近的方块
-
-    std::vector<AABB> nearbyBlocks;
-    for (const auto& blockPos : terrainBlocks) {
-        // 快速剔除
-        if (glm::abs(blockPos.x - playerCenter.x) > 1.5f || 
-            glm::abs(blockPos.z - playerCenter.z) > 1.5f ||
-            glm::abs(blockPos.y - playerCenter.y) > 2.5f) continue;
-            
-        AABB blockBox;
-        blockBox.min = blockPos - glm::vec3(0.5f);
-        blockBox.max = blockPos + glm::vec3(0.5f);
-        nearbyBlocks.push_back(blockBox);
-    }
+    // 寻找最近的方块：中心距离 x/z 不超过 1.5、y 不超过 2.5 的实心方块 (直接索引占用位图，不分配内存)
+    glm::vec3 nearbyCells[CollisionWorld::MAX_QUERY_CELLS];
+    int nearbyCount = collision.QuerySolidCells(playerCenter - glm::vec3(1.0f, 2.0f, 1.0f),
+                                                playerCenter + glm::vec3(1.0f, 2.0f, 1.0f),
+                                                nearbyCells, CollisionWorld::MAX_QUERY_CELLS);
 
     // 迭代解决碰撞 (处理多个方块的共同作用)
     int iterations = 4;
@@ -175,7 +166,10 @@ void Camera::UpdatePhysics(float deltaTime, const std::vector<glm::vec3>& terrai
         playerBox.min = playerCenter - playerSize;
         playerBox.max = playerCenter + playerSize;
 
-        for (const auto& blockBox : nearbyBlocks) {
+        for (int i = 0; i < nearbyCount; ++i) {
+            AABB blockBox;
+            blockBox.min = nearbyCells[i] - glm::vec3(0.5f);
+            blockBox.max = nearbyCells[i] + glm::vec3(0.5f);
             if (CheckCollision(playerBox, blockBox)) {
                 // 计算重叠量
                 float overlapX = std::min(playerBox.max.x, blockBox.max.x) - std::max(playerBox.min.x, blockBox.min.x);
@@ -248,6 +242,13 @@ void Camera::ProcessMouseMovement(float xOffset, float yOffset, bool constrainPi
     UpdateCameraVectors();
 }
 
+void Camera::SetOrientation(float yaw, float pitch)
+{
+    m_yaw = yaw;
+    m_pitch = glm::clamp(pitch, MIN_PITCH, MAX_PITCH);
+    UpdateCameraVectors();
+}
+
 void Camera::ProcessMouseScroll(float yOffset)
 {
     // 根据滚轮方向调整 FOV
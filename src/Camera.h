@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include "CollisionWorld.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -98,9 +99,9 @@ public:
     /**
      * @brief 更新物理状态（重力、碰撞）
      * @param deltaTime 帧间时间差
-     * @param terrainBlocks 地形方块位置列表
+     * @param collision 地形碰撞查询
      */
-    void UpdatePhysics(float deltaTime, const std::vector<glm::vec3>& terrainBlocks);
+    void UpdatePhysics(float deltaTime, const CollisionWorld& collision);
 
     // ==================== Getter 接口 ====================
     /**
@@ -145,6 +146,11 @@ public:
         m_position = position;
     }
 
+    /**
+     * @brief 直接设置朝向 (度数)，用于脚本化路径
+     */
+    void SetOrientation(float yaw, float pitch);
+
     /**
      * @brief 设置移动速度
      */
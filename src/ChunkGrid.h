@@ -0,0 +1,171 @@
+#pragma once
+
+#include "ChunkTable.h"
+#include <cstddef>
+#include <cstdlib>
+#include <optional>
+#include <utility>
+#include <vector>
+
+/**
+ * @class ChunkGrid
+ * @brief 视距内区块的环形 (toroidal) 二维槽位数组
+ * @details
+ *   - 边长 2R+1，区块 (x, z) 固定放在槽位 (x mod 边长, z mod 边长)，视距窗口内每个坐标恰好对应一个槽位
+ *   - 查找只需取模并比较槽位中的键，不做散列
+ *   - 中心移动时只回收离开视距的行/列 (跨一个区块边界为 O(R))，中心不变时没有任何开销
+ *   - 区块数据直接存放在槽位中；半径变化 (SetRadius) 时才整体搬移
+ *   - 仅主线程访问
+ */
+template <typename V>
+class ChunkGrid {
+public:
+    ChunkGrid() { SetRadius(0, [](const ChunkKey&, V&) {}); }
+
+    ChunkGrid(const ChunkGrid&) = delete;
+    ChunkGrid& operator=(const ChunkGrid&) = delete;
+
+    int GetRadius() const { return m_radius; }
+    const ChunkKey& GetCenter() const { return m_center; }
+
+    bool InView(const ChunkKey& key) const {
+        return std::abs(key.x - m_center.x) <= m_radius && std::abs(key.z - m_center.z) <= m_radius;
+    }
+
+    V* Find(const ChunkKey& key) {
+        if (!InView(key)) return nullptr;
+        Slot& slot = m_slots[SlotIndex(key)];
+        return slot.value && slot.key == key ? &*slot.value : nullptr;
+    }
+
+    const V* Find(const ChunkKey& key) const {
+        return const_cast<ChunkGrid*>(this)->Find(key);
+    }
+
+    bool Contains(const ChunkKey& key) const { return Find(key) != nullptr; }
+
+    // 放入视距内的区块；键已存在时不覆盖，返回已有的值与 false；键不在视距内时返回 nullptr
+    std::pair<V*, bool> Insert(const ChunkKey& key, V&& value) {
+        if (!InView(key)) return { nullptr, false };
+        Slot& slot = m_slots[SlotIndex(key)];
+        if (slot.value) return { &*slot.value, false }; // 视距内的槽位只可能属于这个键
+        slot.key = key;
+        slot.value.emplace(std::move(value));
+        m_size++;
+        return { &*slot.value, true };
+    }
+
+    bool Erase(const ChunkKey& key) {
+        if (!Find(key)) return false;
+        m_slots[SlotIndex(key)].value.reset();
+        m_size--;
+        return true;
+    }
+
+    void Clear() {
+        for (auto& slot : m_slots) slot.value.reset();
+        m_size = 0;
+    }
+
+    /**
+     * @brief 移动视距中心
+     * @param onEvict 离开视距的已加载区块，回调 (const ChunkKey&, V&) 后回收槽位
+     * @param onEnter 新进入视距的坐标 (无论是否已加载)，回调 (const ChunkKey&)
+     * @return 中心是否变化
+     */
+    template <typename EvictFn, typename EnterFn>
+    bool Recenter(const ChunkKey& center, EvictFn&& onEvict, EnterFn&& onEnter) {
+        if (center == m_center) return false;
+        ChunkKey oldCenter = m_center;
+
+        // 1. 旧窗口中不在新窗口内的坐标：回收其槽位
+        ForEachOutside(oldCenter, center, [&](const ChunkKey& key) {
+            Slot& slot = m_slots[SlotIndex(key)];
+            if (!slot.value || !(slot.key == key)) return;
+            onEvict(key, *slot.value);
+            slot.value.reset();
+            m_size--;
+        });
+        m_center = center;
+
+        // 2. 新窗口中不在旧窗口内的坐标
+        ForEachOutside(center, oldCenter, onEnter);
+        return true;
+    }
+
+    // 改变视距半径：保留仍在视距内的区块，其余回调 onEvict 后丢弃
+    template <typename EvictFn>
+    void SetRadius(int radius, EvictFn&& onEvict) {
+        std::vector<Slot> oldSlots = std::move(m_slots);
+        m_radius = radius;
+        m_side = 2 * radius + 1;
+        m_slots = std::vector<Slot>(static_cast<std::size_t>(m_side) * m_side);
+        m_size = 0;
+        for (auto& slot : oldSlots) {
+            if (!slot.value) continue;
+            if (InView(slot.key)) Insert(slot.key, std::move(*slot.value));
+            else onEvict(slot.key, *slot.value);
+        }
+    }
+
+    // 遍历已加载区块：fn(const ChunkKey&, V&)。遍历期间不能插入或删除
+    template <typename Fn>
+    void ForEach(Fn&& fn) {
+        for (auto& slot : m_slots) {
+            if (slot.value) fn(static_cast<const ChunkKey&>(slot.key), *slot.value);
+        }
+    }
+
+    template <typename Fn>
+    void ForEach(Fn&& fn) const {
+        for (const auto& slot : m_slots) {
+            if (slot.value) fn(slot.key, *slot.value);
+        }
+    }
+
+    // 遍历视距窗口内的所有坐标：fn(const ChunkKey&)
+    template <typename Fn>
+    void ForEachInView(Fn&& fn) const {
+        for (int z = m_center.z - m_radius; z <= m_center.z + m_radius; ++z) {
+            for (int x = m_center.x - m_radius; x <= m_center.x + m_radius; ++x) fn(ChunkKey{ x, z });
+        }
+    }
+
+    std::size_t Size() const { return m_size; }
+    bool Empty() const { return m_size == 0; }
+
+private:
+    struct Slot {
+        ChunkKey key{ 0, 0 };
+        std::optional<V> value;
+    };
+
+    std::vector<Slot> m_slots;
+    int m_radius = 0;
+    int m_side = 1;
+    ChunkKey m_center{ 0, 0 };
+    std::size_t m_size = 0;
+
+    std::size_t SlotIndex(const ChunkKey& key) const {
+        int sx = key.x % m_side;
+        int sz = key.z % m_side;
+        if (sx < 0) sx += m_side;
+        if (sz < 0) sz += m_side;
+        return static_cast<std::size_t>(sz) * m_side + sx;
+    }
+
+    // 以 a 为中心的窗口中、不在以 b 为中心的窗口内的坐标 (行扫描，只访问差集)
+    template <typename Fn>
+    void ForEachOutside(const ChunkKey& a, const ChunkKey& b, Fn&& fn) const {
+        for (int z = a.z - m_radius; z <= a.z + m_radius; ++z) {
+            bool rowShared = std::abs(z - b.z) <= m_radius;
+            for (int x = a.x - m_radius; x <= a.x + m_radius; ++x) {
+                if (rowShared && std::abs(x - b.x) <= m_radius) {
+                    x = b.x + m_radius; // 跳过两个窗口共有的一段
+                    continue;
+                }
+                fn(ChunkKey{ x, z });
+            }
+        }
+    }
+};
@@ -0,0 +1,90 @@
+#include "ChunkMesh.h"
+#include <algorithm>
+#include <vector>
+
+GLuint ChunkMesh::s_quadIndexBuffer = 0;
+size_t ChunkMesh::s_quadIndexCapacity = 0;
+
+ChunkMesh::ChunkMesh()
+    : m_VAO(0), m_VBO(0), m_quadCount(0), m_capacityBytes(0)
+{
+    glGenVertexArrays(1, &m_VAO);
+    glGenBuffers(1, &m_VBO);
+    ensureQuadIndices(1);
+
+    glBindVertexArray(m_VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+    // Layout 0: 位置, 1: 法线 (有符号字节归一化), 2: 颜色 (无符号字节归一化)
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(ChunkVertex), (void*)offsetof(ChunkVertex, position));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_BYTE, GL_TRUE, sizeof(ChunkVertex), (void*)offsetof(ChunkVertex, normal));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ChunkVertex), (void*)offsetof(ChunkVertex, color));
+    glEnableVertexAttribArray(2);
+    // VAO 记录索引缓冲的名字，共享缓冲增长时名字不变，无需重新绑定
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, s_quadIndexBuffer);
+    glBindVertexArray(0);
+}
+
+ChunkMesh::~ChunkMesh()
+{
+    glDeleteBuffers(1, &m_VBO);
+    glDeleteVertexArrays(1, &m_VAO);
+}
+
+void ChunkMesh::upload(const ChunkMeshData& data)
+{
+    m_quadCount = data.GetQuadCount();
+    if (m_quadCount == 0) return;
+    ensureQuadIndices(m_quadCount);
+
+    size_t bytes = data.vertices.size() * sizeof(ChunkVertex);
+    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+    if (bytes > m_capacityBytes) {
+        m_capacityBytes = bytes;
+        glBufferData(GL_ARRAY_BUFFER, bytes, data.vertices.data(), GL_STATIC_DRAW);
+    } else {
+        glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, data.vertices.data());
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void ChunkMesh::draw() const
+{
+    if (m_quadCount == 0) return;
+    glBindVertexArray(m_VAO);
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(m_quadCount * 6), GL_UNSIGNED_INT, 0);
+    glBindVertexArray(0);
+}
+
+void ChunkMesh::ensureQuadIndices(size_t quadCount)
+{
+    if (s_quadIndexBuffer == 0) glGenBuffers(1, &s_quadIndexBuffer);
+    if (quadCount <= s_quadIndexCapacity) return;
+
+    size_t newCapacity = std::max<size_t>(quadCount, std::max<size_t>(s_quadIndexCapacity * 2, 4096));
+    std::vector<GLuint> indices(newCapacity * 6);
+    for (size_t q = 0; q < newCapacity; ++q) {
+        GLuint base = static_cast<GLuint>(q * 4);
+        indices[q * 6 + 0] = base + 0;
+        indices[q * 6 + 1] = base + 1;
+        indices[q * 6 + 2] = base + 2;
+        indices[q * 6 + 3] = base + 2;
+        indices[q * 6 + 4] = base + 3;
+        indices[q * 6 + 5] = base + 0;
+    }
+
+    // 绑定到 ELEMENT_ARRAY_BUFFER 会改动当前 VAO 的状态，先解绑
+    glBindVertexArray(0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, s_quadIndexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    s_quadIndexCapacity = newCapacity;
+}
+
+void ChunkMesh::releaseSharedResources()
+{
+    if (s_quadIndexBuffer) glDeleteBuffers(1, &s_quadIndexBuffer);
+    s_quadIndexBuffer = 0;
+    s_quadIndexCapacity = 0;
+}
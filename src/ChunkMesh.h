@@ -0,0 +1,43 @@
+#pragma once
+
+#include "ChunkMesher.h"
+#include <glad/glad.h>
+#include <cstddef>
+
+/**
+ * @class ChunkMesh
+ * @brief 单个区块的贪心网格 (GPU 端)
+ * @details
+ *   - 每个区块一个 VAO/VBO，顶点格式见 ChunkVertex
+ *   - 所有区块共享同一个四边形索引缓冲 (0-1-2, 2-3-0)，按需增长
+ *   - 仅主线程调用
+ */
+class ChunkMesh {
+public:
+    ChunkMesh();
+    ~ChunkMesh();
+
+    ChunkMesh(const ChunkMesh&) = delete;
+    ChunkMesh& operator=(const ChunkMesh&) = delete;
+
+    // 上传网格数据 (替换之前的内容)
+    void upload(const ChunkMeshData& data);
+
+    void draw() const;
+
+    size_t getQuadCount() const { return m_quadCount; }
+
+    // 程序退出前释放共享索引缓冲
+    static void releaseSharedResources();
+
+private:
+    GLuint m_VAO;
+    GLuint m_VBO;
+    size_t m_quadCount;
+    size_t m_capacityBytes;
+
+    static GLuint s_quadIndexBuffer;
+    static size_t s_quadIndexCapacity; // 可容纳的四边形数
+
+    static void ensureQuadIndices(size_t quadCount);
+};
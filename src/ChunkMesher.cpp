@@ -0,0 +1,134 @@
+#include "ChunkMesher.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+std::uint8_t ToUnorm8(float v)
+{
+    return static_cast<std::uint8_t>(std::lround(std::clamp(v, 0.0f, 1.0f) * 255.0f));
+}
+
+} // namespace
+
+void ChunkMesher::BuildGreedy(const ChunkMeshInput& input, ChunkMeshData& out)
+{
+    out.vertices.clear();
+    if (input.height <= 0 || !input.cells) return;
+
+    const int S = input.size;
+    const int dims[3] = { S, input.height, S }; // 局部坐标顺序 (x, y, z)
+
+    auto cellAt = [&](const int p[3]) -> std::uint8_t {
+        return input.cells[(static_cast<size_t>(p[1]) * S + p[0]) * S + p[2]];
+    };
+
+    // 相邻格是否遮挡：体素存储或相邻区块边缘中的方块，或位于列顶及以下的隐式地基
+    auto occludes = [&](const int p[3]) -> bool {
+        bool insideXZ = p[0] >= 0 && p[0] < S && p[2] >= 0 && p[2] < S;
+        if (p[1] >= 0 && p[1] < dims[1]) {
+            if (insideXZ) {
+                if (cellAt(p) != 0) return true;
+            } else if (input.borderCells) {
+                // 只查询与区块共边的一圈 (面邻居不会落在角上)
+                int side = p[0] < 0 ? 0 : p[0] >= S ? 1 : p[2] < 0 ? 2 : 3;
+                int i = side < 2 ? p[2] : p[0];
+                if (input.borderCells[(static_cast<size_t>(p[1]) * 4 + side) * S + i] != 0) return true;
+            }
+        }
+        int top = input.columnTops[(p[0] + 1) * (S + 2) + (p[2] + 1)];
+        return p[1] + input.minY <= top;
+    };
+
+    const float origin[3] = { static_cast<float>(input.originX), static_cast<float>(input.minY), static_cast<float>(input.originZ) };
+    std::vector<std::uint8_t> mask;
+
+    for (int d = 0; d < 3; ++d) {
+        // u, v 与 d 构成右手系 (e_u x e_v = e_d)，便于统一卷绕方向
+        const int u = (d + 1) % 3;
+        const int v = (d + 2) % 3;
+        mask.assign(static_cast<size_t>(dims[u]) * dims[v], 0);
+
+        for (int sign = -1; sign <= 1; sign += 2) {
+            std::int8_t normal[4] = { 0, 0, 0, 0 };
+            normal[d] = static_cast<std::int8_t>(sign);
+
+            for (int slice = 0; slice < dims[d]; ++slice) {
+                // 1. 构建该切片的暴露面掩码 (调色板下标，0 表示无面)
+                for (int b = 0; b < dims[v]; ++b) {
+                    for (int a = 0; a < dims[u]; ++a) {
+                        int p[3];
+                        p[d] = slice;
+                        p[u] = a;
+                        p[v] = b;
+                        std::uint8_t c = cellAt(p);
+                        if (c != 0) {
+                            int n[3] = { p[0], p[1], p[2] };
+                            n[d] += sign;
+                            if (occludes(n)) c = 0;
+                        }
+                        mask[static_cast<size_t>(b) * dims[u] + a] = c;
+                    }
+                }
+
+                // 2. 贪心合并：先沿 u 扩展宽度，再沿 v 扩展高度
+                for (int b = 0; b < dims[v]; ++b) {
+                    for (int a = 0; a < dims[u];) {
+                        std::uint8_t c = mask[static_cast<size_t>(b) * dims[u] + a];
+                        if (c == 0) {
+                            ++a;
+                            continue;
+                        }
+
+                        int w = 1;
+                        while (a + w < dims[u] && mask[static_cast<size_t>(b) * dims[u] + a + w] == c) ++w;
+
+                        int h = 1;
+                        bool grow = true;
+                        while (b + h < dims[v] && grow) {
+                            for (int k = 0; k < w; ++k) {
+                                if (mask[static_cast<size_t>(b + h) * dims[u] + a + k] != c) {
+                                    grow = false;
+                                    break;
+                                }
+                            }
+                            if (grow) ++h;
+                        }
+
+                        for (int hh = 0; hh < h; ++hh) {
+                            std::fill_n(mask.begin() + static_cast<size_t>(b + hh) * dims[u] + a, w, 0);
+                        }
+
+                        // 3. 输出四边形。方块以整数坐标为中心，面位于中心 ±0.5 处
+                        ChunkVertex vert;
+                        std::copy(normal, normal + 4, vert.normal);
+                        const glm::vec3& color = input.paletteColors[c];
+                        vert.color[0] = ToUnorm8(color.r);
+                        vert.color[1] = ToUnorm8(color.g);
+                        vert.color[2] = ToUnorm8(color.b);
+                        vert.color[3] = 255;
+
+                        float plane = origin[d] + static_cast<float>(slice) + 0.5f * static_cast<float>(sign);
+                        float u0 = origin[u] + static_cast<float>(a) - 0.5f;
+                        float u1 = u0 + static_cast<float>(w);
+                        float v0 = origin[v] + static_cast<float>(b) - 0.5f;
+                        float v1 = v0 + static_cast<float>(h);
+                        const float corners[4][2] = { { u0, v0 }, { u1, v0 }, { u1, v1 }, { u0, v1 } };
+                        // 正方向面按 0-1-2-3 逆时针，负方向面反向
+                        static const int ORDER_POS[4] = { 0, 1, 2, 3 };
+                        static const int ORDER_NEG[4] = { 0, 3, 2, 1 };
+                        const int* order = sign > 0 ? ORDER_POS : ORDER_NEG;
+                        for (int k = 0; k < 4; ++k) {
+                            vert.position[d] = plane;
+                            vert.position[u] = corners[order[k]][0];
+                            vert.position[v] = corners[order[k]][1];
+                            out.vertices.push_back(vert);
+                        }
+
+                        a += w;
+                    }
+                }
+            }
+        }
+    }
+}
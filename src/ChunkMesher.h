@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+// 区块网格顶点 (20 字节)：位置 + 压缩法线 + RGBA8 颜色
+struct ChunkVertex {
+    float position[3];
+    std::int8_t normal[4];  // xyz 为 -1/0/1 (GL_BYTE 归一化)，w 未使用
+    std::uint8_t color[4];  // GL_UNSIGNED_BYTE 归一化
+};
+static_assert(sizeof(ChunkVertex) == 20, "ChunkVertex must stay 20 bytes");
+
+// 网格生成结果：每个四边形 4 个顶点，索引使用共享的四边形索引缓冲
+struct ChunkMeshData {
+    std::vector<ChunkVertex> vertices;
+
+    size_t GetQuadCount() const { return vertices.size() / 4; }
+};
+
+// 网格生成的输入 (不依赖具体的区块/方块类型)
+struct ChunkMeshInput {
+    int originX = 0;                        // 区块 (0, 0) 列的世界坐标
+    int originZ = 0;
+    int size = 16;                          // 区块边长
+    int minY = 0;                           // 体素存储的最低层
+    int height = 0;                         // 体素存储的层数
+    const std::uint8_t* cells = nullptr;    // 下标 ((y - minY) * size + lx) * size + lz，0 为空气
+    const glm::vec3* paletteColors = nullptr; // 每个调色板下标对应的颜色
+    // (size + 2)^2 个列顶高度，下标 (lx + 1) * (size + 2) + (lz + 1)，包含相邻区块的一圈。
+    // 地表只存储表层方块，列顶及以下视为实心 (隐式地基)，用于剔除被挡住的面
+    const int* columnTops = nullptr;
+    // 相邻区块边缘列中高于列顶的方块，下标 ((y - minY) * 4 + side) * size + i，非 0 为实心。
+    // side 依次为 -x、+x、-z、+z，i 为沿边方向的坐标；为空时只按列顶判断
+    const std::uint8_t* borderCells = nullptr;
+};
+
+/**
+ * @class ChunkMesher
+ * @brief 区块贪心网格生成 (可在工作线程调用，不访问 OpenGL)
+ * @details
+ *   - 只输出相邻格不是实心的面 (暴露面)
+ *   - 同一切片内相同调色板下标的相邻面贪心合并为更大的矩形
+ */
+class ChunkMesher {
+public:
+    static void BuildGreedy(const ChunkMeshInput& input, ChunkMeshData& out);
+};
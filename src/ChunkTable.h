@@ -0,0 +1,232 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+// 区块坐标 (以区块为单位)
+struct ChunkKey {
+    int x;
+    int z;
+    bool operator==(const ChunkKey& other) const noexcept {
+        return x == other.x && z == other.z;
+    }
+};
+
+// 区块坐标的 64 位 Morton 码：x 占偶数位，z 占奇数位 (坐标先加偏移转为无符号)。
+// 相邻区块的编码相近，且一次整数比较即可判断键是否相等
+inline std::uint64_t ChunkMortonCode(const ChunkKey& key) noexcept
+{
+    auto spread = [](std::uint32_t v) {
+        std::uint64_t x = v;
+        x = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+        x = (x | (x << 8)) & 0x00FF00FF00FF00FFull;
+        x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0Full;
+        x = (x | (x << 2)) & 0x3333333333333333ull;
+        x = (x | (x << 1)) & 0x5555555555555555ull;
+        return x;
+    };
+    std::uint32_t ux = static_cast<std::uint32_t>(key.x) ^ 0x80000000u;
+    std::uint32_t uz = static_cast<std::uint32_t>(key.z) ^ 0x80000000u;
+    return spread(ux) | (spread(uz) << 1);
+}
+
+inline ChunkKey ChunkKeyFromMorton(std::uint64_t code) noexcept
+{
+    auto compact = [](std::uint64_t x) {
+        x &= 0x5555555555555555ull;
+        x = (x | (x >> 1)) & 0x3333333333333333ull;
+        x = (x | (x >> 2)) & 0x0F0F0F0F0F0F0F0Full;
+        x = (x | (x >> 4)) & 0x00FF00FF00FF00FFull;
+        x = (x | (x >> 8)) & 0x0000FFFF0000FFFFull;
+        x = (x | (x >> 16)) & 0x00000000FFFFFFFFull;
+        return static_cast<std::uint32_t>(x);
+    };
+    return { static_cast<int>(compact(code) ^ 0x80000000u), static_cast<int>(compact(code >> 1) ^ 0x80000000u) };
+}
+
+// Fibonacci 散列：乘法把 Morton 码的差异扩散到高位
+inline std::uint64_t MixChunkCode(std::uint64_t code) noexcept
+{
+    return code * 0x9E3779B97F4A7C15ull;
+}
+
+// 标准容器用的散列 (待加载集合等)
+struct ChunkKeyHash {
+    std::size_t operator()(const ChunkKey& k) const noexcept {
+        std::uint64_t h = MixChunkCode(ChunkMortonCode(k));
+        return static_cast<std::size_t>(h ^ (h >> 32));
+    }
+};
+
+/**
+ * @class ChunkTable
+ * @brief 已加载区块的扁平开放寻址散列表
+ * @details
+ *   - 键为 Morton 码，线性探测；每个槽位 1 字节元数据 (占用位 + 7 位指纹)，探测时先比较指纹
+ *   - 元数据、键、值分别连续存放，值直接存放在槽位中 (不单独分配节点)
+ *   - 删除使用反向移位 (backward shift)，不留墓碑，探测长度不会随删除退化
+ *   - 插入 (扩容) 与删除会移动元素，之前取得的值指针随之失效
+ *   - 仅主线程访问
+ */
+template <typename V>
+class ChunkTable {
+public:
+    ChunkTable() = default;
+    ~ChunkTable() { Clear(); }
+
+    ChunkTable(const ChunkTable&) = delete;
+    ChunkTable& operator=(const ChunkTable&) = delete;
+
+    V* Find(const ChunkKey& key) {
+        std::size_t slot = FindSlot(ChunkMortonCode(key));
+        return slot == NOT_FOUND ? nullptr : Value(slot);
+    }
+
+    const V* Find(const ChunkKey& key) const {
+        return const_cast<ChunkTable*>(this)->Find(key);
+    }
+
+    bool Contains(const ChunkKey& key) const { return Find(key) != nullptr; }
+
+    // 插入新区块；键已存在时不覆盖，返回已有的值与 false
+    std::pair<V*, bool> Insert(const ChunkKey& key, V&& value) {
+        std::uint64_t code = ChunkMortonCode(key);
+        std::size_t existing = FindSlot(code);
+        if (existing != NOT_FOUND) return { Value(existing), false };
+
+        if ((m_size + 1) * MAX_LOAD_DEN > m_capacity * MAX_LOAD_NUM) Rehash(m_capacity ? m_capacity * 2 : MIN_CAPACITY);
+        std::size_t slot = InsertNew(code, std::move(value));
+        return { Value(slot), true };
+    }
+
+    // 预留容量，插入 count 个区块前不再扩容
+    void Reserve(std::size_t count) {
+        std::size_t capacity = m_capacity ? m_capacity : MIN_CAPACITY;
+        while (count * MAX_LOAD_DEN > capacity * MAX_LOAD_NUM) capacity *= 2;
+        if (capacity != m_capacity) Rehash(capacity);
+    }
+
+    bool Erase(const ChunkKey& key) {
+        std::size_t hole = FindSlot(ChunkMortonCode(key));
+        if (hole == NOT_FOUND) return false;
+        Value(hole)->~V();
+
+        // 反向移位：把后面同一探测链上的元素前移填补空位，直到遇到空槽
+        const std::size_t mask = m_capacity - 1;
+        for (std::size_t next = (hole + 1) & mask; m_ctrl[next] != EMPTY; next = (next + 1) & mask) {
+            std::size_t home = HomeSlot(MixChunkCode(m_keys[next]));
+            // 元素的起始槽不在 (hole, next] 区间内时，移到空位上仍可被探测到
+            if (((next - home) & mask) >= ((next - hole) & mask)) {
+                m_ctrl[hole] = m_ctrl[next];
+                m_keys[hole] = m_keys[next];
+                new (Value(hole)) V(std::move(*Value(next)));
+                Value(next)->~V();
+                hole = next;
+            }
+        }
+        m_ctrl[hole] = EMPTY;
+        m_size--;
+        return true;
+    }
+
+    void Clear() {
+        for (std::size_t i = 0; i < m_capacity; ++i) {
+            if (m_ctrl[i] != EMPTY) {
+                Value(i)->~V();
+                m_ctrl[i] = EMPTY;
+            }
+        }
+        m_size = 0;
+    }
+
+    // 遍历所有区块：fn(const ChunkKey&, V&)。遍历期间不能插入或删除
+    template <typename Fn>
+    void ForEach(Fn&& fn) {
+        for (std::size_t i = 0; i < m_capacity; ++i) {
+            if (m_ctrl[i] != EMPTY) fn(ChunkKeyFromMorton(m_keys[i]), *Value(i));
+        }
+    }
+
+    template <typename Fn>
+    void ForEach(Fn&& fn) const {
+        for (std::size_t i = 0; i < m_capacity; ++i) {
+            if (m_ctrl[i] != EMPTY) fn(ChunkKeyFromMorton(m_keys[i]), static_cast<const V&>(*Value(i)));
+        }
+    }
+
+    std::size_t Size() const { return m_size; }
+    bool Empty() const { return m_size == 0; }
+    std::size_t GetCapacity() const { return m_capacity; }
+
+private:
+    struct alignas(V) Storage {
+        unsigned char bytes[sizeof(V)];
+    };
+
+    static constexpr std::uint8_t EMPTY = 0;
+    static constexpr std::size_t NOT_FOUND = static_cast<std::size_t>(-1);
+    static constexpr std::size_t MIN_CAPACITY = 64;
+    static constexpr std::size_t MAX_LOAD_NUM = 3; // 负载上限 3/4
+    static constexpr std::size_t MAX_LOAD_DEN = 4;
+
+    std::unique_ptr<std::uint8_t[]> m_ctrl;   // 0 为空槽，否则 0x80 | 7 位指纹
+    std::unique_ptr<std::uint64_t[]> m_keys;  // Morton 码
+    std::unique_ptr<Storage[]> m_values;
+    std::size_t m_capacity = 0;               // 2 的幂
+    int m_shift = 64;                         // 起始槽 = 散列值 >> m_shift
+    std::size_t m_size = 0;
+
+    V* Value(std::size_t slot) const { return std::launder(reinterpret_cast<V*>(m_values[slot].bytes)); }
+
+    std::size_t HomeSlot(std::uint64_t hash) const { return static_cast<std::size_t>(hash >> m_shift); }
+    static std::uint8_t Fingerprint(std::uint64_t hash) { return static_cast<std::uint8_t>(0x80 | (hash & 0x7F)); }
+
+    std::size_t FindSlot(std::uint64_t code) const {
+        if (m_size == 0) return NOT_FOUND;
+        const std::uint64_t hash = MixChunkCode(code);
+        const std::uint8_t tag = Fingerprint(hash);
+        const std::size_t mask = m_capacity - 1;
+        for (std::size_t slot = HomeSlot(hash);; slot = (slot + 1) & mask) {
+            if (m_ctrl[slot] == EMPTY) return NOT_FOUND;
+            if (m_ctrl[slot] == tag && m_keys[slot] == code) return slot;
+        }
+    }
+
+    // 调用前已确认键不存在且容量足够
+    std::size_t InsertNew(std::uint64_t code, V&& value) {
+        const std::uint64_t hash = MixChunkCode(code);
+        const std::size_t mask = m_capacity - 1;
+        std::size_t slot = HomeSlot(hash);
+        while (m_ctrl[slot] != EMPTY) slot = (slot + 1) & mask;
+        m_ctrl[slot] = Fingerprint(hash);
+        m_keys[slot] = code;
+        new (Value(slot)) V(std::move(value));
+        m_size++;
+        return slot;
+    }
+
+    void Rehash(std::size_t newCapacity) {
+        std::unique_ptr<std::uint8_t[]> oldCtrl = std::move(m_ctrl);
+        std::unique_ptr<std::uint64_t[]> oldKeys = std::move(m_keys);
+        std::unique_ptr<Storage[]> oldValues = std::move(m_values);
+        std::size_t oldCapacity = m_capacity;
+
+        m_ctrl.reset(new std::uint8_t[newCapacity]());
+        m_keys.reset(new std::uint64_t[newCapacity]);
+        m_values.reset(new Storage[newCapacity]);
+        m_capacity = newCapacity;
+        m_shift = 64;
+        for (std::size_t c = newCapacity; c > 1; c >>= 1) m_shift--;
+        m_size = 0;
+
+        for (std::size_t i = 0; i < oldCapacity; ++i) {
+            if (oldCtrl[i] == EMPTY) continue;
+            V* old = std::launder(reinterpret_cast<V*>(oldValues[i].bytes));
+            InsertNew(oldKeys[i], std::move(*old));
+            old->~V();
+        }
+    }
+};
@@ -0,0 +1,167 @@
+#include "ChunkWorkerPool.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <pthread.h>
+#endif
+
+namespace {
+
+thread_local int t_workerIndex = -1;
+
+} // namespace
+
+ChunkWorkerPool::ChunkWorkerPool(unsigned int workerCount)
+{
+    unsigned int count = ResolveWorkerCount(workerCount);
+    m_workers.reserve(count);
+    for (unsigned int i = 0; i < count; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    // 先创建全部队列再启动线程，避免窃取时访问未构造的 Worker
+    for (unsigned int i = 0; i < count; ++i) {
+        m_workers[i]->thread = std::thread(&ChunkWorkerPool::WorkerLoop, this, i);
+    }
+}
+
+ChunkWorkerPool::~ChunkWorkerPool()
+{
+    Shutdown();
+}
+
+unsigned int ChunkWorkerPool::ResolveWorkerCount(unsigned int requested)
+{
+    if (requested > 0) return requested;
+    unsigned int hw = std::thread::hardware_concurrency();
+    if (hw <= 1) return 1;
+    return hw - 1;
+}
+
+int ChunkWorkerPool::GetCurrentWorkerIndex()
+{
+    return t_workerIndex;
+}
+
+bool ChunkWorkerPool::Submit(Job job)
+{
+    if (m_workers.empty() || m_exit.load(std::memory_order_relaxed)) return false;
+
+    // 轮流分发，目标任务环已满时依次尝试下一个
+    const unsigned int count = GetWorkerCount();
+    unsigned int start = m_nextWorker.fetch_add(1, std::memory_order_relaxed) % count;
+    bool pushed = false;
+    for (unsigned int offset = 0; offset < count && !pushed; ++offset) {
+        pushed = m_workers[(start + offset) % count]->jobs.TryPush(std::move(job));
+    }
+    if (!pushed) return false;
+
+    // 在睡眠锁内发布计数：工作线程检查条件与进入等待之间不会漏掉这次唤醒 (锁只覆盖一次自增)
+    {
+        std::lock_guard<std::mutex> lk(m_sleepMutex);
+        m_pendingJobs.fetch_add(1, std::memory_order_release);
+    }
+    m_sleepCV.notify_one();
+    return true;
+}
+
+void ChunkWorkerPool::Shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lk(m_sleepMutex);
+        if (m_exit.exchange(true)) return;
+    }
+    m_sleepCV.notify_all();
+
+    for (auto& worker : m_workers) {
+        if (worker->thread.joinable()) worker->thread.join();
+    }
+    Job discarded;
+    for (auto& worker : m_workers) {
+        while (worker->jobs.TryPop(discarded)) {}
+    }
+    m_pendingJobs.store(0, std::memory_order_relaxed);
+}
+
+bool ChunkWorkerPool::UpdateThroughput(float deltaTime)
+{
+    m_throughputTimer += deltaTime;
+    if (m_throughputTimer < THROUGHPUT_WINDOW) return false;
+
+    std::size_t completed = GetCompletedCount();
+    m_throughput = static_cast<float>(completed - m_throughputLastCompleted) / m_throughputTimer;
+    m_throughputLastCompleted = completed;
+    m_throughputTimer = 0.0f;
+    return true;
+}
+
+bool ChunkWorkerPool::PopLocal(unsigned int index, Job& job)
+{
+    return m_workers[index]->jobs.TryPop(job);
+}
+
+bool ChunkWorkerPool::Steal(unsigned int thiefIndex, Job& job)
+{
+    const unsigned int count = GetWorkerCount();
+    for (unsigned int offset = 1; offset < count; ++offset) {
+        // 窃取队头：提交顺序即优先级 (前方区块优先)，保持这个顺序
+        if (m_workers[(thiefIndex + offset) % count]->jobs.TryPop(job)) return true;
+    }
+    return false;
+}
+
+void ChunkWorkerPool::WorkerLoop(unsigned int index)
+{
+    LowerCurrentThreadPriority();
+    t_workerIndex = static_cast<int>(index);
+    PW_PROFILE_THREAD(("ChunkWorker " + std::to_string(index)).c_str());
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lk(m_sleepMutex);
+            m_sleepCV.wait(lk, [this] {
+                return m_exit.load(std::memory_order_relaxed) || m_pendingJobs.load(std::memory_order_acquire) > 0;
+            });
+            if (m_exit.load(std::memory_order_relaxed)) break;
+        }
+
+        Job job;
+        if (!PopLocal(index, job) && !Steal(index, job)) {
+            // 任务已被其他线程取走，让出时间片后重试
+            std::this_thread::yield();
+            continue;
+        }
+        m_pendingJobs.fetch_sub(1, std::memory_order_relaxed);
+
+        {
+            PW_PROFILE_ZONE("ChunkJob");
+            job();
+        }
+        m_completedJobs.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void ChunkWorkerPool::LowerCurrentThreadPriority()
+{
+#ifdef _WIN32
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+#elif defined(__linux__)
+    // Linux 上 nice 值按线程生效
+    setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 10);
+#elif defined(__APPLE__)
+    pthread_set_qos_class_self_np(QOS_CLASS_UTILITY, 0);
+#endif
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "LockFreeRing.h"
+
+/**
+ * @class ChunkWorkerPool
+ * @brief 区块生成线程池 (Work Stealing)
+ * @details
+ *   - 每个工作线程拥有自己的有界无锁任务环 (主线程写入，所属线程与窃取线程读取)，提交时轮流分发
+ *   - 自己的队列为空时，从其他线程的队列窃取任务
+ *   - 提交不等待工作线程：只在睡眠锁内发布待处理计数，空闲的工作线程无超时地等待唤醒
+ *   - 工作线程以较低优先级运行，渲染线程保持独占核心
+ *   - 统计已完成任务数，用于计算区块/秒吞吐量
+ */
+class ChunkWorkerPool {
+public:
+    using Job = std::function<void()>;
+
+    /**
+     * @param workerCount 工作线程数量，0 表示按硬件线程数自动选择
+     */
+    explicit ChunkWorkerPool(unsigned int workerCount = 0);
+    ~ChunkWorkerPool();
+
+    ChunkWorkerPool(const ChunkWorkerPool&) = delete;
+    ChunkWorkerPool& operator=(const ChunkWorkerPool&) = delete;
+
+    // 提交一个任务 (仅主线程调用)，所有任务环都已满时返回 false
+    bool Submit(Job job);
+
+    // 停止所有工作线程，丢弃尚未开始的任务
+    void Shutdown();
+
+    // 吞吐量统计：每帧在主线程调用，统计窗口结束时返回 true
+    bool UpdateThroughput(float deltaTime);
+
+    unsigned int GetWorkerCount() const { return static_cast<unsigned int>(m_workers.size()); }
+    float GetThroughput() const { return m_throughput; } // 任务/秒 (即区块/秒)
+    std::size_t GetCompletedCount() const { return m_completedJobs.load(std::memory_order_relaxed); }
+    std::size_t GetPendingCount() const { return m_pendingJobs.load(std::memory_order_relaxed); }
+
+    // 把 0 (自动) 解析为实际线程数：保留一个核心给渲染线程
+    static unsigned int ResolveWorkerCount(unsigned int requested);
+
+    // 当前线程在池中的下标，非工作线程返回 -1 (任务内可据此选择每线程的结果队列)
+    static int GetCurrentWorkerIndex();
+
+    static constexpr std::size_t JOB_RING_CAPACITY = 64; // 每个工作线程的任务环容量
+
+private:
+    struct Worker {
+        MpmcRing<Job> jobs{ JOB_RING_CAPACITY };
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::mutex m_sleepMutex;
+    std::condition_variable m_sleepCV;
+    std::atomic<std::size_t> m_pendingJobs{ 0 };
+    std::atomic<std::size_t> m_completedJobs{ 0 };
+    std::atomic<unsigned int> m_nextWorker{ 0 };
+    std::atomic<bool> m_exit{ false };
+
+    // 吞吐量统计 (仅主线程访问)
+    float m_throughputTimer = 0.0f;
+    std::size_t m_throughputLastCompleted = 0;
+    float m_throughput = 0.0f;
+
+    static constexpr float THROUGHPUT_WINDOW = 1.0f; // 统计窗口 (秒)
+
+    void WorkerLoop(unsigned int index);
+    bool PopLocal(unsigned int index, Job& job);
+    bool Steal(unsigned int thiefIndex, Job& job);
+    static void LowerCurrentThreadPriority();
+};
@@ -0,0 +1,177 @@
+#include "CollisionWorld.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#if defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define COLLISION_WORLD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+constexpr int SIZE = ChunkOccupancy::SIZE;
+
+// 向下取整的除法 (负坐标也落在正确的区块)
+int FloorDiv(int a, int b)
+{
+    int q = a / b;
+    return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+} // namespace
+
+CellRange CellRange::Overlapping(const glm::vec3& boxMin, const glm::vec3& boxMax)
+{
+#ifdef COLLISION_WORLD_SSE2
+    // 三个轴一起取整：先截断，再按截断值与原值的大小关系修正为 ceil/floor (世界坐标远小于 2^31，结果与 std::ceil/std::floor 相同)
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 lo = _mm_sub_ps(_mm_setr_ps(boxMin.x, boxMin.y, boxMin.z, 0.0f), half);
+    const __m128 hi = _mm_add_ps(_mm_setr_ps(boxMax.x, boxMax.y, boxMax.z, 0.0f), half);
+    __m128i lo32 = _mm_cvttps_epi32(lo);
+    __m128i hi32 = _mm_cvttps_epi32(hi);
+    lo32 = _mm_sub_epi32(lo32, _mm_castps_si128(_mm_cmplt_ps(_mm_cvtepi32_ps(lo32), lo))); // 截断值偏小时 +1
+    hi32 = _mm_add_epi32(hi32, _mm_castps_si128(_mm_cmpgt_ps(_mm_cvtepi32_ps(hi32), hi))); // 截断值偏大时 -1
+    alignas(16) int l[4];
+    alignas(16) int h[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(l), lo32);
+    _mm_store_si128(reinterpret_cast<__m128i*>(h), hi32);
+    return CellRange{ l[0], l[1], l[2], h[0], h[1], h[2] };
+#else
+    return CellRange{ static_cast<int>(std::ceil(boxMin.x - 0.5f)), static_cast<int>(std::ceil(boxMin.y - 0.5f)),
+                      static_cast<int>(std::ceil(boxMin.z - 0.5f)), static_cast<int>(std::floor(boxMax.x + 0.5f)),
+                      static_cast<int>(std::floor(boxMax.y + 0.5f)), static_cast<int>(std::floor(boxMax.z + 0.5f)) };
+#endif
+}
+
+ChunkOccupancy::ChunkOccupancy(int minY, int maxY)
+    : m_minY(minY), m_maxY(maxY)
+{
+    if (maxY >= minY) m_rows.assign(static_cast<std::size_t>(maxY - minY + 1) * SIZE, 0);
+}
+
+void ChunkOccupancy::Set(int lx, int y, int lz)
+{
+    if (y < m_minY || y > m_maxY) return;
+    m_rows[static_cast<std::size_t>(y - m_minY) * SIZE + lz] |= static_cast<std::uint16_t>(1u << lx);
+}
+
+void CollisionWorld::SetChunk(const ChunkKey& key, ChunkOccupancy occupancy)
+{
+    InvalidateLastChunk();
+    if (ChunkOccupancy* existing = m_chunks.Find(key)) {
+        *existing = std::move(occupancy);
+        return;
+    }
+    m_chunks.Insert(key, std::move(occupancy));
+}
+
+void CollisionWorld::RemoveChunk(const ChunkKey& key)
+{
+    InvalidateLastChunk();
+    m_chunks.Erase(key);
+}
+
+void CollisionWorld::Clear()
+{
+    InvalidateLastChunk();
+    m_chunks.Clear();
+}
+
+const ChunkOccupancy* CollisionWorld::FindChunk(int cx, int cz) const
+{
+    if (m_lastValid && m_lastKey.x == cx && m_lastKey.z == cz) return m_lastChunk;
+    m_lastKey = ChunkKey{ cx, cz };
+    m_lastChunk = m_chunks.Find(m_lastKey);
+    m_lastValid = true;
+    return m_lastChunk;
+}
+
+bool CollisionWorld::IsSolid(int x, int y, int z) const
+{
+    ChunkKey key{ FloorDiv(x, SIZE), FloorDiv(z, SIZE) };
+    const ChunkOccupancy* chunk = FindChunk(key.x, key.z);
+    return chunk && chunk->Test(x - key.x * SIZE, y, z - key.z * SIZE);
+}
+
+int CollisionWorld::QuerySolidCells(const glm::vec3& boxMin, const glm::vec3& boxMax, glm::vec3* out, int capacity) const
+{
+    return QuerySolidCells(CellRange::Overlapping(boxMin, boxMax), out, capacity);
+}
+
+int CollisionWorld::QuerySolidCells(const CellRange& cells, glm::vec3* out, int capacity) const
+{
+    if (cells.IsEmpty()) return 0;
+    const int x0 = cells.x0, x1 = cells.x1;
+    const int y0 = cells.y0, y1 = cells.y1;
+    const int z0 = cells.z0, z1 = cells.z1;
+
+    int count = 0;
+    // 查询盒可能跨越区块边界：逐个区块处理落在其中的部分
+    for (int cz = FloorDiv(z0, SIZE); cz <= FloorDiv(z1, SIZE); ++cz) {
+        for (int cx = FloorDiv(x0, SIZE); cx <= FloorDiv(x1, SIZE); ++cx) {
+            const ChunkOccupancy* chunk = FindChunk(cx, cz);
+            if (!chunk) continue;
+
+            const int lx0 = std::max(x0 - cx * SIZE, 0);
+            const int lx1 = std::min(x1 - cx * SIZE, SIZE - 1);
+            const int lz0 = std::max(z0 - cz * SIZE, 0);
+            const int lz1 = std::min(z1 - cz * SIZE, SIZE - 1);
+            const int ly0 = std::max(y0, chunk->GetMinY());
+            const int ly1 = std::min(y1, chunk->GetMaxY());
+            // 行内 [lx0, lx1] 的位掩码
+            const std::uint32_t mask = ((1u << (lx1 + 1)) - 1u) & ~((1u << lx0) - 1u);
+
+            for (int y = ly0; y <= ly1; ++y) {
+                const std::uint16_t* rows = chunk->Layer(y);
+                for (int lz = lz0; lz <= lz1; ++lz) {
+                    std::uint32_t bits = rows[lz] & mask;
+                    while (bits) {
+                        int lx = lx0; // 掩码外的低位都是 0，从 lx0 开始找最低的置位
+                        while (!((bits >> lx) & 1u)) ++lx;
+                        bits &= bits - 1u;
+                        if (count == capacity) return count;
+                        out[count++] = glm::vec3(static_cast<float>(cx * SIZE + lx), static_cast<float>(y),
+                                                 static_cast<float>(cz * SIZE + lz));
+                    }
+                }
+            }
+        }
+    }
+    return count;
+}
+
+int CollisionWorld::HighestSolid(const CellRange& cells) const
+{
+    int highest = cells.y0 - 1;
+    if (cells.IsEmpty()) return highest;
+    const int x0 = cells.x0, x1 = cells.x1;
+    const int y0 = cells.y0, y1 = cells.y1;
+    const int z0 = cells.z0, z1 = cells.z1;
+
+    for (int cz = FloorDiv(z0, SIZE); cz <= FloorDiv(z1, SIZE); ++cz) {
+        for (int cx = FloorDiv(x0, SIZE); cx <= FloorDiv(x1, SIZE); ++cx) {
+            const ChunkOccupancy* chunk = FindChunk(cx, cz);
+            if (!chunk) continue;
+
+            const int lx0 = std::max(x0 - cx * SIZE, 0);
+            const int lx1 = std::min(x1 - cx * SIZE, SIZE - 1);
+            const int lz0 = std::max(z0 - cz * SIZE, 0);
+            const int lz1 = std::min(z1 - cz * SIZE, SIZE - 1);
+            const int ly0 = std::max(std::max(y0, chunk->GetMinY()), highest + 1); // 其他区块已找到的更低层不必再查
+            const int ly1 = std::min(y1, chunk->GetMaxY());
+            const std::uint32_t mask = ((1u << (lx1 + 1)) - 1u) & ~((1u << lx0) - 1u);
+
+            for (int y = ly1; y >= ly0; --y) {
+                const std::uint16_t* rows = chunk->Layer(y);
+                std::uint32_t bits = 0;
+                for (int lz = lz0; lz <= lz1; ++lz) bits |= rows[lz];
+                if (bits & mask) {
+                    highest = y;
+                    break;
+                }
+            }
+        }
+    }
+    return highest;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "ChunkTable.h"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class ChunkOccupancy
+ * @brief 单个区块的体素占用位图
+ * @details
+ *   - 只覆盖区块内有方块的 y 范围，每层 SIZE 行 (lz)，每行一个 16 位字 (第 lx 位)
+ *   - 区块内的方块类型不影响碰撞：任何存储的方块 (含水面、树叶) 都是实心
+ */
+class ChunkOccupancy {
+public:
+    static constexpr int SIZE = 16;
+
+    ChunkOccupancy() = default;
+    ChunkOccupancy(int minY, int maxY); // maxY < minY 表示空区块
+
+    void Set(int lx, int y, int lz);
+    bool Test(int lx, int y, int lz) const { return (Row(y, lz) >> lx) & 1u; }
+
+    // 第 y 层、第 lz 行的位图，y 超出范围时为 0
+    std::uint16_t Row(int y, int lz) const {
+        if (y < m_minY || y > m_maxY) return 0;
+        return m_rows[static_cast<std::size_t>(y - m_minY) * SIZE + lz];
+    }
+    // 第 y 层的 SIZE 行位图，调用方保证 minY <= y <= maxY
+    const std::uint16_t* Layer(int y) const { return m_rows.data() + static_cast<std::size_t>(y - m_minY) * SIZE; }
+
+    int GetMinY() const { return m_minY; }
+    int GetMaxY() const { return m_maxY; }
+    std::size_t GetMemoryBytes() const { return m_rows.size() * sizeof(std::uint16_t); }
+
+private:
+    int m_minY = 0;
+    int m_maxY = -1;
+    std::vector<std::uint16_t> m_rows; // 下标 (y - minY) * SIZE + lz
+};
+
+/**
+ * @struct CellRange
+ * @brief 方块坐标范围 [x0, x1] x [y0, y1] x [z0, z1] (含端点)
+ */
+struct CellRange {
+    int x0, y0, z0;
+    int x1, y1, z1;
+
+    // 与 AABB [boxMin, boxMax] 重叠 (含接触) 的方块：方块 c 占据 [c - 0.5, c + 0.5]，即 ceil(min - 0.5) <= c <= floor(max + 0.5)
+    static CellRange Overlapping(const glm::vec3& boxMin, const glm::vec3& boxMax);
+
+    bool IsEmpty() const { return x0 > x1 || y0 > y1 || z0 > z1; }
+    bool Contains(const CellRange& other) const {
+        return other.x0 >= x0 && other.x1 <= x1 && other.y0 >= y0 && other.y1 <= y1 && other.z0 >= z0 && other.z1 <= z1;
+    }
+};
+
+/**
+ * @class CollisionWorld
+ * @brief 地形碰撞查询 (摄像机与敌人物理共用)
+ * @details
+ *   - 按区块保存占用位图，区块加载/卸载/编辑时增量更新，不再每隔几帧重建全部方块列表
+ *   - 查询与 AABB 重叠的实心方块时直接按坐标索引位图，代价只与查询盒大小有关，与视距和方块总数无关
+ *   - 列顶查询从上往下逐层合并几列的行位图，遇到第一个非零层即返回，不输出方块
+ *   - 记住最近一次查到的区块，连续查询同一区块时不再查散列表
+ *   - 方块以整数坐标为中心、边长 1 (与渲染一致)
+ *   - 仅主线程访问
+ */
+class CollisionWorld {
+public:
+    static constexpr int MAX_QUERY_CELLS = 128; // 单次查询最多返回的方块数 (物理查询盒约 4x6x4)
+
+    // 设置区块的占用位图 (已存在时替换)
+    void SetChunk(const ChunkKey& key, ChunkOccupancy occupancy);
+    void RemoveChunk(const ChunkKey& key);
+    void Clear();
+
+    std::size_t GetChunkCount() const { return m_chunks.Size(); }
+    bool IsSolid(int x, int y, int z) const;
+
+    /**
+     * @brief 查询与 AABB [boxMin, boxMax] 重叠 (含接触) 的实心方块
+     * @param out 写入方块中心坐标，最多 capacity 个
+     * @return 写入的方块数
+     */
+    int QuerySolidCells(const glm::vec3& boxMin, const glm::vec3& boxMax, glm::vec3* out, int capacity) const;
+    // 同上，范围已由 CellRange::Overlapping 换算好 (调用方需要复用取整结果时)
+    int QuerySolidCells(const CellRange& cells, glm::vec3* out, int capacity) const;
+
+    /**
+     * @brief 范围内最高的实心方块 (几列同时查列顶)
+     * @return 方块的 y，范围内没有实心方块时返回 cells.y0 - 1
+     */
+    int HighestSolid(const CellRange& cells) const;
+
+private:
+    ChunkTable<ChunkOccupancy> m_chunks;
+
+    // 最近一次查到的区块：相邻查询 (同一批敌人) 大多落在同一区块，命中时省去散列查找。
+    // 表的插入/删除会移动元素，SetChunk/RemoveChunk/Clear 时作废
+    mutable ChunkKey m_lastKey{ 0, 0 };
+    mutable const ChunkOccupancy* m_lastChunk = nullptr;
+    mutable bool m_lastValid = false;
+
+    const ChunkOccupancy* FindChunk(int cx, int cz) const;
+    void InvalidateLastChunk() { m_lastValid = false; }
+};
@@ -2,64 +2,72 @@
 
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
-#include <vector>
+#include <cstdint>
 
-enum class EnemyState {
-    Inactive,    // 在对象池中
+class EnemyPool;
+
+enum class EnemyState : std::uint8_t {
+    Inactive,    // 在对象池中 (失效句柄也报告此状态)
     Active,      // 存活
     Dying,       // 死亡动画播放中
     Dead         // 尸体残留
 };
 
+/**
+ * @class Enemy
+ * @brief 敌人句柄 (对象池槽位 + 代数)
+ * @details
+ *   - 敌人数据以 SoA 形式保存在 EnemyPool 的连续数组中 (位置、速度、生命、状态、计时、朝向)，
+ *     这里只保存所属对象池、槽位与代数，可按值复制
+ *   - 槽位被释放时代数加一，旧句柄随之失效：IsValid 为 false，GetState 返回 Inactive，
+ *     TakeDamage/Kill/Release 不产生效果；其余 Getter 只对有效句柄调用
+ */
 class Enemy {
 public:
-    Enemy();
-    
-    // 初始化敌人
-    void Activate(const glm::vec3& position);
-    
-    // 更新逻辑
-    void Update(float deltaTime, const glm::vec3& playerPos, const std::vector<Enemy*>& activeEnemies, const std::vector<glm::vec3>& terrainBlocks);
-    
+    static constexpr float SEPARATION_RADIUS = 1.5f;
+    static constexpr float SPEED = 2.5f;
+    static constexpr float MAX_HEALTH = 100.0f;
+    static constexpr float WIDTH = 0.8f;
+    static constexpr float HEIGHT = 1.8f;
+    static constexpr float DEATH_ANIM_DURATION = 0.5f; // 倒地动画
+    static constexpr float DEATH_DURATION = 2.0f;      // 尸体残留时间
+
+    Enemy() = default;
+    Enemy(EnemyPool* pool, std::uint32_t slot, std::uint32_t generation) : m_pool(pool), m_slot(slot), m_generation(generation) {}
+
+    bool IsValid() const;
+    std::uint32_t GetSlot() const { return m_slot; }
+    std::uint32_t GetGeneration() const { return m_generation; }
+    bool operator==(const Enemy& other) const {
+        return m_pool == other.m_pool && m_slot == other.m_slot && m_generation == other.m_generation;
+    }
+    bool operator!=(const Enemy& other) const { return !(*this == other); }
+
     // 受到伤害，返回是否被击杀
     bool TakeDamage(float damage);
-    
+
     // 立即杀死 (用于测试或清理)
     void Kill();
-    void DeactivateForPool();
-    
+
     // Getters
-    EnemyState GetState() const { return m_state; }
-    glm::vec3 GetPosition() const { return m_position; }
-    glm::vec3 GetColor() const { return m_color; }
-    glm::vec3 GetScale() const { return m_scale; }
-    glm::quat GetRotation() const { return m_rotation; }
-    bool IsActive() const { return m_state == EnemyState::Active; }
+    EnemyState GetState() const;
+    glm::vec3 GetPosition() const;
+    glm::vec3 GetColor() const;
+    glm::vec3 GetScale() const { return glm::vec3(WIDTH, HEIGHT, WIDTH); }
+    glm::quat GetRotation() const;
+    bool IsActive() const { return GetState() == EnemyState::Active; }
     bool CanBeRecycled() const;
-    float GetHealth() const { return m_health; }
+    float GetHealth() const;
 
     // AABB 获取
     void getAABB(glm::vec3& min, glm::vec3& max) const;
 
 private:
-    EnemyState m_state;
-    
-    glm::vec3 m_position;
-    glm::vec3 m_velocity;
-    glm::quat m_rotation; // 使用四元数处理旋转 (特别是倒地动画)
-    
-    // 渲染属性
-    glm::vec3 m_color;
-    glm::vec3 m_scale;
-    
-    // 游戏属性
-    float m_speed;
-    float m_health;
-    
-    // 死亡处理
-    float m_deathTimer;
-    float m_deathDuration; // 尸体残留时间
+    friend class EnemyPool;
+
+    EnemyPool* m_pool = nullptr;
+    std::uint32_t m_slot = 0;
+    std::uint32_t m_generation = 0;
 
-    // 内部逻辑
-    glm::vec3 CalculateSeparation(const std::vector<Enemy*>& activeEnemies);
+    std::uint32_t Dense() const; // 在对象池 SoA 数组中的下标
 };
@@ -1,80 +1,550 @@
 #include "EnemyPool.h"
+#include "Profiler.h"
 #include <algorithm>
+#include <cmath>
+#include <cstring>
 
-EnemyPool::EnemyPool(size_t initialCapacity) {
-    ExpandCapacity(initialCapacity);
+#if defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define ENEMY_POOL_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+constexpr float GRAVITY = 25.0f;
+constexpr float MAX_FALL_SPEED = 20.0f;
+constexpr float SEEK_MIN_DISTANCE = 0.1f; // 与玩家水平距离小于此值时不再追踪/转向
+constexpr float GROUND_EPSILON = 1e-3f;   // 判断落地敌人脚底下沉量时的浮点容差
+constexpr std::size_t AUTO_GROW_MIN = 50;   // 未预热时 Acquire 的最小扩容量
+constexpr int MAX_SEPARATION_NEIGHBOURS = 16; // 每个敌人分离力最多统计的邻居数
+constexpr float SEPARATION_WEIGHT = 1.5f;     // 分离力相对追踪方向的权重
+constexpr float NORMALIZE_MIN_LENGTH = 0.1f;  // 合成移动方向短于此值时不归一化
+
+// slab 内每列按缓存行对齐
+std::size_t LinesFor(std::size_t bytes)
+{
+    return (bytes + 63) / 64;
 }
 
-EnemyPool::~EnemyPool() {
-    for (auto enemy : m_allEnemies) {
-        delete enemy;
+// 简单的 AABB 碰撞检测结构体
+struct AABB {
+    glm::vec3 min;
+    glm::vec3 max;
+};
+// 检查两个 AABB 是否重叠
+bool CheckCollision(const AABB& one, const AABB& two) {
+    bool collisionX = one.max.x >= two.min.x && two.max.x >= one.min.x;
+    bool collisionY = one.max.y >= two.min.y && two.max.y >= one.min.y;
+    bool collisionZ = one.max.z >= two.min.z && two.max.z >= one.min.z;
+    return collisionX && collisionY && collisionZ;
+}
+
+#ifdef ENEMY_POOL_SSE2
+// _mm_movemask_ps 结果中置位的通道数
+constexpr int LANE_COUNT[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+#endif
+
+// 分离力：3x3 格内距离小于分离半径的存活敌人，自身位置距离为 0，被距离下限排除。
+// 推力为 normalize(d) / |d| = d / |d|^2，全程只用距离平方，不开方。
+// near 为网格按行给出的连续下标区间，SSE2 一次比较 4 个点；计满 MAX_SEPARATION_NEIGHBOURS 个邻居后不再扫描，
+// 密集人群中每个敌人的代价有上限 (只取先扫到的邻居求平均，方向仍由附近的人群决定)
+glm::vec3 CalculateSeparation(const UniformGrid& neighbours, const UniformGrid::Range* near, int nearCount, const glm::vec3& position)
+{
+    constexpr float MIN_DIST_SQ = 0.001f * 0.001f;
+    constexpr float MAX_DIST_SQ = Enemy::SEPARATION_RADIUS * Enemy::SEPARATION_RADIUS;
+    const float* xs = neighbours.GetSortedX();
+    const float* ys = neighbours.GetSortedY();
+    const float* zs = neighbours.GetSortedZ();
+    float separationX = 0.0f;
+    float separationZ = 0.0f;
+    int neighbors = 0;
+
+#ifdef ENEMY_POOL_SSE2
+    const __m128 px4 = _mm_set1_ps(position.x);
+    const __m128 py4 = _mm_set1_ps(position.y);
+    const __m128 pz4 = _mm_set1_ps(position.z);
+    const __m128 minDistSq4 = _mm_set1_ps(MIN_DIST_SQ);
+    const __m128 maxDistSq4 = _mm_set1_ps(MAX_DIST_SQ);
+    const __m128 one4 = _mm_set1_ps(1.0f);
+    const __m128i lane4 = _mm_setr_epi32(0, 1, 2, 3);
+    __m128 sumX4 = _mm_setzero_ps();
+    __m128 sumZ4 = _mm_setzero_ps();
+#endif
+
+    for (int r = 0; r < nearCount && neighbors < MAX_SEPARATION_NEIGHBOURS; ++r) {
+        const std::uint32_t end = near[r].end;
+#ifdef ENEMY_POOL_SSE2
+        // 区间末尾不足 4 个时照常读入 (网格数组有填充)，超出区间的通道用下标掩码排除，不走标量尾循环
+        const __m128i end4 = _mm_set1_epi32(static_cast<int>(end));
+        for (std::uint32_t i = near[r].begin; i < end && neighbors < MAX_SEPARATION_NEIGHBOURS; i += 4) {
+            __m128 dx = _mm_sub_ps(px4, _mm_loadu_ps(xs + i));
+            __m128 dy = _mm_sub_ps(py4, _mm_loadu_ps(ys + i));
+            __m128 dz = _mm_sub_ps(pz4, _mm_loadu_ps(zs + i));
+            __m128 distSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+            __m128 inRange = _mm_and_ps(_mm_cmpgt_ps(distSq, minDistSq4), _mm_cmplt_ps(distSq, maxDistSq4));
+            inRange = _mm_and_ps(inRange, _mm_castsi128_ps(_mm_cmplt_epi32(_mm_add_epi32(_mm_set1_epi32(static_cast<int>(i)), lane4), end4)));
+            // 范围外的通道 (含自身的 0 距离) 整体清零，1/0 产生的 inf/NaN 不会进入累加
+            __m128 inv = _mm_and_ps(inRange, _mm_div_ps(one4, _mm_max_ps(distSq, minDistSq4)));
+            sumX4 = _mm_add_ps(sumX4, _mm_mul_ps(dx, inv));
+            sumZ4 = _mm_add_ps(sumZ4, _mm_mul_ps(dz, inv));
+            neighbors += LANE_COUNT[_mm_movemask_ps(inRange)];
+        }
+#else
+        for (std::uint32_t i = near[r].begin; i < end && neighbors < MAX_SEPARATION_NEIGHBOURS; ++i) {
+            const float dx = position.x - xs[i];
+            const float dy = position.y - ys[i];
+            const float dz = position.z - zs[i];
+            const float distSq = dx * dx + dy * dy + dz * dz;
+            if (distSq > MIN_DIST_SQ && distSq < MAX_DIST_SQ) {
+                const float inv = 1.0f / distSq;
+                separationX += dx * inv;
+                separationZ += dz * inv;
+                neighbors++;
+            }
+        }
+#endif
     }
-    m_allEnemies.clear();
+
+#ifdef ENEMY_POOL_SSE2
+    alignas(16) float sumX[4];
+    alignas(16) float sumZ[4];
+    _mm_store_ps(sumX, sumX4);
+    _mm_store_ps(sumZ, sumZ4);
+    separationX = (sumX[0] + sumX[1]) + (sumX[2] + sumX[3]);
+    separationZ = (sumZ[0] + sumZ[1]) + (sumZ[2] + sumZ[3]);
+#endif
+
+    glm::vec3 separation(separationX, 0.0f, separationZ);
+    if (neighbors > 0) separation /= static_cast<float>(neighbors);
+    return separation;
+}
+
+// atan2 的多项式近似 (最大误差约 2e-4 弧度，约 0.01 度，只用于朝向)，SIMD 与标量版本公式相同，结果与敌人在数组中的位置无关
+constexpr float ATAN_C1 = -0.0464964749f;
+constexpr float ATAN_C2 = 0.15931422f;
+constexpr float ATAN_C3 = -0.327622764f;
+constexpr float HALF_PI = 1.57079632679f;
+constexpr float PI = 3.14159265359f;
+
+float FastAtan2(float y, float x)
+{
+    const float ax = std::fabs(x);
+    const float ay = std::fabs(y);
+    const float a = std::min(ax, ay) / std::max(std::max(ax, ay), 1e-30f);
+    const float s = a * a;
+    float r = ((ATAN_C1 * s + ATAN_C2) * s + ATAN_C3) * s * a + a;
+    if (ay > ax) r = HALF_PI - r;
+    if (x < 0.0f) r = PI - r;
+    return std::copysign(r, y);
+}
+
+#ifdef ENEMY_POOL_SSE2
+__m128 Select(__m128 mask, __m128 a, __m128 b)
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+__m128 FastAtan2(__m128 y, __m128 x)
+{
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 ax = _mm_andnot_ps(signMask, x);
+    const __m128 ay = _mm_andnot_ps(signMask, y);
+    const __m128 a = _mm_div_ps(_mm_min_ps(ax, ay), _mm_max_ps(_mm_max_ps(ax, ay), _mm_set1_ps(1e-30f)));
+    const __m128 s = _mm_mul_ps(a, a);
+    __m128 r = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(ATAN_C1), s), _mm_set1_ps(ATAN_C2));
+    r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(ATAN_C3));
+    r = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(r, s), a), a);
+    r = Select(_mm_cmpgt_ps(ay, ax), _mm_sub_ps(_mm_set1_ps(HALF_PI), r), r);
+    r = Select(_mm_cmplt_ps(x, _mm_setzero_ps()), _mm_sub_ps(_mm_set1_ps(PI), r), r);
+    return _mm_or_ps(r, _mm_and_ps(signMask, y));
+}
+#endif
+
+} // namespace
+
+EnemyPool::EnemyPool(size_t initialCapacity) {
+    ExpandCapacity(initialCapacity);
 }
 
-Enemy* EnemyPool::Acquire(const glm::vec3& position) {
-    if (m_inactivePool.empty()) {
-        ExpandCapacity(50);  // 自动扩容
+Enemy EnemyPool::Acquire(const glm::vec3& position) {
+    if (m_freeSlots.empty()) {
+        // 未预热：同步扩容 (容量翻倍，至少 AUTO_GROW_MIN)
+        ExpandCapacity(std::max(m_capacity, AUTO_GROW_MIN));
     }
-    
-    Enemy* enemy = m_inactivePool.front();
-    m_inactivePool.pop();
-    
-    enemy->Activate(position);
+
+    std::uint32_t slot = m_freeSlots.back();
+    m_freeSlots.pop_back();
+
+    // 追加到 SoA 数组末尾
+    const std::size_t i = m_count++;
+    m_slots[slot].dense = static_cast<std::uint32_t>(i);
+    m_posX[i] = position.x;
+    m_posY[i] = position.y;
+    m_posZ[i] = position.z;
+    m_velX[i] = m_velY[i] = m_velZ[i] = 0.0f;
+    m_health[i] = Enemy::MAX_HEALTH;
+    m_timer[i] = 0.0f;
+    m_yaw[i] = 0.0f;
+    m_tilt[i] = 0.0f;
+    m_state[i] = EnemyState::Active;
+
+    Enemy enemy(this, slot, m_slots[slot].generation);
     m_activeEnemies.push_back(enemy);
-    
     return enemy;
 }
 
-void EnemyPool::Release(Enemy* enemy) {
-    if (!enemy) return;
-    
-    // 从活跃列表中移除
-    auto it = std::find(m_activeEnemies.begin(), m_activeEnemies.end(), enemy);
-    if (it != m_activeEnemies.end()) {
-        m_activeEnemies.erase(it);
+void EnemyPool::Release(Enemy enemy) {
+    if (!IsAlive(enemy)) return;
+    RemoveAt(m_slots[enemy.GetSlot()].dense);
+}
+
+bool EnemyPool::IsAlive(const Enemy& enemy) const {
+    return enemy.m_pool == this && enemy.m_slot < m_slots.size() && m_slots[enemy.m_slot].generation == enemy.m_generation;
+}
+
+void EnemyPool::RemoveAt(std::size_t dense) {
+    // swap-and-pop：末尾敌人搬入空位，只改写它的槽位记录
+    const std::size_t last = m_count - 1;
+    const std::uint32_t slot = m_activeEnemies[dense].GetSlot();
+    if (dense != last) {
+        for (float** column : FloatColumns()) {
+            (*column)[dense] = (*column)[last];
+        }
+        m_state[dense] = m_state[last];
+        m_activeEnemies[dense] = m_activeEnemies[last];
+        m_slots[m_activeEnemies[dense].GetSlot()].dense = static_cast<std::uint32_t>(dense);
     }
-    
-    enemy->DeactivateForPool();
-    m_inactivePool.push(enemy);
+    m_count--;
+    m_activeEnemies.pop_back();
+
+    m_slots[slot].generation++; // 旧句柄失效
+    m_freeSlots.push_back(slot);
 }
 
-void EnemyPool::UpdateAll(float deltaTime, const glm::vec3& playerPos, const std::vector<glm::vec3>& terrainBlocks) {
-    // 1. 更新所有活跃敌人
-    for (auto enemy : m_activeEnemies) {
-        enemy->Update(deltaTime, playerPos, m_activeEnemies, terrainBlocks);
+void EnemyPool::UpdateAll(float deltaTime, const glm::vec3& playerPos, const CollisionWorld& collision) {
+    PW_PROFILE_ZONE("EnemyPool::UpdateAll");
+    // 1. 重建分离力的邻居网格 (只含存活敌人，位置取本帧更新前的快照，结果与更新顺序无关)
+    m_separationPoints.clear();
+    m_separationOwner.clear();
+    for (std::size_t i = 0; i < m_count; ++i) {
+        if (m_state[i] == EnemyState::Active) {
+            m_separationPoints.emplace_back(m_posX[i], m_posY[i], m_posZ[i]);
+            m_separationOwner.push_back(static_cast<std::uint32_t>(i));
+        }
     }
-    
-    // 2. 回收完全死亡（尸体消失）的敌人
+    m_separationGrid.Build(m_separationPoints);
+
+    // 2. 按阶段更新全部活跃敌人
+    ApplyGravity(deltaTime);
+    ComputeSeek(playerPos);
+    ApplySteering();
+    Integrate(deltaTime);
+    ResolveTerrain(collision, deltaTime);
+    AdvanceStates(deltaTime);
+
+    // 3. 回收完全死亡（尸体消失）的敌人
     RecycleDeadEnemies();
 }
 
-const std::vector<Enemy*>& EnemyPool::GetActiveEnemies() const {
+const std::vector<Enemy>& EnemyPool::GetActiveEnemies() const {
     return m_activeEnemies;
 }
 
+std::array<float**, EnemyPool::FLOAT_COLUMN_COUNT> EnemyPool::FloatColumns() {
+    return { &m_posX, &m_posY, &m_posZ, &m_velX, &m_velY, &m_velZ, &m_health, &m_timer, &m_yaw, &m_tilt };
+}
+
+void EnemyPool::Reserve(size_t capacity) {
+    if (capacity > m_capacity) ExpandCapacity(capacity - m_capacity);
+}
+
 void EnemyPool::ExpandCapacity(size_t additionalCount) {
-    for (size_t i = 0; i < additionalCount; ++i) {
-        Enemy* enemy = new Enemy();
-        m_allEnemies.push_back(enemy);
-        m_inactivePool.push(enemy);
+    if (additionalCount == 0) return;
+    const std::size_t oldCapacity = m_capacity;
+    const std::size_t newCapacity = oldCapacity + additionalCount;
+
+    // 新 slab：FLOAT_COLUMN_COUNT 个 float 列 + 状态列，各自从缓存行边界开始
+    const std::size_t floatLines = LinesFor(newCapacity * sizeof(float));
+    const std::size_t stateLines = LinesFor(newCapacity * sizeof(EnemyState));
+    std::unique_ptr<SlabLine[]> slab(new SlabLine[floatLines * FLOAT_COLUMN_COUNT + stateLines]);
+    m_allocationCount++;
+
+    // 搬移活跃敌人的数据，列指针改指新 slab
+    SlabLine* line = slab.get();
+    for (float** column : FloatColumns()) {
+        float* moved = reinterpret_cast<float*>(line);
+        if (m_count > 0) std::memcpy(moved, *column, m_count * sizeof(float));
+        *column = moved;
+        line += floatLines;
+    }
+    EnemyState* state = reinterpret_cast<EnemyState*>(line);
+    if (m_count > 0) std::memcpy(state, m_state, m_count * sizeof(EnemyState));
+    m_state = state;
+    m_slab = std::move(slab);
+    m_capacity = newCapacity;
+
+    // 句柄、槽位与分离网格的缓冲按新容量一并预留，容量内不再分配
+    m_activeEnemies.reserve(newCapacity);
+    m_freeSlots.reserve(newCapacity);
+    m_separationPoints.reserve(newCapacity);
+    m_separationOwner.reserve(newCapacity);
+    m_separationX.resize(newCapacity);
+    m_separationZ.resize(newCapacity);
+    m_separationGrid.Reserve(newCapacity);
+    m_slots.resize(newCapacity);
+
+    // 倒序压栈，低槽位先被取出
+    for (std::size_t slot = newCapacity; slot > oldCapacity; --slot) {
+        m_freeSlots.push_back(static_cast<std::uint32_t>(slot - 1));
     }
 }
 
-void EnemyPool::RecycleDeadEnemies() {
-    auto it = m_activeEnemies.begin();
-    while (it != m_activeEnemies.end()) {
-        if ((*it)->CanBeRecycled()) {
-            // 注意：这里我们不能直接调用 Release，因为这会导致迭代器失效问题
-            // 所以我们手动做 Release 的逻辑
-            Enemy* enemy = *it;
-            enemy->DeactivateForPool();
-            m_inactivePool.push(enemy);
-            
-            // 使用 erase 返回下一个迭代器
-            it = m_activeEnemies.erase(it);
-        } else {
-            ++it;
+void EnemyPool::ApplyGravity(float deltaTime) {
+    // 所有状态 (存活、倒地、尸体) 都受重力影响
+    float* velY = m_velY;
+    const std::size_t n = m_count;
+    const float dv = GRAVITY * deltaTime;
+    std::size_t i = 0;
+#ifdef ENEMY_POOL_SSE2
+    const __m128 dv4 = _mm_set1_ps(dv);
+    const __m128 minVel4 = _mm_set1_ps(-MAX_FALL_SPEED);
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(velY + i, _mm_max_ps(_mm_sub_ps(_mm_loadu_ps(velY + i), dv4), minVel4));
+    }
+#endif
+    for (; i < n; ++i) velY[i] = std::max(velY[i] - dv, -MAX_FALL_SPEED);
+}
+
+void EnemyPool::ComputeSeek(const glm::vec3& playerPos) {
+    // 水平方向指向玩家的单位向量，暂存在 velX/velZ 中，由 ApplySteering 换算为速度
+    const float* posX = m_posX;
+    const float* posZ = m_posZ;
+    float* seekX = m_velX;
+    float* seekZ = m_velZ;
+    const std::size_t n = m_count;
+    std::size_t i = 0;
+#ifdef ENEMY_POOL_SSE2
+    const __m128 px4 = _mm_set1_ps(playerPos.x);
+    const __m128 pz4 = _mm_set1_ps(playerPos.z);
+    const __m128 minDist4 = _mm_set1_ps(SEEK_MIN_DISTANCE);
+    const __m128 one4 = _mm_set1_ps(1.0f);
+    for (; i + 4 <= n; i += 4) {
+        __m128 dx = _mm_sub_ps(px4, _mm_loadu_ps(posX + i));
+        __m128 dz = _mm_sub_ps(pz4, _mm_loadu_ps(posZ + i));
+        __m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dz, dz)));
+        __m128 far = _mm_cmpgt_ps(len, minDist4);
+        __m128 inv = _mm_and_ps(far, _mm_div_ps(one4, _mm_max_ps(len, minDist4)));
+        _mm_storeu_ps(seekX + i, _mm_mul_ps(dx, inv));
+        _mm_storeu_ps(seekZ + i, _mm_mul_ps(dz, inv));
+    }
+#endif
+    for (; i < n; ++i) {
+        float dx = playerPos.x - posX[i];
+        float dz = playerPos.z - posZ[i];
+        float len = std::sqrt(dx * dx + dz * dz);
+        float inv = len > SEEK_MIN_DISTANCE ? 1.0f / len : 0.0f;
+        seekX[i] = dx * inv;
+        seekZ[i] = dz * inv;
+    }
+}
+
+void EnemyPool::ApplySteering() {
+    // 1. 分离力：按格子顺序逐个存活敌人求 (同格敌人共用邻居区间)，按密集下标暂存
+    const float* sortedX = m_separationGrid.GetSortedX();
+    const float* sortedY = m_separationGrid.GetSortedY();
+    const float* sortedZ = m_separationGrid.GetSortedZ();
+    const std::uint32_t* sortedIndex = m_separationGrid.GetSortedIndex();
+    m_separationGrid.ForEachCell([&](const UniformGrid::Range& cell, const UniformGrid::Range* near, int nearCount) {
+        for (std::uint32_t p = cell.begin; p < cell.end; ++p) {
+            const glm::vec3 separation = CalculateSeparation(m_separationGrid, near, nearCount, glm::vec3(sortedX[p], sortedY[p], sortedZ[p]));
+            const std::uint32_t i = m_separationOwner[sortedIndex[p]];
+            m_separationX[i] = separation.x;
+            m_separationZ[i] = separation.z;
+        }
+    });
+
+    // 2. 存活敌人：面朝玩家，追踪 + 分离合成移动方向 (长度大于 0.1 时归一化)；其余状态水平速度为 0
+    const std::size_t n = m_count;
+    std::size_t i = 0;
+#ifdef ENEMY_POOL_SSE2
+    const __m128i active4 = _mm_set1_epi32(static_cast<int>(EnemyState::Active));
+    const __m128 zero4 = _mm_setzero_ps();
+    const __m128 weight4 = _mm_set1_ps(SEPARATION_WEIGHT);
+    const __m128 minLength4 = _mm_set1_ps(NORMALIZE_MIN_LENGTH);
+    const __m128 speed4 = _mm_set1_ps(Enemy::SPEED);
+    for (; i + 4 <= n; i += 4) {
+        const __m128 active = _mm_castsi128_ps(_mm_cmpeq_epi32(
+            _mm_setr_epi32(static_cast<int>(m_state[i]), static_cast<int>(m_state[i + 1]),
+                           static_cast<int>(m_state[i + 2]), static_cast<int>(m_state[i + 3])), active4));
+        const __m128 seekX = _mm_loadu_ps(m_velX + i);
+        const __m128 seekZ = _mm_loadu_ps(m_velZ + i);
+        const __m128 facing = _mm_and_ps(active, _mm_or_ps(_mm_cmpneq_ps(seekX, zero4), _mm_cmpneq_ps(seekZ, zero4)));
+        if (_mm_movemask_ps(facing)) {
+            _mm_storeu_ps(m_yaw + i, Select(facing, FastAtan2(seekX, seekZ), _mm_loadu_ps(m_yaw + i)));
+        }
+
+        const __m128 moveX = _mm_add_ps(seekX, _mm_mul_ps(_mm_loadu_ps(m_separationX.data() + i), weight4));
+        const __m128 moveZ = _mm_add_ps(seekZ, _mm_mul_ps(_mm_loadu_ps(m_separationZ.data() + i), weight4));
+        const __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(moveX, moveX), _mm_mul_ps(moveZ, moveZ)));
+        const __m128 scale = Select(_mm_cmpgt_ps(length, minLength4), _mm_div_ps(speed4, _mm_max_ps(length, minLength4)), speed4);
+        _mm_storeu_ps(m_velX + i, _mm_and_ps(active, _mm_mul_ps(moveX, scale)));
+        _mm_storeu_ps(m_velZ + i, _mm_and_ps(active, _mm_mul_ps(moveZ, scale)));
+    }
+#endif
+    for (; i < n; ++i) {
+        if (m_state[i] != EnemyState::Active) {
+            m_velX[i] = m_velZ[i] = 0.0f;
+            continue;
+        }
+        const float seekX = m_velX[i];
+        const float seekZ = m_velZ[i];
+        if (seekX != 0.0f || seekZ != 0.0f) m_yaw[i] = FastAtan2(seekX, seekZ);
+
+        const float moveX = seekX + m_separationX[i] * SEPARATION_WEIGHT;
+        const float moveZ = seekZ + m_separationZ[i] * SEPARATION_WEIGHT;
+        const float length = std::sqrt(moveX * moveX + moveZ * moveZ);
+        const float scale = length > NORMALIZE_MIN_LENGTH ? Enemy::SPEED / length : Enemy::SPEED;
+        m_velX[i] = moveX * scale;
+        m_velZ[i] = moveZ * scale;
+    }
+}
+
+void EnemyPool::Integrate(float deltaTime) {
+    // 位置 += 速度 * dt (碰撞前先移动)
+    const std::size_t n = m_count;
+    float* positions[3] = { m_posX, m_posY, m_posZ };
+    const float* velocities[3] = { m_velX, m_velY, m_velZ };
+    for (int axis = 0; axis < 3; ++axis) {
+        float* pos = positions[axis];
+        const float* vel = velocities[axis];
+        std::size_t i = 0;
+#ifdef ENEMY_POOL_SSE2
+        const __m128 dt4 = _mm_set1_ps(deltaTime);
+        for (; i + 4 <= n; i += 4) {
+            _mm_storeu_ps(pos + i, _mm_add_ps(_mm_loadu_ps(pos + i), _mm_mul_ps(_mm_loadu_ps(vel + i), dt4)));
+        }
+#endif
+        for (; i < n; ++i) pos[i] += vel[i] * deltaTime;
+    }
+}
+
+void EnemyPool::ResolveTerrain(const CollisionWorld& collision, float deltaTime) {
+    const glm::vec3 halfSize = glm::vec3(Enemy::WIDTH, Enemy::HEIGHT, Enemy::WIDTH) * 0.5f;
+    // 上一帧落地 (下落速度清零) 的敌人，本帧 ApplyGravity 后的下落速度
+    const float groundedVelY = std::max(0.0f - GRAVITY * deltaTime, -MAX_FALL_SPEED);
+    glm::vec3 nearbyCells[CollisionWorld::MAX_QUERY_CELLS];
+
+    for (std::size_t i = 0; i < m_count; ++i) {
+        glm::vec3 nextPos(m_posX[i], m_posY[i], m_posZ[i]);
+        float& velY = m_velY[i];
+        const glm::vec3 prevPos = nextPos - glm::vec3(m_velX[i], velY, m_velZ[i]) * deltaTime;
+
+        // 快速路径：上一帧落地的敌人 (行走中或原地不动) 本帧只下沉了一帧的重力位移。若脚底陷入某层方块顶面不超过这段位移，
+        // 查身体覆盖的几列从头顶到该层的列顶；列顶恰好是该层 (身体范围内没有其他方块) 时，碰撞结果就是贴回地面，不必取出方块逐个求解
+        const float footY = nextPos.y - halfSize.y;
+        const int ground = static_cast<int>(std::floor(footY)); // 离脚底最近的方块顶面 (k + 0.5) 所在层 k
+        const float groundTop = static_cast<float>(ground) + 0.5f;
+        if (velY == groundedVelY && footY <= groundTop && groundTop - footY <= -velY * deltaTime + GROUND_EPSILON) {
+            CellRange body = CellRange::Overlapping(nextPos - halfSize, nextPos + halfSize);
+            body.y0 = ground;
+            const int top = collision.HighestSolid(body);
+            if (top == ground) {
+                m_posX[i] = nextPos.x;
+                m_posY[i] = groundTop + halfSize.y;
+                m_posZ[i] = nextPos.z;
+                velY = 0.0f;
+                continue;
+            }
+        }
+
+        // 一般情况：只取本帧移动扫过的包围盒 (移动前后两个包围盒的并集) 内的方块
+        AABB queryBox;
+        queryBox.min = glm::min(prevPos, nextPos) - halfSize;
+        queryBox.max = glm::max(prevPos, nextPos) + halfSize;
+        CellRange queried = CellRange::Overlapping(queryBox.min, queryBox.max);
+        int nearbyCount = collision.QuerySolidCells(queried, nearbyCells, CollisionWorld::MAX_QUERY_CELLS);
+
+        // 迭代解决碰撞
+        int iterations = 4;
+        while (iterations--) {
+            bool collided = false;
+            const glm::vec3 iterationStart = nextPos;
+            AABB enemyBox;
+            enemyBox.min = nextPos - halfSize;
+            enemyBox.max = nextPos + halfSize;
+
+            // 被推到查询过的方块范围之外 (出生在树里、被方块卡住等)：扩大查询盒补查
+            if (!queried.Contains(CellRange::Overlapping(enemyBox.min, enemyBox.max))) {
+                queryBox.min = glm::min(queryBox.min, enemyBox.min);
+                queryBox.max = glm::max(queryBox.max, enemyBox.max);
+                queried = CellRange::Overlapping(queryBox.min, queryBox.max);
+                nearbyCount = collision.QuerySolidCells(queried, nearbyCells, CollisionWorld::MAX_QUERY_CELLS);
+            }
+
+            for (int c = 0; c < nearbyCount; ++c) {
+                AABB blockBox;
+                blockBox.min = nearbyCells[c] - glm::vec3(0.5f);
+                blockBox.max = nearbyCells[c] + glm::vec3(0.5f);
+                if (CheckCollision(enemyBox, blockBox)) {
+                    float overlapX = std::min(enemyBox.max.x, blockBox.max.x) - std::max(enemyBox.min.x, blockBox.min.x);
+                    float overlapY = std::min(enemyBox.max.y, blockBox.max.y) - std::max(enemyBox.min.y, blockBox.min.y);
+                    float overlapZ = std::min(enemyBox.max.z, blockBox.max.z) - std::max(enemyBox.min.z, blockBox.min.z);
+
+                    if (overlapX < overlapY && overlapX < overlapZ) {
+                        if (nextPos.x > blockBox.min.x + 0.5f) nextPos.x += overlapX;
+                        else nextPos.x -= overlapX;
+                    } else if (overlapZ < overlapY && overlapZ < overlapX) {
+                        if (nextPos.z > blockBox.min.z + 0.5f) nextPos.z += overlapZ;
+                        else nextPos.z -= overlapZ;
+                    } else {
+                        if (nextPos.y > blockBox.min.y + 0.5f) {
+                            nextPos.y += overlapY;
+                            velY = 0.0f;
+                        } else {
+                            nextPos.y -= overlapY;
+                            if (velY > 0) velY = 0;
+                        }
+                    }
+                    collided = true;
+                }
+            }
+            // 只有接触、没有推动 (贴墙站立) 时下一轮的输入与本轮相同，结果也相同，不必重复
+            if (!collided || nextPos == iterationStart) break;
         }
+
+        // 防止掉出地图
+        if (nextPos.y < -20.0f) {
+            nextPos.y = 20.0f;
+            velY = 0.0f;
+        }
+
+        m_posX[i] = nextPos.x;
+        m_posY[i] = nextPos.y;
+        m_posZ[i] = nextPos.z;
+    }
+}
+
+void EnemyPool::AdvanceStates(float deltaTime) {
+    // 死亡动画：DEATH_ANIM_DURATION 内绕自身 X 轴倒下 90 度，之后转为尸体
+    const float tiltPerSecond = glm::radians(90.0f) / Enemy::DEATH_ANIM_DURATION;
+    for (std::size_t i = 0; i < m_count; ++i) {
+        if (m_state[i] == EnemyState::Dying) {
+            m_timer[i] += deltaTime;
+            if (m_timer[i] < Enemy::DEATH_ANIM_DURATION) {
+                m_tilt[i] += tiltPerSecond * deltaTime;
+            } else {
+                m_state[i] = EnemyState::Dead;
+                m_timer[i] = 0.0f;
+            }
+        } else if (m_state[i] == EnemyState::Dead) {
+            m_timer[i] += deltaTime;
+        }
+    }
+}
+
+void EnemyPool::RecycleDeadEnemies() {
+    // 从后往前：搬入空位的是已检查过的末尾敌人，每次移除 O(1)
+    for (std::size_t i = m_count; i-- > 0; ) {
+        if (m_state[i] == EnemyState::Dead && m_timer[i] > Enemy::DEATH_DURATION) RemoveAt(i);
     }
 }
@@ -1,37 +1,105 @@
 #pragma once
 
+#include "CollisionWorld.h"
 #include "Enemy.h"
+#include "UniformGrid.h"
 #include <glm/glm.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <vector>
-#include <queue>
 
+/**
+ * @class EnemyPool
+ * @brief 敌人对象池 (SoA 存储 + 代数句柄槽位表)
+ * @details
+ *   - 每个属性一个连续数组，只含活跃敌人 (密集下标 [0, 活跃数))，与 GetActiveEnemies 同序；
+ *     全部属性列放在同一块按缓存行对齐的 slab 中，扩容时一次分配新 slab 并整体搬移
+ *   - 只有扩容会分配内存 (slab 与句柄/槽位/分离网格缓冲一起按新容量预留)，
+ *     Acquire/Release/UpdateAll 在容量内不分配；AIDirector 在尸潮前按计划规模 Reserve
+ *   - 句柄 (槽位, 代数) 经槽位表找到密集下标；移除时把末尾敌人搬入空位 (swap-and-pop)，
+ *     只需改写被搬动敌人的槽位记录，Acquire/Release 均为 O(1)，活跃列表的顺序随之改变
+ *   - 槽位释放时代数加一，持有旧句柄的一方可通过 IsValid 发现敌人已被回收
+ *   - UpdateAll 按阶段处理全部活跃敌人：重力、追踪、转向 (合成方向归一化与朝向)、积分为 SIMD 循环；
+ *     分离力按网格逐格求，每个敌人一次比较 4 个邻居，最多统计 MAX_SEPARATION_NEIGHBOURS 个；
+ *     地形碰撞逐个敌人处理，站在平地上的敌人只做一次列顶查询，其余敌人只查本帧扫过的包围盒内的方块
+ */
 class EnemyPool {
 public:
     EnemyPool(size_t initialCapacity = 100);
-    ~EnemyPool();
-    
+
     // 从对象池获取一个敌人
-    Enemy* Acquire(const glm::vec3& position);
-    
-    // 将敌人归还给对象池
-    void Release(Enemy* enemy);
-    
+    Enemy Acquire(const glm::vec3& position);
+
+    // 将敌人归还给对象池 (失效句柄忽略)
+    void Release(Enemy enemy);
+    bool IsAlive(const Enemy& enemy) const;
+
     // 更新所有活跃敌人
-    void UpdateAll(float deltaTime, const glm::vec3& playerPos, const std::vector<glm::vec3>& terrainBlocks);
-    
-    // 获取所有活跃敌人 (用于碰撞检测和渲染)
-    const std::vector<Enemy*>& GetActiveEnemies() const;
-    
+    void UpdateAll(float deltaTime, const glm::vec3& playerPos, const CollisionWorld& collision);
+
+    // 获取所有活跃敌人 (用于碰撞检测和渲染)；Acquire/Release/UpdateAll 后顺序可能变化
+    const std::vector<Enemy>& GetActiveEnemies() const;
+
     // 扩展池容量
     void ExpandCapacity(size_t additionalCount);
-    
+    // 确保容量至少为 capacity (已足够时不做任何事)
+    void Reserve(size_t capacity);
+
     // 统计信息
-    size_t GetActiveCount() const { return m_activeEnemies.size(); }
+    size_t GetActiveCount() const { return m_count; }
+    size_t GetCapacity() const { return m_capacity; }
+    size_t GetAllocationCount() const { return m_allocationCount; } // 累计分配 slab 的次数
 
 private:
-    std::vector<Enemy*> m_allEnemies;           // 所有分配的内存
-    std::queue<Enemy*> m_inactivePool;          // 可用的对象
-    std::vector<Enemy*> m_activeEnemies;        // 当前活跃的对象
-    
+    friend class Enemy;
+
+    struct Slot {
+        std::uint32_t dense = 0;      // 活跃时在 SoA 数组中的下标
+        std::uint32_t generation = 0; // 每次释放加一
+    };
+
+    struct alignas(64) SlabLine {
+        unsigned char bytes[64];
+    };
+    static constexpr int FLOAT_COLUMN_COUNT = 10;
+
+    // SoA 数据，下标为密集下标，指向 m_slab 内的各列
+    std::unique_ptr<SlabLine[]> m_slab;
+    std::size_t m_capacity = 0;
+    std::size_t m_count = 0;
+    std::size_t m_allocationCount = 0;
+    float* m_posX = nullptr;
+    float* m_posY = nullptr;
+    float* m_posZ = nullptr;
+    float* m_velX = nullptr;                   // XZ 为本帧的移动速度，Y 为重力累积的下落速度
+    float* m_velY = nullptr;
+    float* m_velZ = nullptr;
+    float* m_health = nullptr;
+    float* m_timer = nullptr;                  // 死亡计时
+    float* m_yaw = nullptr;                    // 面朝玩家的朝向 (弧度)
+    float* m_tilt = nullptr;                   // 倒地角度 (弧度)
+    EnemyState* m_state = nullptr;
+
+    std::vector<Enemy> m_activeEnemies;        // 当前活跃的对象 (密集下标 -> 句柄)
+    std::vector<Slot> m_slots;                 // 槽位 -> 密集下标
+    std::vector<std::uint32_t> m_freeSlots;    // 可用的槽位
+
+    // 分离力的邻居网格：每帧由存活敌人的位置重建一次
+    std::vector<glm::vec3> m_separationPoints;
+    std::vector<std::uint32_t> m_separationOwner; // 网格输入点 -> 密集下标
+    std::vector<float> m_separationX;             // 本帧的分离力，按密集下标 (只在 ApplySteering 内有效)
+    std::vector<float> m_separationZ;
+    UniformGrid m_separationGrid{ Enemy::SEPARATION_RADIUS };
+
+    void ApplyGravity(float deltaTime);
+    void ComputeSeek(const glm::vec3& playerPos);
+    void ApplySteering();
+    void Integrate(float deltaTime);
+    void ResolveTerrain(const CollisionWorld& collision, float deltaTime);
+    void AdvanceStates(float deltaTime);
+    std::array<float**, FLOAT_COLUMN_COUNT> FloatColumns();
+    void RemoveAt(std::size_t dense);
     void RecycleDeadEnemies();
 };
@@ -0,0 +1,342 @@
+#include "FlythroughBench.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+namespace {
+
+constexpr float DEG_TO_RAD = 3.14159265f / 180.0f;
+constexpr float MIN_REGRESSION_MS = 0.05f; // 小于该绝对差的变化视为噪声
+
+// 最近秩百分位 (values 已排序)
+float Percentile(const std::vector<float>& sorted, float percent)
+{
+    if (sorted.empty()) return 0.0f;
+    std::size_t rank = static_cast<std::size_t>(std::ceil(percent / 100.0f * static_cast<float>(sorted.size())));
+    rank = std::min(std::max<std::size_t>(rank, 1), sorted.size());
+    return sorted[rank - 1];
+}
+
+struct MetricStats {
+    float p50 = 0.0f, p95 = 0.0f, p99 = 0.0f, max = 0.0f;
+};
+
+template <typename Getter>
+MetricStats ComputeStats(const std::vector<FlythroughFrame>& frames, Getter get)
+{
+    std::vector<float> values;
+    values.reserve(frames.size());
+    for (const auto& f : frames) values.push_back(get(f));
+    std::sort(values.begin(), values.end());
+    MetricStats stats;
+    if (values.empty()) return stats;
+    stats.p50 = Percentile(values, 50.0f);
+    stats.p95 = Percentile(values, 95.0f);
+    stats.p99 = Percentile(values, 99.0f);
+    stats.max = values.back();
+    return stats;
+}
+
+void WriteStats(std::ostream& os, const char* name, const MetricStats& s, bool last)
+{
+    os << "    \"" << name << "\": { \"p50\": " << s.p50 << ", \"p95\": " << s.p95
+       << ", \"p99\": " << s.p99 << ", \"max\": " << s.max << " }" << (last ? "\n" : ",\n");
+}
+
+// 把报告展平为 "a.b.c" -> 标量文本 (只覆盖报告用到的 JSON 子集)
+class JsonFlattener {
+public:
+    explicit JsonFlattener(const std::string& text) : m_text(text) {}
+
+    bool Parse(std::map<std::string, std::string>& out) {
+        m_out = &out;
+        if (!ParseValue("")) return false;
+        SkipSpace();
+        return m_pos == m_text.size();
+    }
+
+private:
+    const std::string& m_text;
+    std::size_t m_pos = 0;
+    std::map<std::string, std::string>* m_out = nullptr;
+
+    void SkipSpace() {
+        while (m_pos < m_text.size() && std::isspace(static_cast<unsigned char>(m_text[m_pos]))) m_pos++;
+    }
+
+    bool Consume(char c) {
+        SkipSpace();
+        if (m_pos >= m_text.size() || m_text[m_pos] != c) return false;
+        m_pos++;
+        return true;
+    }
+
+    static std::string Join(const std::string& path, const std::string& key) {
+        return path.empty() ? key : path + "." + key;
+    }
+
+    bool ParseString(std::string& out) {
+        if (!Consume('"')) return false;
+        out.clear();
+        while (m_pos < m_text.size() && m_text[m_pos] != '"') {
+            if (m_text[m_pos] == '\\' && m_pos + 1 < m_text.size()) m_pos++;
+            out.push_back(m_text[m_pos++]);
+        }
+        return Consume('"');
+    }
+
+    bool ParseValue(const std::string& path) {
+        SkipSpace();
+        if (m_pos >= m_text.size()) return false;
+        char c = m_text[m_pos];
+        if (c == '{') {
+            m_pos++;
+            if (Consume('}')) return true;
+            do {
+                std::string key;
+                if (!ParseString(key) || !Consume(':') || !ParseValue(Join(path, key))) return false;
+            } while (Consume(','));
+            return Consume('}');
+        }
+        if (c == '[') {
+            m_pos++;
+            if (Consume(']')) return true;
+            int index = 0;
+            do {
+                if (!ParseValue(Join(path, std::to_string(index++)))) return false;
+            } while (Consume(','));
+            return Consume(']');
+        }
+        if (c == '"') {
+            std::string value;
+            if (!ParseString(value)) return false;
+            (*m_out)[path] = value;
+            return true;
+        }
+        std::size_t start = m_pos;
+        while (m_pos < m_text.size() && (std::isalnum(static_cast<unsigned char>(m_text[m_pos])) ||
+                                         m_text[m_pos] == '-' || m_text[m_pos] == '+' || m_text[m_pos] == '.')) {
+            m_pos++;
+        }
+        if (start == m_pos) return false;
+        (*m_out)[path] = m_text.substr(start, m_pos - start);
+        return true;
+    }
+};
+
+bool LoadFlatReport(const std::string& path, std::map<std::string, std::string>& out)
+{
+    std::ifstream ifs(path);
+    if (!ifs) {
+        std::cerr << "[Compare] Cannot open " << path << std::endl;
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << ifs.rdbuf();
+    std::string text = buffer.str();
+    if (!JsonFlattener(text).Parse(out)) {
+        std::cerr << "[Compare] Malformed report: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool EndsWith(const std::string& s, const char* suffix)
+{
+    std::size_t n = std::char_traits<char>::length(suffix);
+    return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+} // namespace
+
+// ==================== FlythroughPath ====================
+
+FlythroughPath::FlythroughPath(std::vector<FlythroughSegment> segments, float startX, float startZ, float startYaw)
+    : m_segments(std::move(segments))
+{
+    FlythroughPose pose;
+    pose.x = startX;
+    pose.z = startZ;
+    pose.yaw = startYaw;
+    for (std::size_t i = 0; i < m_segments.size(); ++i) {
+        pose.segment = static_cast<int>(i);
+        m_starts.push_back(pose);
+        m_startTimes.push_back(m_duration);
+        pose = Advance(pose, m_segments[i], m_segments[i].duration);
+        m_duration += m_segments[i].duration;
+    }
+}
+
+FlythroughPath FlythroughPath::Default(float startX, float startZ, float startYaw)
+{
+    // 冲刺速度约为步行的 4 倍，每秒跨过一个多区块，持续压测流式加载
+    return FlythroughPath({
+        { "sprint",        8.0f, 20.0f,  0.0f,   0.0f },
+        { "circle_strafe", 8.0f,  0.0f, 12.0f, -45.0f }, // 横移同时反向转向，绕一点转一整圈
+        { "spin_180",      0.5f,  0.0f,  0.0f, 360.0f },
+        { "sprint_back",   6.0f, 20.0f,  0.0f,   0.0f },
+    }, startX, startZ, startYaw);
+}
+
+FlythroughPose FlythroughPath::Advance(const FlythroughPose& start, const FlythroughSegment& segment, float t)
+{
+    // 朝向 (cos yaw, sin yaw)，右方向 (-sin yaw, cos yaw)，与 Camera 的向量约定一致
+    const float yaw0 = start.yaw * DEG_TO_RAD;
+    const float omega = segment.yawRate * DEG_TO_RAD;
+    const float yaw1 = yaw0 + omega * t;
+
+    float intCos, intSin; // cos/sin(yaw) 在 [0, t] 上的积分
+    if (std::abs(omega) < 1e-6f) {
+        intCos = std::cos(yaw0) * t;
+        intSin = std::sin(yaw0) * t;
+    } else {
+        intCos = (std::sin(yaw1) - std::sin(yaw0)) / omega;
+        intSin = (std::cos(yaw0) - std::cos(yaw1)) / omega;
+    }
+
+    FlythroughPose pose = start;
+    pose.x += segment.forwardSpeed * intCos - segment.strafeSpeed * intSin;
+    pose.z += segment.forwardSpeed * intSin + segment.strafeSpeed * intCos;
+    pose.yaw = start.yaw + segment.yawRate * t;
+    return pose;
+}
+
+FlythroughPose FlythroughPath::Sample(float time) const
+{
+    if (m_segments.empty()) return FlythroughPose();
+    time = std::min(std::max(time, 0.0f), m_duration);
+    std::size_t i = m_segments.size() - 1;
+    while (i > 0 && time < m_startTimes[i]) --i;
+    return Advance(m_starts[i], m_segments[i], std::min(time - m_startTimes[i], m_segments[i].duration));
+}
+
+// ==================== FlythroughRecorder ====================
+
+float FlythroughRecorder::GetHitchThreshold() const
+{
+    MetricStats frame = ComputeStats(m_frames, [](const FlythroughFrame& f) { return f.frameMs; });
+    return std::max(HITCH_FACTOR * frame.p50, HITCH_MIN_MS);
+}
+
+bool FlythroughRecorder::WriteReport(const std::string& path, const FlythroughPath& flightPath, const FlythroughRunInfo& info) const
+{
+    std::ofstream os(path);
+    if (!os) {
+        std::cerr << "[Flythrough] Cannot write report to " << path << std::endl;
+        return false;
+    }
+
+    const float hitchThreshold = GetHitchThreshold();
+    int hitches = 0;
+    for (const auto& f : m_frames) hitches += f.frameMs > hitchThreshold ? 1 : 0;
+
+    os << std::fixed << std::setprecision(4);
+    os << "{\n";
+    os << "  \"benchmark\": \"flythrough\",\n";
+    os << "  \"mode\": \"" << info.mode << "\",\n";
+    os << "  \"seed\": " << info.seed << ",\n";
+    os << "  \"viewDistance\": " << info.viewDistance << ",\n";
+    os << "  \"workers\": " << info.workers << ",\n";
+    os << "  \"frames\": " << m_frames.size() << ",\n";
+    os << "  \"duration\": " << flightPath.GetDuration() << ",\n";
+    os << "  \"hitchThresholdMs\": " << hitchThreshold << ",\n";
+    os << "  \"hitches\": " << hitches << ",\n";
+
+    os << "  \"metrics\": {\n";
+    WriteStats(os, "frameMs", ComputeStats(m_frames, [](const FlythroughFrame& f) { return f.frameMs; }), false);
+    WriteStats(os, "updateVisibleChunksMs", ComputeStats(m_frames, [](const FlythroughFrame& f) { return f.updateChunksMs; }), false);
+    WriteStats(os, "collisionUpdateMs", ComputeStats(m_frames, [](const FlythroughFrame& f) { return f.collisionUpdateMs; }), false);
+    WriteStats(os, "enemyUpdateMs", ComputeStats(m_frames, [](const FlythroughFrame& f) { return f.enemyUpdateMs; }), true);
+    os << "  },\n";
+
+    // 分段统计：定位卡顿出现在哪种移动方式下
+    const auto& segments = flightPath.GetSegments();
+    os << "  \"segments\": {\n";
+    for (std::size_t i = 0; i < segments.size(); ++i) {
+        std::vector<FlythroughFrame> frames;
+        for (const auto& f : m_frames) {
+            if (f.segment == static_cast<int>(i)) frames.push_back(f);
+        }
+        int segmentHitches = 0;
+        for (const auto& f : frames) segmentHitches += f.frameMs > hitchThreshold ? 1 : 0;
+        MetricStats stats = ComputeStats(frames, [](const FlythroughFrame& f) { return f.frameMs; });
+        os << "    \"" << segments[i].name << "\": { \"frames\": " << frames.size() << ", \"frameP99\": " << stats.p99
+           << ", \"frameMax\": " << stats.max << ", \"hitches\": " << segmentHitches << " }"
+           << (i + 1 < segments.size() ? ",\n" : "\n");
+    }
+    os << "  }\n";
+    os << "}\n";
+
+    std::cout << "[Flythrough] Report written to " << path << std::endl;
+    return static_cast<bool>(os);
+}
+
+void FlythroughRecorder::PrintSummary() const
+{
+    MetricStats frame = ComputeStats(m_frames, [](const FlythroughFrame& f) { return f.frameMs; });
+    MetricStats chunks = ComputeStats(m_frames, [](const FlythroughFrame& f) { return f.updateChunksMs; });
+    const float hitchThreshold = GetHitchThreshold();
+    int hitches = 0;
+    for (const auto& f : m_frames) hitches += f.frameMs > hitchThreshold ? 1 : 0;
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "[Flythrough] " << m_frames.size() << " frames, frame ms p50/p95/p99/max: " << frame.p50 << "/"
+              << frame.p95 << "/" << frame.p99 << "/" << frame.max << ", hitches (>" << hitchThreshold << "ms): " << hitches << std::endl;
+    std::cout << "[Flythrough] UpdateVisibleChunks ms p50/p99/max: " << chunks.p50 << "/" << chunks.p99 << "/" << chunks.max << std::endl;
+    std::cout << std::defaultfloat;
+}
+
+// ==================== 报告对比 ====================
+
+int CompareFlythroughReports(const std::string& baselinePath, const std::string& currentPath, float tolerance)
+{
+    std::map<std::string, std::string> baseline, current;
+    if (!LoadFlatReport(baselinePath, baseline) || !LoadFlatReport(currentPath, current)) return 2;
+
+    for (const char* key : { "mode", "seed", "viewDistance", "workers" }) {
+        if (baseline[key] != current[key]) {
+            std::cout << "[Compare] Warning: " << key << " differs (baseline " << baseline[key]
+                      << ", current " << current[key] << "), results may not be comparable" << std::endl;
+        }
+    }
+
+    int regressions = 0;
+    std::cout << std::fixed << std::setprecision(3);
+    for (const auto& [key, baseText] : baseline) {
+        const bool isTiming = key.rfind("metrics.", 0) == 0 || EndsWith(key, ".frameP99") || EndsWith(key, ".frameMax");
+        const bool isHitches = key == "hitches" || EndsWith(key, ".hitches");
+        if (!isTiming && !isHitches) continue;
+
+        auto it = current.find(key);
+        if (it == current.end()) {
+            std::cout << "[Compare] " << key << ": missing from current report" << std::endl;
+            continue;
+        }
+        const double base = std::strtod(baseText.c_str(), nullptr);
+        const double cur = std::strtod(it->second.c_str(), nullptr);
+
+        bool regressed;
+        if (isTiming) regressed = cur > base * (1.0 + tolerance) && cur - base > MIN_REGRESSION_MS;
+        else regressed = cur > base * (1.0 + tolerance) + 1.0; // 卡顿数允许 1 次抖动
+
+        const double change = base > 0.0 ? (cur - base) / base * 100.0 : 0.0;
+        std::cout << "[Compare] " << (regressed ? "REGRESSION " : "ok         ") << key << ": " << base << " -> " << cur
+                  << " (" << (change >= 0.0 ? "+" : "") << change << "%)" << std::endl;
+        if (regressed) regressions++;
+    }
+    std::cout << std::defaultfloat;
+
+    if (regressions > 0) {
+        std::cout << "[Compare] " << regressions << " regression(s) beyond " << tolerance * 100.0f << "% tolerance" << std::endl;
+        return 1;
+    }
+    std::cout << "[Compare] No regressions beyond " << tolerance * 100.0f << "% tolerance" << std::endl;
+    return 0;
+}
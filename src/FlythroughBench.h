@@ -0,0 +1,112 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 飞行路径上的一段：持续时间内以固定的机体速度移动并匀速转向
+struct FlythroughSegment {
+    const char* name;
+    float duration;     // 秒
+    float forwardSpeed; // 沿朝向的速度 (方块/秒)
+    float strafeSpeed;  // 沿右侧的速度 (方块/秒)
+    float yawRate;      // 偏航角速度 (度/秒)
+};
+
+// 路径上某一时刻的水平位置与朝向 (高度由调用方贴地)
+struct FlythroughPose {
+    float x = 0.0f;
+    float z = 0.0f;
+    float yaw = 0.0f; // 度数，与 Camera 的 yaw 一致
+    int segment = 0;
+};
+
+/**
+ * @class FlythroughPath
+ * @brief 基准测试的程序化飞行路径
+ * @details
+ *   - 位置按时间解析积分 (匀速转向时为圆弧)，与帧率和步长无关，每次运行经过完全相同的区块
+ *   - 默认路径：直线冲刺、绕圈横移、原地 180 度转身、反向冲刺
+ */
+class FlythroughPath {
+public:
+    FlythroughPath(std::vector<FlythroughSegment> segments, float startX, float startZ, float startYaw);
+
+    static FlythroughPath Default(float startX, float startZ, float startYaw);
+
+    FlythroughPose Sample(float time) const;
+    float GetDuration() const { return m_duration; }
+    const std::vector<FlythroughSegment>& GetSegments() const { return m_segments; }
+
+private:
+    std::vector<FlythroughSegment> m_segments;
+    std::vector<FlythroughPose> m_starts; // 每段起点的位姿
+    std::vector<float> m_startTimes;
+    float m_duration = 0.0f;
+
+    static FlythroughPose Advance(const FlythroughPose& start, const FlythroughSegment& segment, float t);
+};
+
+// 一帧的耗时 (毫秒)：整帧与各阶段
+struct FlythroughFrame {
+    float frameMs = 0.0f;
+    float updateChunksMs = 0.0f;    // UpdateVisibleChunks (含其中的碰撞位图更新)
+    float collisionUpdateMs = 0.0f; // 区块合并/回收/编辑时的碰撞占用位图更新
+    float enemyUpdateMs = 0.0f;    // AIDirector::Update + EnemyPool::UpdateAll
+    int segment = 0;
+};
+
+// 写入报告的运行环境信息 (对比时用于提示两次运行是否可比)
+struct FlythroughRunInfo {
+    std::string mode; // "headless" 或 "windowed"
+    std::uint32_t seed = 0;
+    int viewDistance = 0;
+    unsigned int workers = 0;
+};
+
+/**
+ * @class FlythroughRecorder
+ * @brief 记录每帧耗时并输出百分位报告 (JSON)
+ * @details
+ *   - 每个指标输出 p50/p95/p99/max (最近秩百分位)
+ *   - 卡顿帧：整帧耗时超过 max(HITCH_FACTOR * p50, HITCH_MIN_MS)
+ */
+class FlythroughRecorder {
+public:
+    static constexpr float HITCH_FACTOR = 2.0f;
+    static constexpr float HITCH_MIN_MS = 4.0f;
+
+    void Record(const FlythroughFrame& frame) { m_frames.push_back(frame); }
+    std::size_t GetFrameCount() const { return m_frames.size(); }
+
+    bool WriteReport(const std::string& path, const FlythroughPath& flightPath, const FlythroughRunInfo& info) const;
+    void PrintSummary() const;
+
+private:
+    std::vector<FlythroughFrame> m_frames;
+
+    float GetHitchThreshold() const;
+};
+
+/**
+ * @brief 对比两份报告，指标变慢超过容差 (且绝对差超过 0.05ms) 或卡顿数增加时判为回退
+ * @return 0 无回退，1 有回退，2 读取失败
+ */
+int CompareFlythroughReports(const std::string& baselinePath, const std::string& currentPath, float tolerance);
+
+// 累加作用域耗时 (毫秒) 到目标变量
+class ScopedMsTimer {
+public:
+    explicit ScopedMsTimer(float& target) : m_target(target), m_start(std::chrono::steady_clock::now()) {}
+    ~ScopedMsTimer() {
+        m_target += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - m_start).count();
+    }
+
+    ScopedMsTimer(const ScopedMsTimer&) = delete;
+    ScopedMsTimer& operator=(const ScopedMsTimer&) = delete;
+
+private:
+    float& m_target;
+    std::chrono::steady_clock::time_point m_start;
+};
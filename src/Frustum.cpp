@@ -0,0 +1,33 @@
+#include "Frustum.h"
+#include <cmath>
+
+void Frustum::Update(const glm::mat4& m)
+{
+    // GLM 为列主序：第 i 行为 (m[0][i], m[1][i], m[2][i], m[3][i])
+    auto row = [&m](int i) { return glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]); };
+    glm::vec4 r0 = row(0), r1 = row(1), r2 = row(2), r3 = row(3);
+
+    m_planes[0] = r3 + r0; // 左
+    m_planes[1] = r3 - r0; // 右
+    m_planes[2] = r3 + r1; // 下
+    m_planes[3] = r3 - r1; // 上
+    m_planes[4] = r3 + r2; // 近
+    m_planes[5] = r3 - r2; // 远
+
+    for (glm::vec4& p : m_planes) {
+        float len = std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
+        if (len > 0.0f) p = p * (1.0f / len);
+    }
+}
+
+bool Frustum::IntersectsAABB(const glm::vec3& boxMin, const glm::vec3& boxMax) const
+{
+    for (const glm::vec4& p : m_planes) {
+        // 取沿平面法线方向最远的顶点，它在外侧则整个盒子在外侧
+        glm::vec3 positive(p.x >= 0.0f ? boxMax.x : boxMin.x,
+                           p.y >= 0.0f ? boxMax.y : boxMin.y,
+                           p.z >= 0.0f ? boxMax.z : boxMin.z);
+        if (p.x * positive.x + p.y * positive.y + p.z * positive.z + p.w < 0.0f) return false;
+    }
+    return true;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+/**
+ * @class Frustum
+ * @brief 视锥体 (用于区块级剔除)
+ * @details
+ *   - 从 projection * view 矩阵提取 6 个平面 (Gribb-Hartmann)
+ *   - AABB 测试使用 "正顶点"：只要有一个平面把整个盒子放在外侧即判定不可见
+ *   - 保守测试：可能把少量不可见的盒子判为可见，但不会误剔除
+ */
+class Frustum {
+public:
+    // 每帧用当前的 projection * view 更新
+    void Update(const glm::mat4& viewProjection);
+
+    bool IntersectsAABB(const glm::vec3& boxMin, const glm::vec3& boxMax) const;
+
+private:
+    glm::vec4 m_planes[6]; // (法线 xyz, 距离 w)，法线指向视锥内侧
+};
@@ -1,9 +1,11 @@
 #include "InstancedMesh.h"
 #include <glad/glad.h>
+#include <algorithm>
 #include <iostream>
 
 InstancedMesh::InstancedMesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices)
-    : Mesh(vertices, indices), m_instanceVBO_Pos(0), m_instanceVBO_Color(0), m_capacityPos(0), m_capacityColor(0)
+    : Mesh(vertices, indices), m_instanceVBO_Pos(0), m_instanceVBO_Color(0), m_instanceVBO_Mask(0),
+      m_capacityPos(0), m_capacityColor(0), m_capacityMask(0), m_slotCapacity(0), m_slotInstanceCount(0), m_indirectBuffer(0), m_commandsDirty(true)
 {
     // Mesh 构造函数已经设置了 VAO 和 基础 VBO (Pos, Normal)
     // 现在我们需要添加实例属性
@@ -12,6 +14,7 @@ InstancedMesh::InstancedMesh(const std::vector<Vertex>& vertices, const std::vec
     // 生成实例缓冲
     glGenBuffers(1, &m_instanceVBO_Pos);
     glGenBuffers(1, &m_instanceVBO_Color);
+    glGenBuffers(1, &m_instanceVBO_Mask);
 
     // 绑定实例位置缓冲 (Layout 3)
     glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO_Pos);
@@ -26,6 +29,12 @@ InstancedMesh::InstancedMesh(const std::vector<Vertex>& vertices, const std::vec
     glEnableVertexAttribArray(4);
     glVertexAttribDivisor(4, 1); // 告诉 OpenGL 这个属性每 1 个实例更新一次
 
+    // 绑定可见面掩码缓冲 (Layout 5，整数属性)
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO_Mask);
+    glVertexAttribIPointer(5, 1, GL_UNSIGNED_INT, sizeof(GLuint), (void*)0);
+    glEnableVertexAttribArray(5);
+    glVertexAttribDivisor(5, 1);
+
     glBindVertexArray(0);
 }
 
@@ -33,6 +42,8 @@ InstancedMesh::~InstancedMesh()
 {
     glDeleteBuffers(1, &m_instanceVBO_Pos);
     glDeleteBuffers(1, &m_instanceVBO_Color);
+    glDeleteBuffers(1, &m_instanceVBO_Mask);
+    if (m_indirectBuffer) glDeleteBuffers(1, &m_indirectBuffer);
 }
 
 void InstancedMesh::updateInstanceData(const std::vector<glm::vec3>& positions, const std::vector<glm::vec3>& colors)
@@ -59,6 +70,16 @@ void InstancedMesh::updateInstanceData(const std::vector<glm::vec3>& positions,
     }
     glBufferSubData(GL_ARRAY_BUFFER, 0, bytesColor, colors.data());
 
+    // 整块上传路径不做面剔除
+    std::vector<GLuint> masks(positions.size(), ALL_FACES);
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO_Mask);
+    size_t bytesMask = masks.size() * sizeof(GLuint);
+    if (bytesMask > m_capacityMask) {
+        m_capacityMask = static_cast<size_t>(bytesMask * 1.5f);
+        glBufferData(GL_ARRAY_BUFFER, m_capacityMask, nullptr, GL_DYNAMIC_DRAW);
+    }
+    glBufferSubData(GL_ARRAY_BUFFER, 0, bytesMask, masks.data());
+
     glBindVertexArray(0);
 }
 
@@ -69,3 +90,227 @@ void InstancedMesh::drawInstanced(unsigned int instanceCount)
     glDrawElementsInstanced(GL_TRIANGLES, static_cast<unsigned int>(indices.size()), GL_UNSIGNED_INT, 0, instanceCount);
     glBindVertexArray(0);
 }
+
+// ==================== 槽位子分配 ====================
+
+void InstancedMesh::bindInstanceAttributes()
+{
+    // VAO 记录的是调用 glVertexAttribPointer 时绑定的缓冲，替换缓冲后需要重新指定
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO_Pos);
+    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO_Color);
+    glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO_Mask);
+    glVertexAttribIPointer(5, 1, GL_UNSIGNED_INT, sizeof(GLuint), (void*)0);
+    glBindVertexArray(0);
+}
+
+void InstancedMesh::growSlotStorage(size_t minExtraInstances)
+{
+    size_t oldCapacity = m_slotCapacity;
+    size_t newCapacity = std::max(oldCapacity * 2, oldCapacity + minExtraInstances);
+    newCapacity = std::max<size_t>(newCapacity, 4096);
+
+    // 新建更大的缓冲，并在 GPU 端拷贝已有槽位数据
+    struct InstanceBuffer { unsigned int* buffer; size_t stride; };
+    const InstanceBuffer buffers[3] = {
+        { &m_instanceVBO_Pos, sizeof(glm::vec3) },
+        { &m_instanceVBO_Color, sizeof(glm::vec3) },
+        { &m_instanceVBO_Mask, sizeof(GLuint) },
+    };
+    for (const InstanceBuffer& b : buffers) {
+        unsigned int newBuffer = 0;
+        glGenBuffers(1, &newBuffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, newBuffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, newCapacity * b.stride, nullptr, GL_DYNAMIC_DRAW);
+        if (oldCapacity > 0) {
+            glBindBuffer(GL_COPY_READ_BUFFER, *b.buffer);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, oldCapacity * b.stride);
+        }
+        glDeleteBuffers(1, b.buffer);
+        *b.buffer = newBuffer;
+    }
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    m_capacityPos = newCapacity * sizeof(glm::vec3);
+    m_capacityColor = newCapacity * sizeof(glm::vec3);
+    m_capacityMask = newCapacity * sizeof(GLuint);
+    m_slotCapacity = newCapacity;
+    bindInstanceAttributes();
+
+    // 新增部分并入空闲链表 (与末尾空闲区间合并)
+    if (!m_freeRanges.empty() && m_freeRanges.back().offset + m_freeRanges.back().count == oldCapacity) {
+        m_freeRanges.back().count += newCapacity - oldCapacity;
+    } else {
+        m_freeRanges.push_back({ oldCapacity, newCapacity - oldCapacity });
+    }
+}
+
+int InstancedMesh::allocateSlot(size_t instanceCount)
+{
+    if (instanceCount == 0) instanceCount = 1;
+
+    // 首次适配
+    auto it = std::find_if(m_freeRanges.begin(), m_freeRanges.end(),
+                           [&](const FreeRange& r) { return r.count >= instanceCount; });
+    if (it == m_freeRanges.end()) {
+        size_t tail = 0;
+        if (!m_freeRanges.empty() && m_freeRanges.back().offset + m_freeRanges.back().count == m_slotCapacity) {
+            tail = m_freeRanges.back().count;
+        }
+        growSlotStorage(instanceCount - tail);
+        it = std::find_if(m_freeRanges.begin(), m_freeRanges.end(),
+                          [&](const FreeRange& r) { return r.count >= instanceCount; });
+    }
+
+    Slot slot;
+    slot.offset = it->offset;
+    slot.capacity = instanceCount;
+    slot.count = 0;
+    slot.live = true;
+    it->offset += instanceCount;
+    it->count -= instanceCount;
+    if (it->count == 0) m_freeRanges.erase(it);
+
+    int id;
+    if (!m_freeSlotIds.empty()) {
+        id = m_freeSlotIds.back();
+        m_freeSlotIds.pop_back();
+        m_slots[id] = slot;
+    } else {
+        id = static_cast<int>(m_slots.size());
+        m_slots.push_back(slot);
+    }
+    m_commandsDirty = true;
+    return id;
+}
+
+void InstancedMesh::updateSlot(int slot, const std::vector<glm::vec3>& positions, const std::vector<glm::vec3>& colors,
+                               const std::vector<GLuint>& faceMasks)
+{
+    if (slot < 0 || slot >= static_cast<int>(m_slots.size()) || !m_slots[slot].live) return;
+    Slot& s = m_slots[slot];
+
+    size_t count = std::min({ positions.size(), colors.size(), faceMasks.size(), s.capacity });
+    if (count > 0) {
+        GLintptr offsetBytes = static_cast<GLintptr>(s.offset * sizeof(glm::vec3));
+        GLsizeiptr sizeBytes = static_cast<GLsizeiptr>(count * sizeof(glm::vec3));
+        glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO_Pos);
+        glBufferSubData(GL_ARRAY_BUFFER, offsetBytes, sizeBytes, positions.data());
+        glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO_Color);
+        glBufferSubData(GL_ARRAY_BUFFER, offsetBytes, sizeBytes, colors.data());
+        glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO_Mask);
+        glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(s.offset * sizeof(GLuint)),
+                        static_cast<GLsizeiptr>(count * sizeof(GLuint)), faceMasks.data());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    m_slotInstanceCount = m_slotInstanceCount - s.count + count;
+    s.count = count;
+    m_commandsDirty = true;
+}
+
+void InstancedMesh::freeSlot(int slot)
+{
+    if (slot < 0 || slot >= static_cast<int>(m_slots.size()) || !m_slots[slot].live) return;
+    Slot& s = m_slots[slot];
+
+    // 按 offset 插入空闲链表并与前后区间合并
+    FreeRange range{ s.offset, s.capacity };
+    auto it = std::lower_bound(m_freeRanges.begin(), m_freeRanges.end(), range,
+                               [](const FreeRange& a, const FreeRange& b) { return a.offset < b.offset; });
+    it = m_freeRanges.insert(it, range);
+    if (it + 1 != m_freeRanges.end() && it->offset + it->count == (it + 1)->offset) {
+        it->count += (it + 1)->count;
+        m_freeRanges.erase(it + 1);
+    }
+    if (it != m_freeRanges.begin() && (it - 1)->offset + (it - 1)->count == it->offset) {
+        (it - 1)->count += it->count;
+        m_freeRanges.erase(it);
+    }
+
+    m_slotInstanceCount -= s.count;
+    s = Slot();
+    m_freeSlotIds.push_back(slot);
+    m_commandsDirty = true;
+}
+
+void InstancedMesh::drawSlots()
+{
+    if (m_commandsDirty) {
+        m_drawCommands.clear();
+        for (const Slot& s : m_slots) {
+            if (!s.live || s.count == 0) continue;
+            DrawCommand cmd;
+            cmd.count = static_cast<GLuint>(indices.size());
+            cmd.instanceCount = static_cast<GLuint>(s.count);
+            cmd.firstIndex = 0;
+            cmd.baseVertex = 0;
+            cmd.baseInstance = static_cast<GLuint>(s.offset);
+            m_drawCommands.push_back(cmd);
+        }
+        if (GLAD_GL_VERSION_4_3 && !m_drawCommands.empty()) {
+            if (!m_indirectBuffer) glGenBuffers(1, &m_indirectBuffer);
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_indirectBuffer);
+            glBufferData(GL_DRAW_INDIRECT_BUFFER, m_drawCommands.size() * sizeof(DrawCommand),
+                         m_drawCommands.data(), GL_DYNAMIC_DRAW);
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        }
+        m_commandsDirty = false;
+    }
+    submitDrawCommands();
+}
+
+size_t InstancedMesh::getSlotCount(int slot) const
+{
+    if (slot < 0 || slot >= static_cast<int>(m_slots.size()) || !m_slots[slot].live) return 0;
+    return m_slots[slot].count;
+}
+
+void InstancedMesh::drawSlots(const std::vector<int>& slots)
+{
+    m_drawCommands.clear();
+    for (int id : slots) {
+        if (id < 0 || id >= static_cast<int>(m_slots.size())) continue;
+        const Slot& s = m_slots[id];
+        if (!s.live || s.count == 0) continue;
+        DrawCommand cmd;
+        cmd.count = static_cast<GLuint>(indices.size());
+        cmd.instanceCount = static_cast<GLuint>(s.count);
+        cmd.firstIndex = 0;
+        cmd.baseVertex = 0;
+        cmd.baseInstance = static_cast<GLuint>(s.offset);
+        m_drawCommands.push_back(cmd);
+    }
+    if (GLAD_GL_VERSION_4_3 && !m_drawCommands.empty()) {
+        if (!m_indirectBuffer) glGenBuffers(1, &m_indirectBuffer);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_indirectBuffer);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, m_drawCommands.size() * sizeof(DrawCommand),
+                     m_drawCommands.data(), GL_STREAM_DRAW);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+    // 命令列表已被子集覆盖，下次全量绘制时需要重建
+    m_commandsDirty = true;
+    submitDrawCommands();
+}
+
+void InstancedMesh::submitDrawCommands()
+{
+    if (m_drawCommands.empty()) return;
+
+    glBindVertexArray(VAO);
+    if (GLAD_GL_VERSION_4_3) {
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_indirectBuffer);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr,
+                                    static_cast<GLsizei>(m_drawCommands.size()), 0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    } else {
+        for (const DrawCommand& cmd : m_drawCommands) {
+            glDrawElementsInstancedBaseInstance(GL_TRIANGLES, static_cast<GLsizei>(cmd.count), GL_UNSIGNED_INT,
+                                                nullptr, static_cast<GLsizei>(cmd.instanceCount), cmd.baseInstance);
+        }
+    }
+    glBindVertexArray(0);
+}
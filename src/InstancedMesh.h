@@ -9,15 +9,76 @@ public:
     InstancedMesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices);
     ~InstancedMesh();
 
-    // 更新实例数据
+    // 可见面掩码 (实例属性 5)：bit0 +X, bit1 -X, bit2 +Y, bit3 -Y, bit4 +Z, bit5 -Z
+    static constexpr GLuint ALL_FACES = 0x3F;
+
+    // 更新实例数据 (整块上传，所有面可见，不要与槽位接口混用)
     void updateInstanceData(const std::vector<glm::vec3>& positions, const std::vector<glm::vec3>& colors);
-    
+
     // 绘制所有实例
     void drawInstanced(unsigned int instanceCount);
 
+    // ==================== 槽位子分配 (每个区块一段实例区间) ====================
+    // 分配一段可容纳 instanceCount 个实例的区间，返回槽位 ID
+    int allocateSlot(size_t instanceCount);
+
+    // 上传槽位数据 (只写该槽位对应的字节)，数量不能超过分配时的容量
+    void updateSlot(int slot, const std::vector<glm::vec3>& positions, const std::vector<glm::vec3>& colors,
+                    const std::vector<GLuint>& faceMasks);
+
+    // 释放槽位，区间回到空闲链表
+    void freeSlot(int slot);
+
+    // 一次 MultiDraw 绘制所有有效槽位 (GL 4.3 以下退化为每槽一次绘制)
+    void drawSlots();
+
+    // 只绘制给定的槽位 (例如视锥剔除后的可见区块)，每次调用重建间接绘制命令
+    void drawSlots(const std::vector<int>& slots);
+
+    // 槽位中已上传的实例数
+    size_t getSlotCount(int slot) const;
+
+    // 当前所有槽位中的实例总数
+    size_t getSlotInstanceCount() const { return m_slotInstanceCount; }
+
 private:
     unsigned int m_instanceVBO_Pos;
     unsigned int m_instanceVBO_Color;
+    unsigned int m_instanceVBO_Mask;
     size_t m_capacityPos;
     size_t m_capacityColor;
+    size_t m_capacityMask;
+
+    struct Slot {
+        size_t offset = 0;   // 起始实例下标
+        size_t capacity = 0; // 分配的实例数
+        size_t count = 0;    // 已上传的实例数
+        bool live = false;
+    };
+    struct FreeRange {
+        size_t offset;
+        size_t count;
+    };
+    // 与 glMultiDrawElementsIndirect 要求的布局一致
+    struct DrawCommand {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint firstIndex;
+        GLuint baseVertex;
+        GLuint baseInstance;
+    };
+
+    std::vector<Slot> m_slots;
+    std::vector<int> m_freeSlotIds;
+    std::vector<FreeRange> m_freeRanges; // 按 offset 排序，相邻区间会合并
+    size_t m_slotCapacity;               // 槽位模式下缓冲区可容纳的实例数
+    size_t m_slotInstanceCount;
+
+    unsigned int m_indirectBuffer;
+    std::vector<DrawCommand> m_drawCommands;
+    bool m_commandsDirty;
+
+    void growSlotStorage(size_t minExtraInstances);
+    void submitDrawCommands();
+    void bindInstanceAttributes();
 };
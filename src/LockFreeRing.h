@@ -0,0 +1,156 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// 避免相邻原子变量落在同一缓存行 (生产者/消费者伪共享)
+constexpr std::size_t RING_CACHE_LINE = 64;
+
+/**
+ * @class SpscRing
+ * @brief 有界无锁环形队列 (单生产者 / 单消费者)
+ * @details
+ *   - 容量向上取整为 2 的幂，满时 TryPush 返回 false，空时 TryPop 返回 false
+ *   - 两端都不会阻塞；元素通过移动赋值进出槽位，T 需可默认构造
+ */
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(std::size_t capacity)
+        : m_mask(RoundUpPow2(capacity) - 1), m_slots(new T[m_mask + 1])
+    {
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // 仅生产者线程调用
+    bool TryPush(T&& value) {
+        std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_headCache > m_mask) {
+            m_headCache = m_head.load(std::memory_order_acquire);
+            if (tail - m_headCache > m_mask) return false;
+        }
+        m_slots[tail & m_mask] = std::move(value);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 仅消费者线程调用
+    bool TryPop(T& out) {
+        std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tailCache) {
+            m_tailCache = m_tail.load(std::memory_order_acquire);
+            if (head == m_tailCache) return false;
+        }
+        out = std::move(m_slots[head & m_mask]);
+        m_slots[head & m_mask] = T(); // 及时释放槽位持有的资源
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::size_t GetCapacity() const { return m_mask + 1; }
+
+private:
+    const std::size_t m_mask;
+    std::unique_ptr<T[]> m_slots;
+
+    alignas(RING_CACHE_LINE) std::atomic<std::size_t> m_head{ 0 };
+    std::size_t m_tailCache = 0; // 消费者缓存的 tail，减少跨核读取
+    alignas(RING_CACHE_LINE) std::atomic<std::size_t> m_tail{ 0 };
+    std::size_t m_headCache = 0; // 生产者缓存的 head
+
+    static std::size_t RoundUpPow2(std::size_t v) {
+        std::size_t p = 2;
+        while (p < v) p <<= 1;
+        return p;
+    }
+};
+
+/**
+ * @class MpmcRing
+ * @brief 有界无锁环形队列 (多生产者 / 多消费者，Vyukov 序号槽位)
+ * @details
+ *   - 每个槽位带序号，生产者/消费者各用一次 CAS 抢占位置，不使用互斥锁
+ *   - 线程池中用作单生产者 (主线程) / 多消费者 (所属线程 + 窃取线程) 的任务队列
+ */
+template <typename T>
+class MpmcRing {
+public:
+    explicit MpmcRing(std::size_t capacity)
+        : m_mask(RoundUpPow2(capacity) - 1), m_cells(new Cell[m_mask + 1])
+    {
+        for (std::size_t i = 0; i <= m_mask; ++i) m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    MpmcRing(const MpmcRing&) = delete;
+    MpmcRing& operator=(const MpmcRing&) = delete;
+
+    bool TryPush(T&& value) {
+        std::size_t pos = m_tail.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = m_cells[pos & m_mask];
+            std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // 满
+            } else {
+                pos = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool TryPop(T& out) {
+        std::size_t pos = m_head.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = m_cells[pos & m_mask];
+            std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0) {
+                if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    out = std::move(cell.value);
+                    cell.value = T();
+                    cell.sequence.store(pos + m_mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // 空
+            } else {
+                pos = m_head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // 近似值 (并发修改时可能过期)，仅用于统计和判断是否有任务
+    bool IsEmptyApprox() const {
+        return m_head.load(std::memory_order_relaxed) == m_tail.load(std::memory_order_relaxed);
+    }
+
+    std::size_t GetCapacity() const { return m_mask + 1; }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence{ 0 };
+        T value;
+    };
+
+    const std::size_t m_mask;
+    std::unique_ptr<Cell[]> m_cells;
+
+    alignas(RING_CACHE_LINE) std::atomic<std::size_t> m_head{ 0 };
+    alignas(RING_CACHE_LINE) std::atomic<std::size_t> m_tail{ 0 };
+
+    static std::size_t RoundUpPow2(std::size_t v) {
+        std::size_t p = 2;
+        while (p < v) p <<= 1;
+        return p;
+    }
+};
@@ -0,0 +1,78 @@
+#include "LockWaitStats.h"
+#include <chrono>
+
+namespace {
+
+thread_local bool t_isFrameThread = false;
+
+LockWaitHistogram g_frameThreadWaits;
+LockWaitHistogram g_backgroundWaits;
+
+} // namespace
+
+const char* const LockWaitHistogram::BUCKET_LABELS[BUCKET_COUNT] = {
+    "none", "<10us", "<100us", "<1ms", "<10ms", ">=10ms"
+};
+
+void LockWaitHistogram::RecordWait(double waitNs)
+{
+    int bucket = 1;
+    double limit = 10000.0; // 10us
+    while (bucket < BUCKET_COUNT - 1 && waitNs >= limit) {
+        bucket++;
+        limit *= 10.0;
+    }
+    m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+std::array<std::size_t, LockWaitHistogram::BUCKET_COUNT> LockWaitHistogram::Snapshot() const
+{
+    std::array<std::size_t, BUCKET_COUNT> counts{};
+    for (int i = 0; i < BUCKET_COUNT; ++i) counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+    return counts;
+}
+
+std::size_t LockWaitHistogram::GetWaitCount() const
+{
+    std::size_t waits = 0;
+    for (int i = 1; i < BUCKET_COUNT; ++i) waits += m_buckets[i].load(std::memory_order_relaxed);
+    return waits;
+}
+
+void LockWaitHistogram::MarkFrameThread()
+{
+    t_isFrameThread = true;
+}
+
+bool LockWaitHistogram::IsFrameThread()
+{
+    return t_isFrameThread;
+}
+
+LockWaitHistogram& LockWaitHistogram::ForCurrentThread()
+{
+    return t_isFrameThread ? g_frameThreadWaits : g_backgroundWaits;
+}
+
+LockWaitHistogram& LockWaitHistogram::FrameThread()
+{
+    return g_frameThreadWaits;
+}
+
+LockWaitHistogram& LockWaitHistogram::Background()
+{
+    return g_backgroundWaits;
+}
+
+TimedLockGuard::TimedLockGuard(std::mutex& mutex)
+    : m_mutex(mutex)
+{
+    LockWaitHistogram& histogram = LockWaitHistogram::ForCurrentThread();
+    if (m_mutex.try_lock()) {
+        histogram.RecordUncontended();
+        return;
+    }
+    auto start = std::chrono::steady_clock::now();
+    m_mutex.lock();
+    histogram.RecordWait(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+}
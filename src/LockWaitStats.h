@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+
+/**
+ * @class LockWaitHistogram
+ * @brief 加锁等待时间直方图
+ * @details
+ *   - 桶 0 为无需等待 (try_lock 直接成功)，其余按等待时长分为 <10us, <100us, <1ms, <10ms, >=10ms
+ *   - 全局两份：帧线程 (主线程) 与其他线程，由调用线程自动选择
+ *   - 计数为原子变量，可在任意线程记录
+ */
+class LockWaitHistogram {
+public:
+    static constexpr int BUCKET_COUNT = 6;
+    static const char* const BUCKET_LABELS[BUCKET_COUNT];
+
+    void RecordUncontended() { m_buckets[0].fetch_add(1, std::memory_order_relaxed); }
+    void RecordWait(double waitNs);
+
+    std::array<std::size_t, BUCKET_COUNT> Snapshot() const;
+    std::size_t GetWaitCount() const; // 发生等待的次数 (不含桶 0)
+
+    // 把当前线程标记为帧线程 (主线程启动时调用一次)
+    static void MarkFrameThread();
+    static bool IsFrameThread();
+
+    // 当前线程对应的直方图
+    static LockWaitHistogram& ForCurrentThread();
+    static LockWaitHistogram& FrameThread();
+    static LockWaitHistogram& Background();
+
+private:
+    std::array<std::atomic<std::size_t>, BUCKET_COUNT> m_buckets{};
+};
+
+/**
+ * @class TimedLockGuard
+ * @brief 带等待统计的 lock_guard：先 try_lock，失败时计时阻塞并记录到直方图
+ */
+class TimedLockGuard {
+public:
+    explicit TimedLockGuard(std::mutex& mutex);
+    ~TimedLockGuard() { m_mutex.unlock(); }
+
+    TimedLockGuard(const TimedLockGuard&) = delete;
+    TimedLockGuard& operator=(const TimedLockGuard&) = delete;
+
+private:
+    std::mutex& m_mutex;
+};
@@ -0,0 +1,220 @@
+#include "PerfHud.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+constexpr float MARGIN = 8.0f;      // 面板距窗口边缘 (像素)
+constexpr float PADDING = 6.0f;     // 面板内边距
+constexpr float FONT_PIXEL = 2.0f;  // 点阵字体一个点的边长
+constexpr float GLYPH_ADVANCE = 4.0f * FONT_PIXEL;
+constexpr float LINE_HEIGHT = 7.0f * FONT_PIXEL;
+constexpr float GRAPH_HEIGHT = 60.0f;
+constexpr int TEXT_LINES = 6;
+
+constexpr std::uint32_t COLOR_PANEL = 0x000000A0;
+constexpr std::uint32_t COLOR_TEXT = 0xF0F0F0FF;
+constexpr std::uint32_t COLOR_GUIDE = 0xFFFFFF60;
+constexpr std::uint32_t COLOR_FAST = 0x40D040FF;  // < 16.7ms
+constexpr std::uint32_t COLOR_SLOW = 0xE0C030FF;  // < 33.3ms
+constexpr std::uint32_t COLOR_HITCH = 0xE04030FF;
+
+// 3x5 点阵：每行 3 位，高位在左
+const std::uint8_t* GlyphRows(char c)
+{
+    static const std::uint8_t BLANK[5] = { 0, 0, 0, 0, 0 };
+    static const std::uint8_t DIGITS[10][5] = {
+        { 7, 5, 5, 5, 7 }, { 2, 6, 2, 2, 7 }, { 7, 1, 7, 4, 7 }, { 7, 1, 7, 1, 7 }, { 5, 5, 7, 1, 1 },
+        { 7, 4, 7, 1, 7 }, { 7, 4, 7, 5, 7 }, { 7, 1, 1, 1, 1 }, { 7, 5, 7, 5, 7 }, { 7, 5, 7, 1, 7 },
+    };
+    static const std::uint8_t LETTERS[26][5] = {
+        { 2, 5, 7, 5, 5 }, // A
+        { 6, 5, 6, 5, 6 }, // B
+        { 3, 4, 4, 4, 3 }, // C
+        { 6, 5, 5, 5, 6 }, // D
+        { 7, 4, 6, 4, 7 }, // E
+        { 7, 4, 6, 4, 4 }, // F
+        { 3, 4, 5, 5, 3 }, // G
+        { 5, 5, 7, 5, 5 }, // H
+        { 7, 2, 2, 2, 7 }, // I
+        { 1, 1, 1, 5, 2 }, // J
+        { 5, 5, 6, 5, 5 }, // K
+        { 4, 4, 4, 4, 7 }, // L
+        { 5, 7, 7, 5, 5 }, // M
+        { 6, 5, 5, 5, 5 }, // N
+        { 2, 5, 5, 5, 2 }, // O
+        { 6, 5, 6, 4, 4 }, // P
+        { 2, 5, 5, 7, 3 }, // Q
+        { 6, 5, 6, 5, 5 }, // R
+        { 3, 4, 2, 1, 6 }, // S
+        { 7, 2, 2, 2, 2 }, // T
+        { 5, 5, 5, 5, 7 }, // U
+        { 5, 5, 5, 5, 2 }, // V
+        { 5, 5, 7, 7, 5 }, // W
+        { 5, 5, 2, 5, 5 }, // X
+        { 5, 5, 2, 2, 2 }, // Y
+        { 7, 1, 2, 4, 7 }, // Z
+    };
+    static const std::uint8_t DOT[5] = { 0, 0, 0, 0, 2 };
+    static const std::uint8_t SLASH[5] = { 1, 1, 2, 4, 4 };
+    static const std::uint8_t DASH[5] = { 0, 0, 7, 0, 0 };
+    static const std::uint8_t COLON[5] = { 0, 2, 0, 2, 0 };
+
+    if (c >= '0' && c <= '9') return DIGITS[c - '0'];
+    if (c >= 'A' && c <= 'Z') return LETTERS[c - 'A'];
+    if (c >= 'a' && c <= 'z') return LETTERS[c - 'a'];
+    switch (c) {
+    case '.': return DOT;
+    case '/': return SLASH;
+    case '-': return DASH;
+    case ':': return COLON;
+    default: return BLANK;
+    }
+}
+
+std::string Format(const char* format, double a, double b = 0.0, double c = 0.0)
+{
+    char buffer[96];
+    std::snprintf(buffer, sizeof(buffer), format, a, b, c);
+    return buffer;
+}
+
+} // namespace
+
+PerfHud::PerfHud()
+    : m_shader("shaders/hud.vert", "shaders/hud.frag")
+{
+    glGenVertexArrays(1, &m_VAO);
+    glGenBuffers(1, &m_VBO);
+
+    glBindVertexArray(m_VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+    // Layout 0: NDC 位置, 1: 颜色 (无符号字节归一化)
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(HudVertex), (void*)offsetof(HudVertex, x));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(HudVertex), (void*)offsetof(HudVertex, r));
+    glEnableVertexAttribArray(1);
+    glBindVertexArray(0);
+}
+
+PerfHud::~PerfHud()
+{
+    glDeleteBuffers(1, &m_VBO);
+    glDeleteVertexArrays(1, &m_VAO);
+    glDeleteProgram(m_shader.ID);
+}
+
+void PerfHud::RecordFrame(float frameMs)
+{
+    m_frameMs[m_frameCursor] = frameMs;
+    m_frameCursor = (m_frameCursor + 1) % HISTORY;
+    m_frameCount = std::min(m_frameCount + 1, HISTORY);
+}
+
+void PerfHud::Draw(const PerfHudCounters& counters, int windowWidth, int windowHeight)
+{
+    if (!m_visible || windowWidth <= 0 || windowHeight <= 0) return;
+
+    m_vertices.clear();
+    m_scaleX = 2.0f / static_cast<float>(windowWidth);
+    m_scaleY = 2.0f / static_cast<float>(windowHeight);
+
+    // 帧时间统计：从最新一帧往回数
+    auto frameAt = [&](int age) { return m_frameMs[(m_frameCursor - 1 - age + HISTORY) % HISTORY]; };
+    const int averageFrames = std::min(m_frameCount, FPS_AVERAGE_FRAMES);
+    float averageMs = 0.0f;
+    for (int i = 0; i < averageFrames; ++i) averageMs += frameAt(i);
+    averageMs = averageFrames > 0 ? averageMs / static_cast<float>(averageFrames) : 0.0f;
+    float maxMs = 0.0f;
+    for (int i = 0; i < m_frameCount; ++i) maxMs = std::max(maxMs, frameAt(i));
+    const float fps = averageMs > 0.0f ? 1000.0f / averageMs : 0.0f;
+
+    const float panelWidth = static_cast<float>(HISTORY) + 2.0f * PADDING;
+    const float panelHeight = 2.0f * PADDING + TEXT_LINES * LINE_HEIGHT + GRAPH_HEIGHT;
+    AddRect(MARGIN, MARGIN, panelWidth, panelHeight, COLOR_PANEL);
+
+    // 计数
+    const float textX = MARGIN + PADDING;
+    float textY = MARGIN + PADDING;
+    AddText(textX, textY, Format("FPS %.1f  MS %.2f  MAX %.1f", fps, averageMs, maxMs), COLOR_TEXT);
+    textY += LINE_HEIGHT;
+    AddText(textX, textY, Format("DRAWN %.0f", static_cast<double>(counters.drawnInstances)), COLOR_TEXT);
+    textY += LINE_HEIGHT;
+    AddText(textX, textY, Format("CHUNKS %.0f", static_cast<double>(counters.loadedChunks)), COLOR_TEXT);
+    textY += LINE_HEIGHT;
+    AddText(textX, textY, Format("QUEUED %.0f  IN FLIGHT %.0f", static_cast<double>(counters.queuedRequests),
+                                 static_cast<double>(counters.inFlightRequests)), COLOR_TEXT);
+    textY += LINE_HEIGHT;
+    AddText(textX, textY, Format("ENEMIES %.0f  TRAILS %.0f", static_cast<double>(counters.activeEnemies),
+                                 static_cast<double>(counters.bulletTrails)), COLOR_TEXT);
+    textY += LINE_HEIGHT;
+    AddText(textX, textY, Format("UPLOAD %.1f KB", static_cast<double>(counters.uploadBytes) / 1024.0), COLOR_TEXT);
+
+    // 帧时间柱状图：最新一帧在最右侧
+    const float graphX = textX;
+    const float graphBottom = MARGIN + panelHeight - PADDING;
+    const float pixelsPerMs = GRAPH_HEIGHT / GRAPH_MAX_MS;
+    for (int age = 0; age < m_frameCount; ++age) {
+        float ms = frameAt(age);
+        float h = std::min(ms, GRAPH_MAX_MS) * pixelsPerMs;
+        std::uint32_t color = ms < 16.7f ? COLOR_FAST : (ms < 33.3f ? COLOR_SLOW : COLOR_HITCH);
+        AddRect(graphX + static_cast<float>(HISTORY - 1 - age), graphBottom - h, 1.0f, h, color);
+    }
+    // 60 / 30 FPS 参考线
+    AddRect(graphX, graphBottom - 16.7f * pixelsPerMs, static_cast<float>(HISTORY), 1.0f, COLOR_GUIDE);
+    AddRect(graphX, graphBottom - GRAPH_HEIGHT, static_cast<float>(HISTORY), 1.0f, COLOR_GUIDE);
+
+    // 一次上传、一次绘制
+    const std::size_t bytes = m_vertices.size() * sizeof(HudVertex);
+    glBindVertexArray(m_VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+    if (bytes > m_capacityBytes) {
+        m_capacityBytes = std::max(bytes, m_capacityBytes * 2);
+        glBufferData(GL_ARRAY_BUFFER, m_capacityBytes, nullptr, GL_STREAM_DRAW);
+    }
+    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, m_vertices.data());
+
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    m_shader.use();
+    glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(m_vertices.size()));
+    glDisable(GL_BLEND);
+    glEnable(GL_DEPTH_TEST);
+    glBindVertexArray(0);
+}
+
+void PerfHud::AddRect(float x, float y, float w, float h, std::uint32_t rgba)
+{
+    if (w <= 0.0f || h <= 0.0f) return;
+    const float x0 = x * m_scaleX - 1.0f;
+    const float x1 = (x + w) * m_scaleX - 1.0f;
+    const float y0 = 1.0f - y * m_scaleY;
+    const float y1 = 1.0f - (y + h) * m_scaleY;
+    const auto r = static_cast<std::uint8_t>(rgba >> 24);
+    const auto g = static_cast<std::uint8_t>(rgba >> 16);
+    const auto b = static_cast<std::uint8_t>(rgba >> 8);
+    const auto a = static_cast<std::uint8_t>(rgba);
+    m_vertices.push_back({ x0, y0, r, g, b, a });
+    m_vertices.push_back({ x0, y1, r, g, b, a });
+    m_vertices.push_back({ x1, y1, r, g, b, a });
+    m_vertices.push_back({ x0, y0, r, g, b, a });
+    m_vertices.push_back({ x1, y1, r, g, b, a });
+    m_vertices.push_back({ x1, y0, r, g, b, a });
+}
+
+float PerfHud::AddText(float x, float y, const std::string& text, std::uint32_t rgba)
+{
+    for (char c : text) {
+        const std::uint8_t* rows = GlyphRows(c);
+        for (int row = 0; row < 5; ++row) {
+            for (int col = 0; col < 3; ++col) {
+                if (rows[row] & (4 >> col)) {
+                    AddRect(x + col * FONT_PIXEL, y + row * FONT_PIXEL, FONT_PIXEL, FONT_PIXEL, rgba);
+                }
+            }
+        }
+        x += GLYPH_ADVANCE;
+    }
+    return x;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Shader.h"
+#include <glad/glad.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// HUD 每帧显示的计数 (由调用方在绘制前汇总)
+struct PerfHudCounters {
+    std::size_t drawnInstances = 0;   // 本帧提交的实例/四边形 (地形 + 敌人)
+    std::size_t loadedChunks = 0;
+    std::size_t queuedRequests = 0;   // 等待调度的区块请求
+    std::size_t inFlightRequests = 0; // 已交给工作线程的区块请求
+    std::size_t activeEnemies = 0;
+    std::size_t bulletTrails = 0;
+    std::size_t uploadBytes = 0;      // 本帧上传到 GPU 的顶点/实例数据
+};
+
+/**
+ * @class PerfHud
+ * @brief 游戏内性能 HUD (F3 切换)
+ * @details
+ *   - 左上角：最近 HISTORY 帧的帧时间柱状图 (16.7ms / 33.3ms 参考线) 与各项计数
+ *   - 文字使用内置 3x5 点阵字体，每个亮点一个矩形
+ *   - 背景、柱状图、参考线与文字全部写入同一个顶点数组，每帧一次上传、一次绘制调用
+ *   - 需要 GL 上下文：在上下文创建后构造、销毁前析构
+ */
+class PerfHud {
+public:
+    static constexpr int HISTORY = 240;          // 柱状图帧数 (每帧 1 像素宽)
+    static constexpr int FPS_AVERAGE_FRAMES = 60; // FPS 取最近若干帧的平均
+    static constexpr float GRAPH_MAX_MS = 33.3f;  // 柱状图满高对应的帧时间
+
+    PerfHud();
+    ~PerfHud();
+
+    PerfHud(const PerfHud&) = delete;
+    PerfHud& operator=(const PerfHud&) = delete;
+
+    void Toggle() { m_visible = !m_visible; }
+    bool IsVisible() const { return m_visible; }
+
+    // 隐藏时也记录，显示时即有完整历史
+    void RecordFrame(float frameMs);
+
+    void Draw(const PerfHudCounters& counters, int windowWidth, int windowHeight);
+
+private:
+    struct HudVertex {
+        float x, y;             // NDC
+        std::uint8_t r, g, b, a;
+    };
+
+    Shader m_shader;
+    GLuint m_VAO = 0;
+    GLuint m_VBO = 0;
+    std::size_t m_capacityBytes = 0;
+    bool m_visible = false;
+
+    std::array<float, HISTORY> m_frameMs{};
+    int m_frameCursor = 0; // 下一次写入的位置
+    int m_frameCount = 0;
+
+    std::vector<HudVertex> m_vertices;
+    float m_scaleX = 0.0f, m_scaleY = 0.0f; // 像素 -> NDC
+
+    // 像素坐标，原点在窗口左上角
+    void AddRect(float x, float y, float w, float h, std::uint32_t rgba);
+    // 返回文字结束处的 x
+    float AddText(float x, float y, const std::string& text, std::uint32_t rgba);
+};
@@ -0,0 +1,280 @@
+#include "Perlin2D.h"
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#define PERLIN_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// GCC/Clang 需要为 AVX2 内核单独开启指令集；MSVC 可以直接使用内建函数
+#if defined(PERLIN_X86) && (defined(__GNUC__) || defined(__clang__))
+#define PERLIN_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define PERLIN_TARGET_AVX2
+#endif
+
+// 注意：SIMD 内核逐条复现标量代码的乘加顺序 (不使用 FMA)，
+// 因此只要标量路径也不被编译器融合为 FMA，两者结果逐位一致。
+
+namespace {
+
+#ifdef PERLIN_X86
+
+// ------------------------------ SSE2 (4 路) ---------------------------------
+
+inline __m128 Fade4(__m128 t)
+{
+    __m128 inner = _mm_add_ps(_mm_mul_ps(t, _mm_sub_ps(_mm_mul_ps(t, _mm_set1_ps(6.f)), _mm_set1_ps(15.f))),
+                              _mm_set1_ps(10.f));
+    return _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(t, t), t), inner);
+}
+
+inline __m128 Lerp4(__m128 a, __m128 b, __m128 t)
+{
+    return _mm_add_ps(a, _mm_mul_ps(t, _mm_sub_ps(b, a)));
+}
+
+inline __m128 Select4(__m128 mask, __m128 a, __m128 b)
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+// 无分支的 grad2：h<4 时为 (±x)+(±y)，否则为 ±x 或 ±y
+inline __m128 Grad4(__m128i hash, __m128 x, __m128 y)
+{
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    __m128 m1 = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(hash, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+    __m128 m2 = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(hash, _mm_set1_epi32(2)), _mm_set1_epi32(2)));
+    __m128 m4 = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(hash, _mm_set1_epi32(4)), _mm_set1_epi32(4)));
+
+    __m128 pair = _mm_add_ps(_mm_xor_ps(x, _mm_and_ps(m1, sign)), _mm_xor_ps(y, _mm_and_ps(m2, sign)));
+    __m128 single = _mm_xor_ps(Select4(m2, y, x), _mm_and_ps(m1, sign));
+    return Select4(m4, single, pair);
+}
+
+// SSE2 没有 floor 指令：截断后对负数修正
+inline void Floor4(__m128 v, __m128& outFloor, __m128i& outInt)
+{
+    __m128i ti = _mm_cvttps_epi32(v);
+    __m128 t = _mm_cvtepi32_ps(ti);
+    __m128 mask = _mm_cmpgt_ps(t, v);
+    outFloor = _mm_sub_ps(t, _mm_and_ps(mask, _mm_set1_ps(1.0f)));
+    outInt = _mm_add_epi32(ti, _mm_castps_si128(mask)); // mask 为 -1
+}
+
+__m128 Noise4(const Perlin2D& perlin, __m128 x, __m128 y)
+{
+    __m128 fx, fy;
+    __m128i ix, iy;
+    Floor4(x, fx, ix);
+    Floor4(y, fy, iy);
+    ix = _mm_and_si128(ix, _mm_set1_epi32(255));
+    iy = _mm_and_si128(iy, _mm_set1_epi32(255));
+
+    __m128 xf = _mm_sub_ps(x, fx);
+    __m128 yf = _mm_sub_ps(y, fy);
+    __m128 u = Fade4(xf);
+    __m128 v = Fade4(yf);
+
+    alignas(16) std::int32_t X[4], Y[4], aa[4], ab[4], ba[4], bb[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(X), ix);
+    _mm_store_si128(reinterpret_cast<__m128i*>(Y), iy);
+    for (int i = 0; i < 4; ++i) {
+        int px = perlin.p[X[i]];
+        int px1 = perlin.p[X[i] + 1];
+        aa[i] = perlin.p[px + Y[i]];
+        ab[i] = perlin.p[px + Y[i] + 1];
+        ba[i] = perlin.p[px1 + Y[i]];
+        bb[i] = perlin.p[px1 + Y[i] + 1];
+    }
+
+    const __m128 one = _mm_set1_ps(1.f);
+    __m128 xf1 = _mm_sub_ps(xf, one);
+    __m128 yf1 = _mm_sub_ps(yf, one);
+
+    __m128 x1 = Lerp4(Grad4(_mm_load_si128(reinterpret_cast<const __m128i*>(aa)), xf, yf),
+                      Grad4(_mm_load_si128(reinterpret_cast<const __m128i*>(ba)), xf1, yf), u);
+    __m128 x2 = Lerp4(Grad4(_mm_load_si128(reinterpret_cast<const __m128i*>(ab)), xf, yf1),
+                      Grad4(_mm_load_si128(reinterpret_cast<const __m128i*>(bb)), xf1, yf1), u);
+    return Lerp4(x1, x2, v);
+}
+
+std::size_t FbmSSE2(const Perlin2D& perlin, const float* xs, const float* ys, float* out, std::size_t n,
+                    int octaves, float lacunarity, float gain)
+{
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 x = _mm_loadu_ps(xs + i);
+        __m128 y = _mm_loadu_ps(ys + i);
+        __m128 sum = _mm_setzero_ps();
+        float amp = 1.0f;
+        float freq = 1.0f;
+        float maxSum = 0.0f;
+        for (int o = 0; o < octaves; ++o) {
+            __m128 f = _mm_set1_ps(freq);
+            __m128 nv = Noise4(perlin, _mm_mul_ps(x, f), _mm_mul_ps(y, f));
+            sum = _mm_add_ps(sum, _mm_mul_ps(nv, _mm_set1_ps(amp)));
+            maxSum += amp;
+            freq *= lacunarity;
+            amp  *= gain;
+        }
+        __m128 r = _mm_mul_ps(_mm_set1_ps(0.5f), _mm_add_ps(_mm_div_ps(sum, _mm_set1_ps(maxSum)), _mm_set1_ps(1.0f)));
+        _mm_storeu_ps(out + i, r);
+    }
+    return i;
+}
+
+// ------------------------------ AVX2 (8 路) ---------------------------------
+
+PERLIN_TARGET_AVX2 inline __m256 Fade8(__m256 t)
+{
+    __m256 inner = _mm256_add_ps(_mm256_mul_ps(t, _mm256_sub_ps(_mm256_mul_ps(t, _mm256_set1_ps(6.f)), _mm256_set1_ps(15.f))),
+                                 _mm256_set1_ps(10.f));
+    return _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(t, t), t), inner);
+}
+
+PERLIN_TARGET_AVX2 inline __m256 Lerp8(__m256 a, __m256 b, __m256 t)
+{
+    return _mm256_add_ps(a, _mm256_mul_ps(t, _mm256_sub_ps(b, a)));
+}
+
+PERLIN_TARGET_AVX2 inline __m256 Grad8(__m256i hash, __m256 x, __m256 y)
+{
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    __m256 m1 = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(hash, _mm256_set1_epi32(1)), _mm256_set1_epi32(1)));
+    __m256 m2 = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(hash, _mm256_set1_epi32(2)), _mm256_set1_epi32(2)));
+    __m256 m4 = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(hash, _mm256_set1_epi32(4)), _mm256_set1_epi32(4)));
+
+    __m256 pair = _mm256_add_ps(_mm256_xor_ps(x, _mm256_and_ps(m1, sign)), _mm256_xor_ps(y, _mm256_and_ps(m2, sign)));
+    __m256 single = _mm256_xor_ps(_mm256_blendv_ps(x, y, m2), _mm256_and_ps(m1, sign));
+    return _mm256_blendv_ps(pair, single, m4);
+}
+
+PERLIN_TARGET_AVX2 __m256 Noise8(const Perlin2D& perlin, __m256 x, __m256 y)
+{
+    __m256 fx = _mm256_floor_ps(x);
+    __m256 fy = _mm256_floor_ps(y);
+    const __m256i mask255 = _mm256_set1_epi32(255);
+    const __m256i one_i = _mm256_set1_epi32(1);
+    __m256i X = _mm256_and_si256(_mm256_cvttps_epi32(fx), mask255);
+    __m256i Y = _mm256_and_si256(_mm256_cvttps_epi32(fy), mask255);
+
+    __m256 xf = _mm256_sub_ps(x, fx);
+    __m256 yf = _mm256_sub_ps(y, fy);
+    __m256 u = Fade8(xf);
+    __m256 v = Fade8(yf);
+
+    const int* table = perlin.p32;
+    __m256i px = _mm256_i32gather_epi32(table, X, 4);
+    __m256i px1 = _mm256_i32gather_epi32(table, _mm256_add_epi32(X, one_i), 4);
+    __m256i pxY = _mm256_add_epi32(px, Y);
+    __m256i px1Y = _mm256_add_epi32(px1, Y);
+    __m256i aa = _mm256_i32gather_epi32(table, pxY, 4);
+    __m256i ab = _mm256_i32gather_epi32(table, _mm256_add_epi32(pxY, one_i), 4);
+    __m256i ba = _mm256_i32gather_epi32(table, px1Y, 4);
+    __m256i bb = _mm256_i32gather_epi32(table, _mm256_add_epi32(px1Y, one_i), 4);
+
+    const __m256 one = _mm256_set1_ps(1.f);
+    __m256 xf1 = _mm256_sub_ps(xf, one);
+    __m256 yf1 = _mm256_sub_ps(yf, one);
+
+    __m256 x1 = Lerp8(Grad8(aa, xf, yf), Grad8(ba, xf1, yf), u);
+    __m256 x2 = Lerp8(Grad8(ab, xf, yf1), Grad8(bb, xf1, yf1), u);
+    return Lerp8(x1, x2, v);
+}
+
+PERLIN_TARGET_AVX2 std::size_t FbmAVX2(const Perlin2D& perlin, const float* xs, const float* ys, float* out,
+                                       std::size_t n, int octaves, float lacunarity, float gain)
+{
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 x = _mm256_loadu_ps(xs + i);
+        __m256 y = _mm256_loadu_ps(ys + i);
+        __m256 sum = _mm256_setzero_ps();
+        float amp = 1.0f;
+        float freq = 1.0f;
+        float maxSum = 0.0f;
+        for (int o = 0; o < octaves; ++o) {
+            __m256 f = _mm256_set1_ps(freq);
+            __m256 nv = Noise8(perlin, _mm256_mul_ps(x, f), _mm256_mul_ps(y, f));
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(nv, _mm256_set1_ps(amp)));
+            maxSum += amp;
+            freq *= lacunarity;
+            amp  *= gain;
+        }
+        __m256 r = _mm256_mul_ps(_mm256_set1_ps(0.5f),
+                                 _mm256_add_ps(_mm256_div_ps(sum, _mm256_set1_ps(maxSum)), _mm256_set1_ps(1.0f)));
+        _mm256_storeu_ps(out + i, r);
+    }
+    return i;
+}
+
+bool CpuSupportsAVX2()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx) return false;
+    if ((_xgetbv(0) & 0x6) != 0x6) return false; // 操作系统需保存 YMM 寄存器
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+#endif // PERLIN_X86
+
+Perlin2D::BatchPath DetectBatchPath()
+{
+#ifdef PERLIN_X86
+    if (CpuSupportsAVX2()) return Perlin2D::BatchPath::AVX2;
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    return Perlin2D::BatchPath::SSE2;
+#endif
+#endif
+    return Perlin2D::BatchPath::Scalar;
+}
+
+} // namespace
+
+Perlin2D::BatchPath Perlin2D::GetBatchPath()
+{
+    static const BatchPath path = DetectBatchPath();
+    return path;
+}
+
+void Perlin2D::fbmBatchScalar(const float* xs, const float* ys, float* out, std::size_t n,
+                              int octaves, float lacunarity, float gain) const
+{
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = fbm(xs[i], ys[i], octaves, lacunarity, gain);
+    }
+}
+
+void Perlin2D::fbmBatch(const float* xs, const float* ys, float* out, std::size_t n,
+                        int octaves, float lacunarity, float gain) const
+{
+    std::size_t done = 0;
+#ifdef PERLIN_X86
+    switch (GetBatchPath()) {
+        case BatchPath::AVX2:
+            done = FbmAVX2(*this, xs, ys, out, n, octaves, lacunarity, gain);
+            break;
+        case BatchPath::SSE2:
+            done = FbmSSE2(*this, xs, ys, out, n, octaves, lacunarity, gain);
+            break;
+        default:
+            break;
+    }
+#endif
+    // 尾部不足一组的样本走标量路径
+    fbmBatchScalar(xs + done, ys + done, out + done, n - done, octaves, lacunarity, gain);
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// ------------------------- Perlin Noise 2D ----------------------------------
+struct Perlin2D {
+    std::uint8_t p[512];
+    std::int32_t p32[512]; // 同一置换表的 32 位副本，供 AVX2 gather 使用
+
+    explicit Perlin2D(std::uint32_t seed = 1337u) {
+        // Simple LCG to shuffle permutation deterministically by seed.
+        std::uint8_t perm[256];
+        for (int i = 0; i < 256; ++i) perm[i] = static_cast<std::uint8_t>(i);
+
+        auto lcg = [s = seed]() mutable -> std::uint32_t {
+            s = s * 1664525u + 1013904223u;
+            return s;
+        };
+
+        for (int i = 255; i > 0; --i) {
+            int j = static_cast<int>(lcg() % (i + 1));
+            std::uint8_t tmp = perm[i];
+            perm[i] = perm[j];
+            perm[j] = tmp;
+        }
+        for (int i = 0; i < 256; ++i) {
+            p[i] = perm[i];
+            p[i + 256] = perm[i];
+        }
+        for (int i = 0; i < 512; ++i) p32[i] = p[i];
+    }
+
+    static float fade(float t) {
+        return t * t * t * (t * (t * 6.f - 15.f) + 10.f); // 6t^5 - 15t^4 + 10t^3
+    }
+
+    static float lerp(float a, float b, float t) {
+        return a + t * (b - a);
+    }
+
+    static float grad2(int hash, float x, float y) {
+        // 8 gradient directions
+        switch (hash & 7) {
+            case 0: return  x + y;
+            case 1: return -x + y;
+            case 2: return  x - y;
+            case 3: return -x - y;
+            case 4: return  x;
+            case 5: return -x;
+            case 6: return  y;
+            default: return -y;
+        }
+    }
+
+    // 2D Perlin noise in [-1, 1]
+    float noise(float x, float y) const {
+        int X = static_cast<int>(std::floor(x)) & 255;
+        int Y = static_cast<int>(std::floor(y)) & 255;
+
+        float xf = x - std::floor(x);
+        float yf = y - std::floor(y);
+
+        float u = fade(xf);
+        float v = fade(yf);
+
+        int aa = p[p[X] + Y];
+        int ab = p[p[X] + Y + 1];
+        int ba = p[p[X + 1] + Y];
+        int bb = p[p[X + 1] + Y + 1];
+
+        float x1 = lerp(grad2(aa, xf,     yf    ),
+                        grad2(ba, xf-1.f, yf    ), u);
+        float x2 = lerp(grad2(ab, xf,     yf-1.f),
+                        grad2(bb, xf-1.f, yf-1.f), u);
+
+        return lerp(x1, x2, v); // [-1,1] ish
+    }
+
+    // Fractal Brownian Motion (FBM) using multiple octaves of 2D noise.
+    float fbm(float x, float y, int octaves = 5,
+              float lacunarity = 2.0f, float gain = 0.5f) const
+    {
+        float sum = 0.0f;
+        float amp = 1.0f;
+        float freq = 1.0f;
+        float maxSum = 0.0f;
+
+        for (int i = 0; i < octaves; ++i) {
+            sum += noise(x * freq, y * freq) * amp;
+            maxSum += amp;
+            freq *= lacunarity;
+            amp  *= gain;
+        }
+        // Normalize to [0,1]
+        return 0.5f * (sum / maxSum + 1.0f);
+    }
+
+    /**
+     * @brief 批量 FBM：out[i] = fbm(xs[i], ys[i], ...)
+     * @details 运行时选择 AVX2 (8 路) / SSE2 (4 路) / 标量实现。
+     *          各实现的运算顺序与 fbm() 完全相同，结果逐位一致。
+     */
+    void fbmBatch(const float* xs, const float* ys, float* out, std::size_t n,
+                  int octaves = 5, float lacunarity = 2.0f, float gain = 0.5f) const;
+
+    // 批量实现的种类，便于日志与基准对比
+    enum class BatchPath { Scalar, SSE2, AVX2 };
+    static BatchPath GetBatchPath();
+
+    // 强制使用标量路径 (用于对比与调试)
+    void fbmBatchScalar(const float* xs, const float* ys, float* out, std::size_t n,
+                        int octaves = 5, float lacunarity = 2.0f, float gain = 0.5f) const;
+};
@@ -0,0 +1,296 @@
+#include "Profiler.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct ProfileEvent {
+    const char* name = nullptr;
+    std::int64_t startNs = 0;
+    std::int64_t endNs = 0;
+    std::uint64_t frame = 0;
+};
+
+// 事件环：累计写入数 written，槽位 = written % 容量
+struct EventRing {
+    std::vector<ProfileEvent> events = std::vector<ProfileEvent>(Profiler::EVENTS_PER_THREAD);
+    std::size_t written = 0;
+
+    void Push(const ProfileEvent& e) {
+        events[written % events.size()] = e;
+        written++;
+    }
+};
+
+// 单个线程 (或 GPU 轨道) 的双缓冲事件环：所属线程无锁写入 rings[active]，
+// 导出时 (主线程) 切换 active，等所属线程写完正在写的那一条后读出旧环。
+// writing / active 的存取都是 seq_cst：写入方先置 writing 再读 active，导出方先改 active 再读 writing，
+// 两边至少有一方看到对方，保证导出方读旧环时写入方不会再写它
+struct ThreadBuffer {
+    std::mutex nameMutex; // 只保护线程名 (设置一次，导出时读取)
+    std::string name;
+    std::uint32_t tid = 0;
+    bool isGpu = false;
+    EventRing rings[2];
+    std::atomic<int> active{ 0 };
+    std::atomic<bool> writing{ false };
+    std::vector<ProfileEvent> history; // 以前导出时换出的事件 (仅导出方访问)
+
+    void Push(const ProfileEvent& e) {
+        writing.store(true);
+        rings[active.load()].Push(e);
+        writing.store(false);
+    }
+
+    // 仅导出方调用：换出当前事件环，把其中的事件并入 history 并去掉早于 minFrame 的事件
+    const std::vector<ProfileEvent>& Drain(std::uint64_t minFrame) {
+        const int old = active.load();
+        EventRing& spare = rings[old ^ 1];
+        spare.written = 0; // 上次导出已读完，所属线程此时不写它
+        active.store(old ^ 1);
+        while (writing.load()) std::this_thread::yield();
+
+        EventRing& ring = rings[old];
+        const std::size_t capacity = ring.events.size();
+        const std::size_t begin = ring.written > capacity ? ring.written - capacity : 0;
+        for (std::size_t i = begin; i < ring.written; ++i) history.push_back(ring.events[i % capacity]);
+        ring.written = 0;
+
+        history.erase(std::remove_if(history.begin(), history.end(),
+                                     [minFrame](const ProfileEvent& e) { return e.frame < minFrame; }),
+                      history.end());
+        if (history.size() > capacity) history.erase(history.begin(), history.end() - capacity);
+        return history;
+    }
+};
+
+const std::chrono::steady_clock::time_point g_epoch = std::chrono::steady_clock::now();
+std::atomic<std::uint64_t> g_frameIndex{ 0 };
+
+// 注册表：线程退出后事件仍保留到导出
+std::mutex g_registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> g_buffers;
+thread_local ThreadBuffer* t_buffer = nullptr;
+
+ThreadBuffer* RegisterBuffer(std::string name, bool isGpu)
+{
+    auto buffer = std::make_unique<ThreadBuffer>();
+    std::lock_guard<std::mutex> lk(g_registryMutex);
+    buffer->tid = static_cast<std::uint32_t>(g_buffers.size() + 1);
+    buffer->name = name.empty() ? "Thread " + std::to_string(buffer->tid) : std::move(name);
+    buffer->isGpu = isGpu;
+    g_buffers.push_back(std::move(buffer));
+    return g_buffers.back().get();
+}
+
+ThreadBuffer& CurrentBuffer()
+{
+    if (!t_buffer) t_buffer = RegisterBuffer(std::string(), false);
+    return *t_buffer;
+}
+
+// ==================== GPU 查询 (仅主线程) ====================
+
+constexpr std::size_t MAX_PENDING_QUERIES = 256; // 驱动迟迟不返回结果时停止发起新查询
+
+struct GpuQuery {
+    GLuint id = 0;
+    const char* name = nullptr;
+    std::int64_t cpuStartNs = 0;
+    std::uint64_t frame = 0;
+};
+
+bool g_gpuEnabled = false;
+bool g_gpuZoneOpen = false;
+GpuQuery g_openQuery;
+std::vector<GLuint> g_freeQueries;
+std::deque<GpuQuery> g_pendingQueries; // 按提交顺序，结果也按此顺序就绪
+ThreadBuffer* g_gpuBuffer = nullptr;
+std::int64_t g_gpuCursorNs = 0;        // GPU 轨道上最后一个事件的结束时间
+
+void CollectGpuQueries()
+{
+    while (!g_pendingQueries.empty()) {
+        GpuQuery& query = g_pendingQueries.front();
+        GLint available = 0;
+        glGetQueryObjectiv(query.id, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) break; // 后面的查询更晚提交，同样未就绪
+
+        GLuint64 elapsedNs = 0;
+        glGetQueryObjectui64v(query.id, GL_QUERY_RESULT, &elapsedNs);
+        // 只知道耗时：按提交时刻放在 GPU 轨道上，与前一个事件首尾相接不重叠
+        ProfileEvent e;
+        e.name = query.name;
+        e.startNs = std::max(query.cpuStartNs, g_gpuCursorNs);
+        e.endNs = e.startNs + static_cast<std::int64_t>(elapsedNs);
+        e.frame = query.frame;
+        g_gpuCursorNs = e.endNs;
+        g_gpuBuffer->Push(e);
+
+        g_freeQueries.push_back(query.id);
+        g_pendingQueries.pop_front();
+    }
+}
+
+void WriteJsonString(std::ostream& os, const std::string& s)
+{
+    os << '"';
+    for (char c : s) {
+        if (c == '"' || c == '\\') os << '\\';
+        os << c;
+    }
+    os << '"';
+}
+
+} // namespace
+
+namespace Profiler {
+
+std::int64_t NowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - g_epoch).count();
+}
+
+void BeginFrame()
+{
+    g_frameIndex.fetch_add(1, std::memory_order_relaxed);
+    if (g_gpuEnabled) CollectGpuQueries();
+}
+
+std::uint64_t GetFrameIndex()
+{
+    return g_frameIndex.load(std::memory_order_relaxed);
+}
+
+void SetThreadName(const char* name)
+{
+    ThreadBuffer& buffer = CurrentBuffer();
+    std::lock_guard<std::mutex> lk(buffer.nameMutex);
+    buffer.name = name;
+}
+
+void RecordCpuZone(const char* name, std::int64_t startNs, std::int64_t endNs)
+{
+    ProfileEvent e;
+    e.name = name;
+    e.startNs = startNs;
+    e.endNs = endNs;
+    e.frame = g_frameIndex.load(std::memory_order_relaxed);
+    CurrentBuffer().Push(e);
+}
+
+void SetGpuEnabled(bool enabled)
+{
+    if (enabled == g_gpuEnabled) return;
+    if (enabled) {
+        if (!g_gpuBuffer) g_gpuBuffer = RegisterBuffer("GPU", true);
+        g_gpuEnabled = true;
+        return;
+    }
+
+    // 上下文销毁前删除所有查询对象，未就绪的结果直接丢弃
+    for (const auto& query : g_pendingQueries) g_freeQueries.push_back(query.id);
+    if (g_gpuZoneOpen) {
+        glEndQuery(GL_TIME_ELAPSED);
+        g_freeQueries.push_back(g_openQuery.id);
+        g_gpuZoneOpen = false;
+    }
+    if (!g_freeQueries.empty()) glDeleteQueries(static_cast<GLsizei>(g_freeQueries.size()), g_freeQueries.data());
+    g_freeQueries.clear();
+    g_pendingQueries.clear();
+    g_gpuEnabled = false;
+}
+
+int BeginGpuZone(const char* name)
+{
+    if (!g_gpuEnabled || g_gpuZoneOpen || g_pendingQueries.size() >= MAX_PENDING_QUERIES) return -1;
+
+    GLuint id = 0;
+    if (g_freeQueries.empty()) {
+        glGenQueries(1, &id);
+    } else {
+        id = g_freeQueries.back();
+        g_freeQueries.pop_back();
+    }
+    glBeginQuery(GL_TIME_ELAPSED, id);
+    g_openQuery.id = id;
+    g_openQuery.name = name;
+    g_openQuery.cpuStartNs = NowNs();
+    g_openQuery.frame = GetFrameIndex();
+    g_gpuZoneOpen = true;
+    return 0;
+}
+
+void EndGpuZone(int handle)
+{
+    if (handle < 0 || !g_gpuZoneOpen) return;
+    glEndQuery(GL_TIME_ELAPSED);
+    g_pendingQueries.push_back(g_openQuery);
+    g_gpuZoneOpen = false;
+}
+
+bool WriteChromeTrace(const std::string& path)
+{
+    const std::uint64_t frame = GetFrameIndex();
+    const std::uint64_t minFrame = frame > FRAME_HISTORY ? frame - FRAME_HISTORY : 0;
+
+    std::ofstream os(path);
+    if (!os) {
+        std::cerr << "[Profiler] Cannot write trace to " << path << std::endl;
+        return false;
+    }
+
+    std::size_t eventCount = 0;
+    bool first = true;
+    auto separator = [&]() -> std::ostream& {
+        if (!first) os << ",\n";
+        first = false;
+        return os;
+    };
+
+    os << std::fixed << std::setprecision(3);
+    os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    std::lock_guard<std::mutex> registryLock(g_registryMutex);
+    for (const auto& buffer : g_buffers) {
+        std::string name;
+        {
+            std::lock_guard<std::mutex> lk(buffer->nameMutex);
+            name = buffer->name;
+        }
+        const std::vector<ProfileEvent>& events = buffer->Drain(minFrame);
+
+        separator() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid << ",\"args\":{\"name\":";
+        WriteJsonString(os, name);
+        os << "}}";
+        // GPU 轨道排在最后
+        separator() << "{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid
+                    << ",\"args\":{\"sort_index\":" << (buffer->isGpu ? 1000 : buffer->tid) << "}}";
+
+        for (const auto& e : events) {
+            separator() << "{\"name\":";
+            WriteJsonString(os, e.name);
+            os << ",\"cat\":\"" << (buffer->isGpu ? "gpu" : "cpu") << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid
+               << ",\"ts\":" << static_cast<double>(e.startNs) / 1000.0
+               << ",\"dur\":" << static_cast<double>(e.endNs - e.startNs) / 1000.0
+               << ",\"args\":{\"frame\":" << e.frame << "}}";
+            eventCount++;
+        }
+    }
+    os << "\n]}\n";
+
+    std::cout << "[Profiler] Wrote " << eventCount << " event(s) from the last " << (frame - minFrame)
+              << " frame(s) to " << path << std::endl;
+    return static_cast<bool>(os);
+}
+
+} // namespace Profiler
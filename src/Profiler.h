@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// 编译开关：PW_PROFILER_ENABLED 为 0 时区段宏全部展开为空语句 (CMake 只在 Debug / RelWithDebInfo 构建中默认打开)
+#ifndef PW_PROFILER_ENABLED
+#define PW_PROFILER_ENABLED 0
+#endif
+
+/**
+ * @namespace Profiler
+ * @brief 分层 CPU/GPU 帧分析器
+ * @details
+ *   - CPU 区段：每个线程一对事件环 (首次记录时注册)，记录时不加锁，导出时换出；嵌套作用域在时间线上即形成层级
+ *   - GPU 区段：GL_TIME_ELAPSED 查询，每帧开始时只回收已就绪的结果，从不等待 GPU；
+ *     查询不能嵌套，GPU 区段只用于平级的渲染阶段
+ *   - 保留最近 FRAME_HISTORY 帧，可导出为 Chrome trace_event JSON (chrome://tracing / Perfetto)
+ *   - 区段名必须是字符串字面量 (只保存指针)
+ */
+namespace Profiler {
+
+constexpr std::uint64_t FRAME_HISTORY = 120;     // 导出最近的帧数
+constexpr std::size_t EVENTS_PER_THREAD = 16384; // 每个事件环的容量
+
+// 是否编译了区段宏
+constexpr bool IsCompiledIn() { return PW_PROFILER_ENABLED != 0; }
+
+std::int64_t NowNs();
+
+// 主线程每帧开始时调用：推进帧号并回收已就绪的 GPU 查询
+void BeginFrame();
+std::uint64_t GetFrameIndex();
+
+// 在 trace 中显示的线程名 (复制字符串)
+void SetThreadName(const char* name);
+
+void RecordCpuZone(const char* name, std::int64_t startNs, std::int64_t endNs);
+
+// GPU 查询需要 GL 上下文：创建上下文后开启，销毁上下文前关闭 (会删除所有查询对象)
+void SetGpuEnabled(bool enabled);
+int BeginGpuZone(const char* name); // 返回 -1 表示本区段不计时
+void EndGpuZone(int handle);
+
+// 导出最近 FRAME_HISTORY 帧
+bool WriteChromeTrace(const std::string& path);
+
+} // namespace Profiler
+
+// CPU 作用域区段 (请通过 PW_PROFILE_ZONE 使用)
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* name) : m_name(name), m_start(Profiler::NowNs()) {}
+    ~ProfileZone() { Profiler::RecordCpuZone(m_name, m_start, Profiler::NowNs()); }
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char* m_name;
+    std::int64_t m_start;
+};
+
+// GPU 作用域区段 (请通过 PW_PROFILE_GPU_ZONE 使用，仅主线程)
+class GpuProfileZone {
+public:
+    explicit GpuProfileZone(const char* name) : m_handle(Profiler::BeginGpuZone(name)) {}
+    ~GpuProfileZone() { Profiler::EndGpuZone(m_handle); }
+
+    GpuProfileZone(const GpuProfileZone&) = delete;
+    GpuProfileZone& operator=(const GpuProfileZone&) = delete;
+
+private:
+    int m_handle;
+};
+
+#if PW_PROFILER_ENABLED
+#define PW_PROFILE_CONCAT_INNER(a, b) a##b
+#define PW_PROFILE_CONCAT(a, b) PW_PROFILE_CONCAT_INNER(a, b)
+#define PW_PROFILE_ZONE(name) ProfileZone PW_PROFILE_CONCAT(pwProfileZone, __LINE__)(name)
+#define PW_PROFILE_GPU_ZONE(name) GpuProfileZone PW_PROFILE_CONCAT(pwGpuProfileZone, __LINE__)(name)
+#define PW_PROFILE_FRAME() Profiler::BeginFrame()
+#define PW_PROFILE_THREAD(name) Profiler::SetThreadName(name)
+#else
+#define PW_PROFILE_ZONE(name) ((void)0)
+#define PW_PROFILE_GPU_ZONE(name) ((void)0)
+#define PW_PROFILE_FRAME() ((void)0)
+#define PW_PROFILE_THREAD(name) ((void)0)
+#endif
@@ -0,0 +1,413 @@
+#include "RegionCache.h"
+#include "LockWaitStats.h"
+#include "Profiler.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// 区域文件布局:
+//   [Header][Entry x 1024][区块数据 ...]
+//   区块数据: u32 heightCount, u32 blockCount, float heights[], RegionBlockRecord blocks[]
+constexpr char REGION_MAGIC[4] = { 'P', 'W', 'R', 'G' };
+constexpr std::uint32_t REGION_VERSION = 1;
+constexpr int REGION_CHUNKS = RegionCache::REGION_SIZE * RegionCache::REGION_SIZE;
+
+struct RegionHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t worldTag;
+    std::uint32_t reserved;
+};
+
+struct RegionEntry {
+    std::uint32_t offset; // 0 表示该区块不存在
+    std::uint32_t size;
+};
+
+constexpr std::size_t REGION_TABLE_BYTES = sizeof(RegionHeader) + sizeof(RegionEntry) * REGION_CHUNKS;
+
+// 覆盖写入留下的垃圾至少达到此大小、且多于有效数据时才压缩，避免频繁重写小文件
+constexpr std::uint64_t COMPACT_MIN_DEAD_BYTES = 256 * 1024;
+
+int FloorDiv(int value, int divisor)
+{
+    int q = value / divisor;
+    if ((value % divisor != 0) && ((value < 0) != (divisor < 0))) --q;
+    return q;
+}
+
+std::uint64_t PackKey(int x, int z)
+{
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32) | static_cast<std::uint32_t>(z);
+}
+
+std::vector<std::uint8_t> EncodeChunkPayload(const RegionChunkRecord& record)
+{
+    std::uint32_t counts[2] = { static_cast<std::uint32_t>(record.heights.size()),
+                                static_cast<std::uint32_t>(record.blocks.size()) };
+    std::size_t heightBytes = counts[0] * sizeof(float);
+    std::size_t blockBytes = counts[1] * sizeof(RegionBlockRecord);
+    std::vector<std::uint8_t> payload(sizeof(counts) + heightBytes + blockBytes);
+    std::memcpy(payload.data(), counts, sizeof(counts));
+    if (heightBytes > 0) std::memcpy(payload.data() + sizeof(counts), record.heights.data(), heightBytes);
+    if (blockBytes > 0) std::memcpy(payload.data() + sizeof(counts) + heightBytes, record.blocks.data(), blockBytes);
+    return payload;
+}
+
+} // namespace
+
+// 只读内存映射，析构时解除映射
+struct RegionCache::MappedFile {
+    const std::uint8_t* data = nullptr;
+    std::size_t size = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+
+    static std::shared_ptr<MappedFile> Open(const std::string& path)
+    {
+        auto mapped = std::make_shared<MappedFile>();
+#ifdef _WIN32
+        mapped->file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                   nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (mapped->file == INVALID_HANDLE_VALUE) return nullptr;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(mapped->file, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(REGION_TABLE_BYTES)) return nullptr;
+        mapped->mapping = CreateFileMappingA(mapped->file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapped->mapping) return nullptr;
+        mapped->data = static_cast<const std::uint8_t*>(MapViewOfFile(mapped->mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!mapped->data) return nullptr;
+        mapped->size = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) return nullptr;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(REGION_TABLE_BYTES)) {
+            close(fd);
+            return nullptr;
+        }
+        void* addr = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        close(fd); // 映射建立后即可关闭文件描述符
+        if (addr == MAP_FAILED) return nullptr;
+        mapped->data = static_cast<const std::uint8_t*>(addr);
+        mapped->size = static_cast<std::size_t>(st.st_size);
+#endif
+        return mapped;
+    }
+
+    ~MappedFile()
+    {
+#ifdef _WIN32
+        if (data) UnmapViewOfFile(data);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+        if (data) munmap(const_cast<std::uint8_t*>(data), size);
+#endif
+    }
+};
+
+RegionCache::RegionCache(const std::string& directory, std::uint32_t worldTag)
+    : m_directory(directory), m_worldTag(worldTag)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(m_directory, ec);
+    if (ec) std::cerr << "[RegionCache] Cannot create " << m_directory << ": " << ec.message() << std::endl;
+    m_writer = std::thread(&RegionCache::WriterLoop, this);
+}
+
+RegionCache::~RegionCache()
+{
+    Shutdown();
+}
+
+void RegionCache::Shutdown()
+{
+    {
+        TimedLockGuard lk(m_writeMutex);
+        if (m_exit) return;
+        m_exit = true;
+    }
+    m_writeCV.notify_all();
+    if (m_writer.joinable()) m_writer.join();
+}
+
+std::string RegionCache::GetRegionPath(int regionX, int regionZ) const
+{
+    return m_directory + "/r." + std::to_string(regionX) + "." + std::to_string(regionZ) + ".pwr";
+}
+
+std::shared_ptr<RegionCache::MappedFile> RegionCache::GetRegionMapping(int regionX, int regionZ)
+{
+    std::uint64_t key = PackKey(regionX, regionZ);
+    TimedLockGuard lk(m_mapMutex);
+    auto it = m_mappedRegions.find(key);
+    if (it != m_mappedRegions.end()) return it->second;
+    auto mapped = MappedFile::Open(GetRegionPath(regionX, regionZ));
+    m_mappedRegions.emplace(key, mapped);
+    return mapped;
+}
+
+bool RegionCache::Load(int chunkX, int chunkZ, RegionChunkRecord& out)
+{
+    // 1. 尚未落盘的区块
+    {
+        TimedLockGuard lk(m_writeMutex);
+        auto it = m_pending.find(PackKey(chunkX, chunkZ));
+        if (it != m_pending.end()) {
+            out = *it->second;
+            m_hits.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // 2. 从映射的区域文件读取 (所有偏移都做越界检查，文件损坏时当作未命中)
+    int regionX = FloorDiv(chunkX, REGION_SIZE);
+    int regionZ = FloorDiv(chunkZ, REGION_SIZE);
+    std::shared_ptr<MappedFile> mapped = GetRegionMapping(regionX, regionZ);
+    if (!mapped) {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    RegionHeader header;
+    std::memcpy(&header, mapped->data, sizeof(header));
+    if (std::memcmp(header.magic, REGION_MAGIC, sizeof(REGION_MAGIC)) != 0 ||
+        header.version != REGION_VERSION || header.worldTag != m_worldTag) {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    int index = (chunkZ - regionZ * REGION_SIZE) * REGION_SIZE + (chunkX - regionX * REGION_SIZE);
+    RegionEntry entry;
+    std::memcpy(&entry, mapped->data + sizeof(RegionHeader) + sizeof(RegionEntry) * index, sizeof(entry));
+    if (entry.offset == 0 || static_cast<std::size_t>(entry.offset) + entry.size > mapped->size ||
+        entry.size < sizeof(std::uint32_t) * 2) {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    const std::uint8_t* src = mapped->data + entry.offset;
+    std::uint32_t counts[2];
+    std::memcpy(counts, src, sizeof(counts));
+    std::size_t expected = sizeof(counts) + counts[0] * sizeof(float) + counts[1] * sizeof(RegionBlockRecord);
+    if (expected != entry.size) {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    src += sizeof(counts);
+    out.heights.resize(counts[0]);
+    std::memcpy(out.heights.data(), src, counts[0] * sizeof(float));
+    src += counts[0] * sizeof(float);
+    out.blocks.resize(counts[1]);
+    std::memcpy(out.blocks.data(), src, counts[1] * sizeof(RegionBlockRecord));
+
+    m_hits.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void RegionCache::StoreAsync(int chunkX, int chunkZ, RegionChunkRecord record)
+{
+    std::uint64_t key = PackKey(chunkX, chunkZ);
+    {
+        TimedLockGuard lk(m_writeMutex);
+        if (m_exit) return;
+        // 同一区块重复提交时只保留最新内容，不重复排队
+        auto it = m_pending.find(key);
+        if (it == m_pending.end()) m_writeOrder.push_back(key);
+        m_pending[key] = std::make_shared<const RegionChunkRecord>(std::move(record));
+    }
+    m_writeCV.notify_one();
+}
+
+void RegionCache::WriterLoop()
+{
+    PW_PROFILE_THREAD("RegionWriter");
+    while (true) {
+        std::uint64_t key = 0;
+        std::shared_ptr<const RegionChunkRecord> record;
+        {
+            std::unique_lock<std::mutex> lk(m_writeMutex);
+            m_writeCV.wait(lk, [this] { return m_exit || !m_writeOrder.empty(); });
+            // 退出前写完所有排队的区块，保证编辑不丢失
+            if (m_writeOrder.empty()) break;
+            key = m_writeOrder.front();
+            m_writeOrder.pop_front();
+            record = m_pending[key];
+        }
+
+        int chunkX = static_cast<int>(static_cast<std::uint32_t>(key >> 32));
+        int chunkZ = static_cast<int>(static_cast<std::uint32_t>(key & 0xffffffffu));
+        {
+            PW_PROFILE_ZONE("RegionCache::WriteChunk");
+            if (WriteChunk(chunkX, chunkZ, *record)) m_writes.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        {
+            // 写入期间若提交了更新的版本，重新排队再写一次
+            TimedLockGuard lk(m_writeMutex);
+            auto it = m_pending.find(key);
+            if (it != m_pending.end()) {
+                if (it->second == record) m_pending.erase(it);
+                else m_writeOrder.push_back(key);
+            }
+        }
+    }
+}
+
+bool RegionCache::WriteChunk(int chunkX, int chunkZ, const RegionChunkRecord& record)
+{
+    int regionX = FloorDiv(chunkX, REGION_SIZE);
+    int regionZ = FloorDiv(chunkZ, REGION_SIZE);
+    int index = (chunkZ - regionZ * REGION_SIZE) * REGION_SIZE + (chunkX - regionX * REGION_SIZE);
+    std::string path = GetRegionPath(regionX, regionZ);
+
+    std::vector<std::uint8_t> payload = EncodeChunkPayload(record);
+    // 读取现有文件的偏移表；文件不存在、世界标签不符或已损坏时 valid 为 false
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    std::vector<RegionEntry> table(REGION_CHUNKS, RegionEntry{ 0, 0 });
+    std::uint64_t fileSize = 0;
+    bool valid = false;
+    if (file.is_open()) {
+        RegionHeader header;
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        file.read(reinterpret_cast<char*>(table.data()), sizeof(RegionEntry) * table.size());
+        valid = file.good() && std::memcmp(header.magic, REGION_MAGIC, sizeof(REGION_MAGIC)) == 0 &&
+                header.version == REGION_VERSION && header.worldTag == m_worldTag;
+        file.clear();
+        file.seekg(0, std::ios::end);
+        fileSize = static_cast<std::uint64_t>(file.tellg());
+    }
+    if (!valid) table.assign(REGION_CHUNKS, RegionEntry{ 0, 0 });
+
+    // 覆盖写入只追加，旧数据成为垃圾；垃圾超过阈值且多于有效数据时整体压缩重写
+    std::uint64_t liveBytes = payload.size();
+    for (int i = 0; i < REGION_CHUNKS; ++i) {
+        if (i != index && table[i].offset != 0) liveBytes += table[i].size;
+    }
+    std::uint64_t usedBytes = REGION_TABLE_BYTES + liveBytes;
+    std::uint64_t appendedSize = fileSize + payload.size();
+    std::uint64_t deadBytes = appendedSize > usedBytes ? appendedSize - usedBytes : 0;
+    bool compact = valid && deadBytes >= COMPACT_MIN_DEAD_BYTES && deadBytes > liveBytes;
+    if (usedBytes > 0xffffffffull) {
+        std::cerr << "[RegionCache] Region file full: " << path << std::endl;
+        return false;
+    }
+
+    if (valid && !compact && appendedSize <= 0xffffffffull) {
+        // 数据追加到文件末尾，再更新偏移表 (已映射的读者看到的仍是完整的旧数据)
+        file.seekp(0, std::ios::end);
+        file.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+        RegionEntry entry{ static_cast<std::uint32_t>(fileSize), static_cast<std::uint32_t>(payload.size()) };
+        file.seekp(static_cast<std::streamoff>(sizeof(RegionHeader) + sizeof(RegionEntry) * index));
+        file.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+        file.flush();
+        if (!file.good()) {
+            std::cerr << "[RegionCache] Write failed: " << path << std::endl;
+            return false;
+        }
+        file.close();
+
+        // 文件已增长，丢弃旧映射，下次读取时重新映射
+        TimedLockGuard lk(m_mapMutex);
+        m_mappedRegions.erase(PackKey(regionX, regionZ));
+        return true;
+    }
+
+    // 新文件、生成参数已变化或需要压缩：有效区块与新数据写入临时文件，再整体替换。
+    // 从不原地截断，仍映射旧文件的读者不会因文件变短而 SIGBUS
+    std::string tempPath = path + ".tmp";
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "[RegionCache] Cannot open " << tempPath << std::endl;
+        return false;
+    }
+    std::vector<RegionEntry> newTable(REGION_CHUNKS, RegionEntry{ 0, 0 });
+    out.seekp(static_cast<std::streamoff>(REGION_TABLE_BYTES));
+    std::uint64_t offset = REGION_TABLE_BYTES;
+    std::vector<char> buffer;
+    for (int i = 0; i < REGION_CHUNKS; ++i) {
+        if (i == index) {
+            out.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+            newTable[i] = { static_cast<std::uint32_t>(offset), static_cast<std::uint32_t>(payload.size()) };
+            offset += payload.size();
+            continue;
+        }
+        const RegionEntry& old = table[i];
+        if (old.offset == 0 || static_cast<std::uint64_t>(old.offset) + old.size > fileSize) continue;
+        buffer.resize(old.size);
+        file.seekg(static_cast<std::streamoff>(old.offset));
+        file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        if (!file.good()) {
+            file.clear();
+            continue; // 读不出的旧区块直接丢弃，之后重新生成
+        }
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        newTable[i] = { static_cast<std::uint32_t>(offset), old.size };
+        offset += old.size;
+    }
+    file.close();
+
+    RegionHeader header;
+    std::memcpy(header.magic, REGION_MAGIC, sizeof(REGION_MAGIC));
+    header.version = REGION_VERSION;
+    header.worldTag = m_worldTag;
+    header.reserved = 0;
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(newTable.data()), sizeof(RegionEntry) * newTable.size());
+    out.flush();
+    if (!out.good()) {
+        std::cerr << "[RegionCache] Write failed: " << tempPath << std::endl;
+        out.close();
+        std::error_code ec;
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+    out.close();
+
+    if (!ReplaceRegionFile(regionX, regionZ, tempPath, path)) return false;
+    if (compact) m_compactions.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool RegionCache::ReplaceRegionFile(int regionX, int regionZ, const std::string& tempPath, const std::string& path)
+{
+    // 持锁期间新的读取无法映射该区域；等正在读取的线程放下旧映射后再替换
+    // (Windows 不允许替换仍被映射的文件，POSIX 上旧映射会继续指向被替换的旧文件)
+    TimedLockGuard lk(m_mapMutex);
+    auto it = m_mappedRegions.find(PackKey(regionX, regionZ));
+    if (it != m_mappedRegions.end()) {
+        std::weak_ptr<MappedFile> old = it->second;
+        m_mappedRegions.erase(it);
+        while (!old.expired()) std::this_thread::yield();
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        std::cerr << "[RegionCache] Cannot replace " << path << ": " << ec.message() << std::endl;
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
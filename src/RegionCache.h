@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// 单个方块记录 (4 字节)：区块内列坐标 + 高度 + 方块类型
+struct RegionBlockRecord {
+    std::uint8_t column; // (lx << 4) | lz
+    std::uint8_t type;
+    std::int16_t y;
+};
+static_assert(sizeof(RegionBlockRecord) == 4, "RegionBlockRecord must stay 4 bytes");
+
+// 一个区块在区域文件中的内容
+struct RegionChunkRecord {
+    std::vector<float> heights;             // 生成时的高度图
+    std::vector<RegionBlockRecord> blocks;  // 区块内所有非空气方块
+};
+
+/**
+ * @class RegionCache
+ * @brief 区块磁盘缓存 (区域文件)
+ * @details
+ *   - 每个区域文件保存 32x32 个区块，文件头为区块偏移表
+ *   - 读取通过内存映射 (mmap / MapViewOfFile)，可在任意工作线程调用
+ *   - 写入由后台线程异步完成，尚未落盘的区块在内存中同样可读
+ *   - 覆盖写入 (例如玩家编辑) 时追加到文件末尾并更新偏移表；旧数据累积过多时压缩重写
+ *   - 重写 (新建、作废或压缩) 先写临时文件再整体替换，从不截断仍被映射的文件
+ *   - 文件头记录世界标签，生成参数变化后旧文件自动作废
+ */
+class RegionCache {
+public:
+    static constexpr int REGION_SIZE = 32;
+
+    /**
+     * @param directory 区域文件目录 (不存在时自动创建)
+     * @param worldTag 世界种子与生成参数的哈希
+     */
+    RegionCache(const std::string& directory, std::uint32_t worldTag);
+    ~RegionCache();
+
+    RegionCache(const RegionCache&) = delete;
+    RegionCache& operator=(const RegionCache&) = delete;
+
+    // 读取区块 (线程安全)，缓存中没有时返回 false
+    bool Load(int chunkX, int chunkZ, RegionChunkRecord& out);
+
+    // 排队写入区块 (线程安全)，覆盖已有记录
+    void StoreAsync(int chunkX, int chunkZ, RegionChunkRecord record);
+
+    // 写完所有排队的区块并停止写线程
+    void Shutdown();
+
+    std::size_t GetHitCount() const { return m_hits.load(std::memory_order_relaxed); }
+    std::size_t GetMissCount() const { return m_misses.load(std::memory_order_relaxed); }
+    std::size_t GetWriteCount() const { return m_writes.load(std::memory_order_relaxed); }
+    std::size_t GetCompactionCount() const { return m_compactions.load(std::memory_order_relaxed); }
+
+private:
+    struct MappedFile;
+
+    std::string m_directory;
+    std::uint32_t m_worldTag;
+
+    // 已映射的区域文件 (nullptr 表示文件不存在)
+    std::mutex m_mapMutex;
+    std::unordered_map<std::uint64_t, std::shared_ptr<MappedFile>> m_mappedRegions;
+
+    // 待写入的区块，写完之前 Load 直接从这里读取
+    std::mutex m_writeMutex;
+    std::condition_variable m_writeCV;
+    std::unordered_map<std::uint64_t, std::shared_ptr<const RegionChunkRecord>> m_pending;
+    std::deque<std::uint64_t> m_writeOrder;
+    std::thread m_writer;
+    bool m_exit = false; // 受 m_writeMutex 保护
+
+    std::atomic<std::size_t> m_hits{ 0 };
+    std::atomic<std::size_t> m_misses{ 0 };
+    std::atomic<std::size_t> m_writes{ 0 };
+    std::atomic<std::size_t> m_compactions{ 0 };
+
+    void WriterLoop();
+    bool WriteChunk(int chunkX, int chunkZ, const RegionChunkRecord& record);
+    bool ReplaceRegionFile(int regionX, int regionZ, const std::string& tempPath, const std::string& path);
+    std::shared_ptr<MappedFile> GetRegionMapping(int regionX, int regionZ);
+    std::string GetRegionPath(int regionX, int regionZ) const;
+};
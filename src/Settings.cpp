@@ -27,11 +27,16 @@ GameSettings Settings::Load(const std::string& filename)
                     float value = std::stof(valueStr);
                     if (key == "sensitivity") settings.sensitivity = value;
                     else if (key == "fov") settings.fov = value;
+                    else if (key == "chunkWorkers") settings.chunkWorkers = static_cast<int>(value);
+                    else if (key == "greedyMeshing") settings.greedyMeshing = static_cast<int>(value);
+                    else if (key == "viewDistance") settings.viewDistance = static_cast<int>(value);
                 } catch (...) {}
             }
         }
     }
-    std::cout << "[Settings] Loaded: Sens=" << settings.sensitivity << ", FOV=" << settings.fov << std::endl;
+    std::cout << "[Settings] Loaded: Sens=" << settings.sensitivity << ", FOV=" << settings.fov
+              << ", ChunkWorkers=" << settings.chunkWorkers << ", GreedyMeshing=" << settings.greedyMeshing
+              << ", ViewDistance=" << settings.viewDistance << std::endl;
     return settings;
 }
 
@@ -42,6 +47,9 @@ void Settings::Save(const std::string& filename, const GameSettings& settings)
     {
         file << "sensitivity=" << settings.sensitivity << "\n";
         file << "fov=" << settings.fov << "\n";
+        file << "chunkWorkers=" << settings.chunkWorkers << "\n";
+        file << "greedyMeshing=" << settings.greedyMeshing << "\n";
+        file << "viewDistance=" << settings.viewDistance << "\n";
         std::cout << "[Settings] Saved" << std::endl;
     }
 }
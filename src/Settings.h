@@ -5,6 +5,9 @@ struct GameSettings
 {
     float sensitivity = 0.1f;
     float fov = 71.0f;
+    int chunkWorkers = 0; // 区块生成线程数，0 表示按硬件线程数自动选择
+    int greedyMeshing = 1; // 1: 贪心网格地形, 0: 每方块一个实例立方体 (启动时生效)
+    int viewDistance = 4;  // 视距 (区块数，2-32)，暂停菜单中可调
 };
 
 class Settings
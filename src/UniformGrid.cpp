@@ -0,0 +1,57 @@
+#include "UniformGrid.h"
+#include <algorithm>
+
+void UniformGrid::Build(const std::vector<glm::vec3>& points)
+{
+    m_sortedX.resize(points.size() + SORTED_PADDING);
+    m_sortedY.resize(points.size() + SORTED_PADDING);
+    m_sortedZ.resize(points.size() + SORTED_PADDING);
+    m_sortedIndex.resize(points.size());
+    if (points.empty()) {
+        m_dimX = m_dimZ = 0;
+        return;
+    }
+
+    // 1. 包围盒与格子划分
+    float minX = points[0].x, maxX = minX;
+    float minZ = points[0].z, maxZ = minZ;
+    for (const glm::vec3& p : points) {
+        minX = std::min(minX, p.x);
+        maxX = std::max(maxX, p.x);
+        minZ = std::min(minZ, p.z);
+        maxZ = std::max(maxZ, p.z);
+    }
+    const float extent = std::max(maxX - minX, maxZ - minZ);
+    m_cellSize = std::max(m_minCellSize, extent / static_cast<float>(MAX_CELLS_PER_AXIS - 1));
+    m_originX = minX;
+    m_originZ = minZ;
+    m_dimX = std::min(static_cast<int>((maxX - minX) / m_cellSize) + 1, MAX_CELLS_PER_AXIS);
+    m_dimZ = std::min(static_cast<int>((maxZ - minZ) / m_cellSize) + 1, MAX_CELLS_PER_AXIS);
+
+    // 2. 计数
+    const std::size_t cellCount = static_cast<std::size_t>(m_dimX) * m_dimZ;
+    m_cellStart.assign(cellCount + 1, 0);
+    m_pointCell.resize(points.size());
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        const int cx = CellCoord(points[i].x, m_originX, m_dimX);
+        const int cz = CellCoord(points[i].z, m_originZ, m_dimZ);
+        const std::uint32_t cell = static_cast<std::uint32_t>(cz * m_dimX + cx);
+        m_pointCell[i] = cell;
+        m_cellStart[cell + 1]++;
+    }
+
+    // 3. 前缀和 -> 每格起始下标
+    for (std::size_t c = 0; c < cellCount; ++c) m_cellStart[c + 1] += m_cellStart[c];
+
+    // 4. 分发：cellStart[c] 兼作第 c 格的写入游标
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        const std::uint32_t slot = m_cellStart[m_pointCell[i]]++;
+        m_sortedX[slot] = points[i].x;
+        m_sortedY[slot] = points[i].y;
+        m_sortedZ[slot] = points[i].z;
+        m_sortedIndex[slot] = static_cast<std::uint32_t>(i);
+    }
+    // 分发后 cellStart[c] 已前移到第 c + 1 格的起点，整体右移一位恢复
+    for (std::size_t c = cellCount; c > 0; --c) m_cellStart[c] = m_cellStart[c - 1];
+    m_cellStart[0] = 0;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class UniformGrid
+ * @brief XZ 平面上的扁平均匀网格 (敌人分离力的邻居查询)
+ * @details
+ *   - 每次 Build 按本批点的包围盒重新划分，格子边长不小于查询半径，邻居只可能在 3x3 格内
+ *   - 计数排序布局：先统计每格点数，前缀和得到每格起始下标，再把点按格子顺序写入连续数组；
+ *     同一行相邻三格在数组中也是连续的，3x3 查询只读三段连续内存
+ *   - 排序后的点按坐标分量分别存放 (SoA)，调用方可对一段连续下标一次处理 4 个点
+ *   - 数组在多次 Build 之间复用，容量够用后不再分配
+ */
+class UniformGrid {
+public:
+    static constexpr int MAX_CELLS_PER_AXIS = 256; // 点过于分散时放大格子，限制格子数组大小
+    static constexpr std::size_t SORTED_PADDING = 3; // 坐标数组末尾的填充，按 4 个一组读到区间末尾时不越界
+
+    explicit UniformGrid(float cellSize) : m_minCellSize(cellSize) {}
+
+    void Build(const std::vector<glm::vec3>& points);
+    // 预留 pointCount 个点的缓冲；格子数组按上限预留，之后 Build 不再分配
+    void Reserve(std::size_t pointCount) {
+        m_pointCell.reserve(pointCount);
+        m_sortedX.reserve(pointCount + SORTED_PADDING);
+        m_sortedY.reserve(pointCount + SORTED_PADDING);
+        m_sortedZ.reserve(pointCount + SORTED_PADDING);
+        m_sortedIndex.reserve(pointCount);
+        m_cellStart.reserve(static_cast<std::size_t>(MAX_CELLS_PER_AXIS) * MAX_CELLS_PER_AXIS + 1);
+    }
+
+    std::size_t GetPointCount() const { return m_sortedIndex.size(); }
+    float GetCellSize() const { return m_cellSize; }
+
+    // 按格子排序后的点坐标，下标与 ForEachCell 给出的区间对应；末尾另有 SORTED_PADDING 个无意义的填充值
+    const float* GetSortedX() const { return m_sortedX.data(); }
+    const float* GetSortedY() const { return m_sortedY.data(); }
+    const float* GetSortedZ() const { return m_sortedZ.data(); }
+    // 排序后每个点在 Build 输入中的下标
+    const std::uint32_t* GetSortedIndex() const { return m_sortedIndex.data(); }
+
+    // 连续下标区间 [begin, end)
+    struct Range {
+        std::uint32_t begin;
+        std::uint32_t end;
+    };
+
+    // 按格子顺序遍历非空格 fn(cell, near, nearCount)：cell 为本格的点，near 为本格及周围 8 格按行合并的 (至多 3 段) 区间，
+    // 不做距离筛选；同格的点共用同一组邻居区间，逐格处理时邻居数据留在缓存中
+    template<typename Fn>
+    void ForEachCell(Fn&& fn) const {
+        Range near[3];
+        for (int cz = 0; cz < m_dimZ; ++cz) {
+            const int z0 = cz > 0 ? cz - 1 : 0;
+            const int z1 = cz < m_dimZ - 1 ? cz + 1 : m_dimZ - 1;
+            for (int cx = 0; cx < m_dimX; ++cx) {
+                const std::size_t c = static_cast<std::size_t>(cz) * m_dimX + cx;
+                const Range cell{ m_cellStart[c], m_cellStart[c + 1] };
+                if (cell.begin == cell.end) continue;
+                const int x0 = cx > 0 ? cx - 1 : 0;
+                const int x1 = cx < m_dimX - 1 ? cx + 1 : m_dimX - 1;
+                int nearCount = 0;
+                for (int z = z0; z <= z1; ++z) {
+                    near[nearCount++] = Range{ m_cellStart[static_cast<std::size_t>(z) * m_dimX + x0],
+                                               m_cellStart[static_cast<std::size_t>(z) * m_dimX + x1 + 1] };
+                }
+                fn(cell, near, nearCount);
+            }
+        }
+    }
+
+private:
+    float m_minCellSize;
+    float m_cellSize = 1.0f;
+    float m_originX = 0.0f, m_originZ = 0.0f;
+    int m_dimX = 0, m_dimZ = 0;
+
+    std::vector<std::uint32_t> m_cellStart; // dimX * dimZ + 1 项，第 c 格的点为 [cellStart[c], cellStart[c + 1])
+    std::vector<std::uint32_t> m_pointCell; // 构建时每个输入点所在的格子
+    std::vector<float> m_sortedX;           // 按格子排序后的点 (SoA)
+    std::vector<float> m_sortedY;
+    std::vector<float> m_sortedZ;
+    std::vector<std::uint32_t> m_sortedIndex; // 排序后的点 -> 输入下标
+
+    // 网格外的坐标夹到边缘格 (格子数达到上限时包围盒边缘的点会越界)
+    int CellCoord(float v, float origin, int dim) const {
+        int c = static_cast<int>((v - origin) / m_cellSize);
+        return c < 0 ? 0 : (c >= dim ? dim - 1 : c);
+    }
+};
@@ -0,0 +1,642 @@
+#include "World.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <limits>
+
+Perlin2D g_perlin(WORLD_SEED);
+TerrainParams g_terrainParams;
+ChunkGrid<ChunkData> g_loadedChunks;
+HeightTileCache g_heightTileCache;
+CollisionWorld g_collisionWorld;
+bool g_useGreedyMeshing = true;
+RegionCache* g_regionCache = nullptr;
+
+namespace {
+// 生成规则变化 (不体现在 TerrainParams 中) 时递增，使旧的区域文件作废
+constexpr std::uint32_t GENERATOR_VERSION = 3;
+}
+
+bool intersectRayAABB(const Ray& ray, const glm::vec3& invDir, const glm::vec3& boxMin, const glm::vec3& boxMax, float& t)
+{
+    // Slab Method 实现 (使用预计算的 invDir)
+    glm::vec3 tMin = (boxMin - ray.origin) * invDir;
+    glm::vec3 tMax = (boxMax - ray.origin) * invDir;
+    
+    glm::vec3 t1 = glm::min(tMin, tMax);
+    glm::vec3 t2 = glm::max(tMin, tMax);
+    
+    float tNear = glm::max(glm::max(t1.x, t1.y), t1.z);
+    float tFar = glm::min(glm::min(t2.x, t2.y), t2.z);
+    
+    if (tNear > tFar || tFar < 0.0f)
+    {
+        return false;
+    }
+    
+    t = tNear;
+    return true;
+}
+
+ChunkKey WorldToChunk(const glm::vec3& pos)
+{
+    int cx = static_cast<int>(std::floor(pos.x / static_cast<float>(CHUNK_SIZE)));
+    int cz = static_cast<int>(std::floor(pos.z / static_cast<float>(CHUNK_SIZE)));
+    return { cx, cz };
+}
+
+float SampleTerrainHeight(int x, int z)
+{
+    // 仅主线程调用：已加载区块直接读高度图，否则查 LRU，未命中时整块批量计算
+    ChunkKey key{ static_cast<int>(std::floor(static_cast<float>(x) / CHUNK_SIZE)),
+                  static_cast<int>(std::floor(static_cast<float>(z) / CHUNK_SIZE)) };
+    int index = (x - key.x * CHUNK_SIZE) * CHUNK_SIZE + (z - key.z * CHUNK_SIZE);
+
+    if (const ChunkData* chunk = g_loadedChunks.Find(key)) return chunk->heights.Get(index);
+
+    if (const HeightTile* tile = g_heightTileCache.Find(key)) return (*tile)[index];
+
+    // 与已加载区块的高度图同样量化，区块加载前后同一列返回相同高度
+    HeightTile& tile = g_heightTileCache.Insert(key);
+    ComputeChunkHeights(key, tile.data());
+    for (float& h : tile) h = ChunkHeights::Quantize(h);
+    return tile[index];
+}
+
+void ComputeChunkHeights(const ChunkKey& key, float* outHeights)
+{
+    // 与 terrainHeight 相同的采样坐标，一次批量求值整个区块 (SIMD)
+    float xs[CHUNK_SIZE * CHUNK_SIZE];
+    float zs[CHUNK_SIZE * CHUNK_SIZE];
+    for (int lx = 0; lx < CHUNK_SIZE; ++lx) {
+        for (int lz = 0; lz < CHUNK_SIZE; ++lz) {
+            int idx = lx * CHUNK_SIZE + lz;
+            xs[idx] = (key.x * CHUNK_SIZE + lx) * g_terrainParams.baseFrequency;
+            zs[idx] = (key.z * CHUNK_SIZE + lz) * g_terrainParams.baseFrequency;
+        }
+    }
+    g_perlin.fbmBatch(xs, zs, outHeights, CHUNK_SIZE * CHUNK_SIZE, g_terrainParams.baseOctaves);
+    for (int i = 0; i < CHUNK_SIZE * CHUNK_SIZE; ++i) {
+        outHeights[i] *= g_terrainParams.baseAmplitude;
+    }
+}
+
+BlockType GetTerrainBlock(int x, int y, int z)
+{
+    ChunkKey key{ static_cast<int>(std::floor(static_cast<float>(x) / CHUNK_SIZE)),
+                  static_cast<int>(std::floor(static_cast<float>(z) / CHUNK_SIZE)) };
+    const ChunkData* chunk = g_loadedChunks.Find(key);
+    if (!chunk) return BlockType::Air;
+    return chunk->voxels.Get(x - key.x * CHUNK_SIZE, y, z - key.z * CHUNK_SIZE);
+}
+
+VoxelHit RaycastVoxels(const glm::vec3& origin, const glm::vec3& dir, float maxDist)
+{
+    // Amanatides & Woo 3D DDA。方块以整数坐标为中心，平移 0.5 后格子边界落在整数上
+    VoxelHit result;
+    const float INF = std::numeric_limits<float>::infinity();
+    glm::vec3 o = origin + glm::vec3(0.5f);
+
+    int cell[3] = { static_cast<int>(std::floor(o.x)), static_cast<int>(std::floor(o.y)), static_cast<int>(std::floor(o.z)) };
+    int step[3];
+    float tMax[3];
+    float tDelta[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        float d = dir[axis];
+        if (d > 0.0f) {
+            step[axis] = 1;
+            tDelta[axis] = 1.0f / d;
+            tMax[axis] = (static_cast<float>(cell[axis] + 1) - o[axis]) / d;
+        } else if (d < 0.0f) {
+            step[axis] = -1;
+            tDelta[axis] = -1.0f / d;
+            tMax[axis] = (o[axis] - static_cast<float>(cell[axis])) / -d;
+        } else {
+            step[axis] = 0;
+            tDelta[axis] = INF;
+            tMax[axis] = INF;
+        }
+    }
+
+    // 缓存当前区块，只有跨区块时才重新查表
+    ChunkKey cachedKey{ std::numeric_limits<int>::min(), std::numeric_limits<int>::min() };
+    const ChunkVoxels* voxels = nullptr;
+
+    float t = 0.0f;
+    int lastAxis = -1;
+    while (t <= maxDist) {
+        ChunkKey key{ static_cast<int>(std::floor(static_cast<float>(cell[0]) / CHUNK_SIZE)),
+                      static_cast<int>(std::floor(static_cast<float>(cell[2]) / CHUNK_SIZE)) };
+        if (!(key == cachedKey)) {
+            cachedKey = key;
+            const ChunkData* chunk = g_loadedChunks.Find(key);
+            voxels = chunk ? &chunk->voxels : nullptr;
+        }
+        if (voxels && voxels->IsSolid(cell[0] - key.x * CHUNK_SIZE, cell[1], cell[2] - key.z * CHUNK_SIZE)) {
+            result.hit = true;
+            result.x = cell[0];
+            result.y = cell[1];
+            result.z = cell[2];
+            result.t = t;
+            if (lastAxis >= 0) result.normal[lastAxis] = static_cast<float>(-step[lastAxis]);
+            return result;
+        }
+
+        // 前进到最近的格子边界
+        int axis = (tMax[0] < tMax[1]) ? (tMax[0] < tMax[2] ? 0 : 2) : (tMax[1] < tMax[2] ? 1 : 2);
+        if (tMax[axis] == INF) break;
+        t = tMax[axis];
+        tMax[axis] += tDelta[axis];
+        cell[axis] += step[axis];
+        lastAxis = axis;
+    }
+    return result;
+}
+
+VoxelHit RaycastVoxelsStepped(const glm::vec3& origin, const glm::vec3& dir, float maxDist)
+{
+    // 旧版定步长 (0.5) 步进，仅保留用于基准对比
+    VoxelHit result;
+    Ray ray{ origin, dir };
+    glm::vec3 invDir;
+    invDir.x = (std::abs(dir.x) < 1e-6f) ? 1e20f : 1.0f / dir.x;
+    invDir.y = (std::abs(dir.y) < 1e-6f) ? 1e20f : 1.0f / dir.y;
+    invDir.z = (std::abs(dir.z) < 1e-6f) ? 1e20f : 1.0f / dir.z;
+
+    glm::vec3 samplePos = origin;
+    glm::vec3 step = dir * 0.5f;
+    float currentDist = 0.0f;
+    while (currentDist < maxDist) {
+        int x = (int)std::floor(samplePos.x);
+        int y = (int)std::floor(samplePos.y);
+        int z = (int)std::floor(samplePos.z);
+
+        if (GetTerrainBlock(x, y, z) != BlockType::Air) {
+            glm::vec3 center(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z));
+            float t = 0.0f;
+            if (intersectRayAABB(ray, invDir, center - glm::vec3(0.5f), center + glm::vec3(0.5f), t)) {
+                result.hit = true;
+                result.x = x;
+                result.y = y;
+                result.z = z;
+                result.t = t;
+                return result;
+            }
+        }
+
+        samplePos += step;
+        currentDist += 0.5f;
+    }
+    return result;
+}
+
+std::uint32_t ComputeWorldTag()
+{
+    // 种子与生成参数的 FNV-1a 哈希，参数变化后旧的区域文件自动作废
+    std::uint32_t hash = 2166136261u;
+    auto mix = [&hash](const void* data, size_t size) {
+        const auto* bytes = static_cast<const std::uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 16777619u;
+        }
+    };
+    const TerrainParams& tp = g_terrainParams;
+    mix(&WORLD_SEED, sizeof(WORLD_SEED));
+    mix(&tp.baseAmplitude, sizeof(tp.baseAmplitude));
+    mix(&tp.baseFrequency, sizeof(tp.baseFrequency));
+    mix(&tp.baseOctaves, sizeof(tp.baseOctaves));
+    mix(&tp.waterLevel, sizeof(tp.waterLevel));
+    mix(&tp.beachHeight, sizeof(tp.beachHeight));
+    mix(&tp.snowHeight, sizeof(tp.snowHeight));
+    mix(&tp.treeThreshold, sizeof(tp.treeThreshold));
+    int chunkSize = CHUNK_SIZE;
+    mix(&chunkSize, sizeof(chunkSize));
+    mix(&GENERATOR_VERSION, sizeof(GENERATOR_VERSION));
+    return hash;
+}
+
+RegionChunkRecord EncodeChunkRecord(const ChunkData& chunk)
+{
+    RegionChunkRecord record;
+    record.heights.resize(CHUNK_SIZE * CHUNK_SIZE);
+    for (int i = 0; i < CHUNK_SIZE * CHUNK_SIZE; ++i) record.heights[i] = chunk.heights.Get(i);
+    record.blocks.reserve(chunk.voxels.blocks.size());
+    for (const auto& b : chunk.voxels.blocks) {
+        record.blocks.push_back({ b.column, static_cast<std::uint8_t>(b.type), b.y });
+    }
+    return record;
+}
+
+
+ChunkData LoadOrGenerateChunk(const ChunkKey& key)
+{
+    // 先查磁盘缓存，未命中时生成并异步写回
+    RegionChunkRecord record;
+    if (g_regionCache && g_regionCache->Load(key.x, key.z, record) &&
+        record.heights.size() == static_cast<size_t>(CHUNK_SIZE * CHUNK_SIZE)) {
+        ChunkData chunk;
+        for (int i = 0; i < CHUNK_SIZE * CHUNK_SIZE; ++i) chunk.heights.Set(i, record.heights[i]);
+        std::vector<PackedBlock> blocks;
+        blocks.reserve(record.blocks.size());
+        for (const auto& r : record.blocks) {
+            blocks.push_back({ r.column, static_cast<BlockType>(r.type), r.y });
+        }
+        BuildChunkFromBlocks(key, std::move(blocks), chunk);
+        return chunk;
+    }
+
+    ChunkData chunk = GenerateChunk(key);
+    if (g_regionCache) g_regionCache->StoreAsync(key.x, key.z, EncodeChunkRecord(chunk));
+    return chunk;
+}
+
+void BuildChunkFromBlocks(const ChunkKey& key, std::vector<PackedBlock> blocks, ChunkData& chunk)
+{
+    // 按 (列, y) 稳定排序；同一格子出现多次时保留最后写入的方块 (例如相邻树冠重叠)
+    std::stable_sort(blocks.begin(), blocks.end(), [](const PackedBlock& a, const PackedBlock& b) {
+        return a.column != b.column ? a.column < b.column : a.y < b.y;
+    });
+    size_t count = 0;
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        if (i + 1 < blocks.size() && blocks[i + 1].column == blocks[i].column && blocks[i + 1].y == blocks[i].y) continue;
+        blocks[count++] = blocks[i];
+    }
+    blocks.resize(count);
+    blocks.shrink_to_fit();
+
+    ChunkVoxels& voxels = chunk.voxels;
+    voxels.blocks = std::move(blocks);
+    voxels.minY = std::numeric_limits<int>::max();
+    voxels.maxY = std::numeric_limits<int>::min();
+    voxels.multiRun.reset();
+    voxels.wideStart.clear();
+    std::array<std::uint16_t, ChunkVoxels::COLUMN_COUNT + 1> starts;
+    size_t next = 0;
+    for (int column = 0; column < ChunkVoxels::COLUMN_COUNT; ++column) {
+        starts[column] = static_cast<std::uint16_t>(next);
+        int runs = 0;
+        for (; next < voxels.blocks.size() && voxels.blocks[next].column == column; ++next) {
+            int y = voxels.blocks[next].y;
+            voxels.minY = std::min(voxels.minY, y);
+            voxels.maxY = std::max(voxels.maxY, y);
+            if (next == starts[column] || y != voxels.blocks[next - 1].y + 1) runs++;
+        }
+        if (runs > 2) voxels.multiRun.set(column);
+    }
+    starts[ChunkVoxels::COLUMN_COUNT] = static_cast<std::uint16_t>(next);
+
+    bool wide = false;
+    for (int column = 0; column <= ChunkVoxels::COLUMN_COUNT; ++column) {
+        int group = column / ChunkVoxels::GROUP_COLUMNS;
+        if (column % ChunkVoxels::GROUP_COLUMNS == 0) voxels.groupStart[group] = starts[column];
+        int offset = starts[column] - voxels.groupStart[group];
+        if (offset > 255) wide = true;
+        voxels.columnOffset[column] = static_cast<std::uint8_t>(offset);
+    }
+    if (wide) voxels.wideStart.assign(starts.begin(), starts.end());
+    if (voxels.blocks.empty()) {
+        voxels.minY = 0;
+        voxels.maxY = -1;
+    }
+
+    // 方块以整数坐标为中心，盒子向外扩展半格
+    bool empty = voxels.blocks.empty();
+    float originX = static_cast<float>(key.x * CHUNK_SIZE);
+    float originZ = static_cast<float>(key.z * CHUNK_SIZE);
+    chunk.boundsMin = glm::vec3(originX - 0.5f, empty ? 0.0f : voxels.minY - 0.5f, originZ - 0.5f);
+    chunk.boundsMax = glm::vec3(originX + CHUNK_SIZE - 0.5f, empty ? 0.0f : voxels.maxY + 0.5f, originZ + CHUNK_SIZE - 0.5f);
+}
+
+BlockType ChunkVoxels::FindInColumn(int begin, int end, int y) const
+{
+    auto first = blocks.begin() + begin;
+    auto last = blocks.begin() + end;
+    auto it = std::lower_bound(first, last, y, [](const PackedBlock& b, int value) { return b.y < value; });
+    return it != last && it->y == y ? it->type : BlockType::Air;
+}
+
+bool EditChunkBlock(const ChunkKey& key, ChunkData& chunk, int lx, int y, int lz, BlockType type)
+{
+    if (chunk.voxels.Get(lx, y, lz) == type) return false;
+    std::vector<PackedBlock> blocks = chunk.voxels.blocks;
+    blocks.erase(std::remove_if(blocks.begin(), blocks.end(), [&](const PackedBlock& b) {
+        return b.lx() == lx && b.y == y && b.lz() == lz;
+    }), blocks.end());
+    if (type != BlockType::Air) blocks.push_back(MakePackedBlock(lx, y, lz, type));
+    BuildChunkFromBlocks(key, std::move(blocks), chunk);
+    return true;
+}
+
+int ColumnTop(const ChunkData& chunk, int lx, int lz)
+{
+    // 表层方块被挖掉时列顶下降一格；水下的列以水面为顶 (水面同样不透明)
+    int top = static_cast<int>(std::floor(chunk.heights.Get(lx * CHUNK_SIZE + lz)));
+    if (!chunk.voxels.IsSolid(lx, top, lz)) top--;
+    int water = static_cast<int>(g_terrainParams.waterLevel);
+    if (top < water && chunk.voxels.IsSolid(lx, water, lz)) top = water;
+    return top;
+}
+
+namespace {
+
+constexpr int CHUNK_PADDED = CHUNK_SIZE + 2;
+using ColumnTops = std::array<int, CHUNK_PADDED * CHUNK_PADDED>;
+
+// 未编辑的区块按生成规则得到的列顶 (由高度直接推出)
+int PredictedColumnTop(float h)
+{
+    int top = static_cast<int>(std::floor(h));
+    if (top < g_terrainParams.waterLevel) top = static_cast<int>(g_terrainParams.waterLevel);
+    return top;
+}
+
+// 带一圈边框的列顶数组中，相邻区块 side 侧第 i 列的下标
+int BorderColumnIndex(int side, int i)
+{
+    switch (side) {
+        case CHUNK_SIDE_NEG_X: return 0 * CHUNK_PADDED + (i + 1);
+        case CHUNK_SIDE_POS_X: return (CHUNK_PADDED - 1) * CHUNK_PADDED + (i + 1);
+        case CHUNK_SIDE_NEG_Z: return (i + 1) * CHUNK_PADDED + 0;
+        default:               return (i + 1) * CHUNK_PADDED + (CHUNK_PADDED - 1);
+    }
+}
+
+void ComputeColumnTops(const ChunkKey& key, const ChunkData& chunk, const ChunkBorder& border, ColumnTops& columnTops)
+{
+    // 可在工作线程调用：已加载的相邻边使用抓取的实际列顶，未加载的一侧按噪声预测
+    float xs[CHUNK_SIDE_COUNT * CHUNK_SIZE];
+    float zs[CHUNK_SIDE_COUNT * CHUNK_SIZE];
+    float ring[CHUNK_SIDE_COUNT * CHUNK_SIZE];
+    int ringIndex[CHUNK_SIDE_COUNT * CHUNK_SIZE];
+    int ringCount = 0;
+    for (int side = 0; side < CHUNK_SIDE_COUNT; ++side) {
+        bool loaded = (border.loadedSides >> side) & 1;
+        ChunkKey neighbour = ChunkNeighbour(key, side);
+        for (int i = 0; i < CHUNK_SIZE; ++i) {
+            if (loaded) {
+                columnTops[BorderColumnIndex(side, i)] = border.columnTops[side * CHUNK_SIZE + i];
+                continue;
+            }
+            int lx, lz;
+            ChunkEdgeColumn(side ^ 1, i, lx, lz);
+            xs[ringCount] = (neighbour.x * CHUNK_SIZE + lx) * g_terrainParams.baseFrequency;
+            zs[ringCount] = (neighbour.z * CHUNK_SIZE + lz) * g_terrainParams.baseFrequency;
+            ringIndex[ringCount] = BorderColumnIndex(side, i);
+            ringCount++;
+        }
+    }
+    if (ringCount > 0) g_perlin.fbmBatch(xs, zs, ring, static_cast<size_t>(ringCount), g_terrainParams.baseOctaves);
+    for (int i = 0; i < ringCount; ++i) {
+        // 与 ChunkHeights 相同的量化，预测值与相邻区块加载后的高度图一致
+        columnTops[ringIndex[i]] = PredictedColumnTop(ChunkHeights::Quantize(ring[i] * g_terrainParams.baseAmplitude));
+    }
+
+    // 四个角不会被查询 (面邻居只在共边的一圈上)
+    const int corners[4] = { 0, CHUNK_PADDED - 1, (CHUNK_PADDED - 1) * CHUNK_PADDED, CHUNK_PADDED * CHUNK_PADDED - 1 };
+    for (int c : corners) columnTops[c] = std::numeric_limits<int>::min();
+
+    for (int lx = 0; lx < CHUNK_SIZE; ++lx) {
+        for (int lz = 0; lz < CHUNK_SIZE; ++lz) {
+            columnTops[(lx + 1) * CHUNK_PADDED + (lz + 1)] = ColumnTop(chunk, lx, lz);
+        }
+    }
+}
+
+// 相邻区块边缘列中高于列顶的方块，展开到本区块的 y 范围：下标 ((y - minY) * 4 + side) * CHUNK_SIZE + i
+std::vector<std::uint8_t> ExpandBorderCells(const ChunkBorder& border, int minY, int height)
+{
+    std::vector<std::uint8_t> cells(static_cast<size_t>(std::max(height, 0)) * CHUNK_SIDE_COUNT * CHUNK_SIZE, 0);
+    for (const auto& b : border.blocks) {
+        int y = b.y - minY;
+        if (y < 0 || y >= height) continue;
+        cells[(static_cast<size_t>(y) * CHUNK_SIDE_COUNT + b.side) * CHUNK_SIZE + b.i] = 1;
+    }
+    return cells;
+}
+
+} // namespace
+
+ChunkBorder CaptureChunkBorder(const ChunkKey& key)
+{
+    ChunkBorder border;
+    for (int side = 0; side < CHUNK_SIDE_COUNT; ++side) {
+        const ChunkData* neighbour = g_loadedChunks.Find(ChunkNeighbour(key, side));
+        if (!neighbour) continue;
+        border.loadedSides |= static_cast<std::uint8_t>(1 << side);
+        const ChunkVoxels& voxels = neighbour->voxels;
+        for (int i = 0; i < CHUNK_SIZE; ++i) {
+            // 相邻区块与本区块共享的是它自己相对一侧的边
+            int lx, lz;
+            ChunkEdgeColumn(side ^ 1, i, lx, lz);
+            int top = ColumnTop(*neighbour, lx, lz);
+            border.columnTops[side * CHUNK_SIZE + i] = top;
+            int column = (lx << 4) | lz;
+            for (int j = voxels.ColumnBegin(column); j < voxels.ColumnEnd(column); ++j) {
+                if (voxels.blocks[j].y > top) {
+                    border.blocks.push_back({ static_cast<std::uint8_t>(side), static_cast<std::uint8_t>(i), voxels.blocks[j].y });
+                }
+            }
+        }
+    }
+    return border;
+}
+
+bool ChunkEdgeDiffersFromPrediction(const ChunkData& chunk, int side)
+{
+    const ChunkVoxels& voxels = chunk.voxels;
+    for (int i = 0; i < CHUNK_SIZE; ++i) {
+        int lx, lz;
+        ChunkEdgeColumn(side, i, lx, lz);
+        int top = ColumnTop(chunk, lx, lz);
+        if (top != PredictedColumnTop(chunk.heights.Get(lx * CHUNK_SIZE + lz))) return true;
+        int column = (lx << 4) | lz;
+        int end = voxels.ColumnEnd(column);
+        if (end > voxels.ColumnBegin(column) && voxels.blocks[end - 1].y > top) return true;
+    }
+    return false;
+}
+
+void BuildChunkMesh(const ChunkKey& key, ChunkData& chunk, const ChunkBorder& border)
+{
+    ColumnTops columnTops;
+    ComputeColumnTops(key, chunk, border, columnTops);
+
+    // 网格生成需要稠密格子：临时展开 y 范围内的方块，格子值即 BlockType
+    const ChunkVoxels& voxels = chunk.voxels;
+    int height = voxels.maxY - voxels.minY + 1;
+    std::vector<std::uint8_t> cells(static_cast<size_t>(std::max(height, 0)) * CHUNK_SIZE * CHUNK_SIZE, 0);
+    for (const auto& b : voxels.blocks) {
+        cells[static_cast<size_t>(b.y - voxels.minY) * CHUNK_SIZE * CHUNK_SIZE + b.column] = static_cast<std::uint8_t>(b.type);
+    }
+    std::vector<std::uint8_t> borderCells = ExpandBorderCells(border, voxels.minY, height);
+    glm::vec3 typeColors[BLOCK_TYPE_COUNT];
+    for (int t = 0; t < BLOCK_TYPE_COUNT; ++t) typeColors[t] = getBlockColor(static_cast<BlockType>(t));
+
+    ChunkMeshInput input;
+    input.originX = key.x * CHUNK_SIZE;
+    input.originZ = key.z * CHUNK_SIZE;
+    input.size = CHUNK_SIZE;
+    input.minY = voxels.minY;
+    input.height = std::max(height, 0);
+    input.cells = cells.data();
+    input.paletteColors = typeColors;
+    input.columnTops = columnTops.data();
+    input.borderCells = borderCells.data();
+    ChunkMesher::BuildGreedy(input, chunk.meshData);
+}
+
+void ComputeChunkFaceMasks(const ChunkKey& key, ChunkData& chunk, const ChunkBorder& border)
+{
+    // 与贪心网格相同的遮挡规则：相邻格有方块 (含相邻区块边缘)，或位于列顶及以下的隐式地基
+    ColumnTops columnTops;
+    ComputeColumnTops(key, chunk, border, columnTops);
+
+    const ChunkVoxels& voxels = chunk.voxels;
+    int height = voxels.maxY - voxels.minY + 1;
+    std::vector<std::uint8_t> borderCells = ExpandBorderCells(border, voxels.minY, height);
+    auto occludes = [&](int lx, int y, int lz) {
+        bool insideXZ = lx >= 0 && lx < CHUNK_SIZE && lz >= 0 && lz < CHUNK_SIZE;
+        if (insideXZ) {
+            if (voxels.IsSolid(lx, y, lz)) return true;
+        } else if (y >= voxels.minY && y <= voxels.maxY) {
+            int side = lx < 0 ? CHUNK_SIDE_NEG_X : lx >= CHUNK_SIZE ? CHUNK_SIDE_POS_X : lz < 0 ? CHUNK_SIDE_NEG_Z : CHUNK_SIDE_POS_Z;
+            int i = side < CHUNK_SIDE_NEG_Z ? lz : lx;
+            if (borderCells[(static_cast<size_t>(y - voxels.minY) * CHUNK_SIDE_COUNT + side) * CHUNK_SIZE + i] != 0) return true;
+        }
+        return y <= columnTops[(lx + 1) * CHUNK_PADDED + (lz + 1)];
+    };
+    static const int FACE_DIRS[6][3] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+
+    chunk.faceMasks.resize(voxels.blocks.size());
+    for (size_t i = 0; i < voxels.blocks.size(); ++i) {
+        int lx = voxels.blocks[i].lx();
+        int y = voxels.blocks[i].y;
+        int lz = voxels.blocks[i].lz();
+        GLuint mask = 0;
+        for (int f = 0; f < 6; ++f) {
+            if (!occludes(lx + FACE_DIRS[f][0], y + FACE_DIRS[f][1], lz + FACE_DIRS[f][2])) mask |= 1u << f;
+        }
+        chunk.faceMasks[i] = mask;
+    }
+}
+
+void PrepareChunkGeometry(const ChunkKey& key, ChunkData& chunk, const ChunkBorder& border)
+{
+    // 工作线程上完成渲染数据准备：贪心网格，或实例立方体的可见面掩码
+    if (g_useGreedyMeshing) BuildChunkMesh(key, chunk, border);
+    else ComputeChunkFaceMasks(key, chunk, border);
+    chunk.predictedSides = static_cast<std::uint8_t>(~border.loadedSides & CHUNK_ALL_SIDES);
+}
+
+namespace {
+
+constexpr int CHUNK_APRON = CHUNK_SIZE + 2;
+
+BlockType SurfaceTypeFor(int height)
+{
+    if (height < g_terrainParams.waterLevel) return BlockType::Sand;
+    if (height < g_terrainParams.waterLevel + g_terrainParams.beachHeight) return BlockType::Sand;
+    if (height > g_terrainParams.snowHeight) return BlockType::Snow;
+    return BlockType::Grass;
+}
+
+// 按世界列坐标决定是否种树，返回树高 (0 表示不种)：
+// 与区块无关，相邻区块对同一列得到相同的结果，越过边界的树冠由邻居补齐
+int TreeHeightAt(int wx, int wz)
+{
+    std::uint32_t h = static_cast<std::uint32_t>(wx) * 73856093u ^ static_cast<std::uint32_t>(wz) * 19349663u ^ WORLD_SEED;
+    h ^= h >> 16; h *= 0x7feb352du;
+    h ^= h >> 15; h *= 0x846ca68bu;
+    h ^= h >> 16;
+    float randVal = static_cast<float>(h % 1000) / 1000.0f;
+    if (randVal <= g_terrainParams.treeThreshold) return 0;
+    return 4 + static_cast<int>((h >> 10) % 3);
+}
+
+} // namespace
+
+ChunkData GenerateChunk(const ChunkKey& key)
+{
+    ChunkData chunk;
+    std::vector<PackedBlock> blocks;
+    blocks.reserve(CHUNK_SIZE * CHUNK_SIZE * 2);
+
+    // 高度多算一圈 (18x18)：外圈只用来放置树冠伸入本区块的邻居树木
+    float xs[CHUNK_APRON * CHUNK_APRON];
+    float zs[CHUNK_APRON * CHUNK_APRON];
+    float heights[CHUNK_APRON * CHUNK_APRON];
+    for (int ax = 0; ax < CHUNK_APRON; ++ax) {
+        for (int az = 0; az < CHUNK_APRON; ++az) {
+            int idx = ax * CHUNK_APRON + az;
+            xs[idx] = (key.x * CHUNK_SIZE + ax - 1) * g_terrainParams.baseFrequency;
+            zs[idx] = (key.z * CHUNK_SIZE + az - 1) * g_terrainParams.baseFrequency;
+        }
+    }
+    g_perlin.fbmBatch(xs, zs, heights, CHUNK_APRON * CHUNK_APRON, g_terrainParams.baseOctaves);
+    for (float& h : heights) h *= g_terrainParams.baseAmplitude;
+    for (int lx = 0; lx < CHUNK_SIZE; ++lx) {
+        for (int lz = 0; lz < CHUNK_SIZE; ++lz) {
+            chunk.heights.Set(lx * CHUNK_SIZE + lz, heights[(lx + 1) * CHUNK_APRON + (lz + 1)]);
+        }
+    }
+
+    auto addBlock = [&](int bx, int by, int bz, BlockType type) {
+        blocks.push_back(MakePackedBlock(bx, by, bz, type));
+    };
+
+    for (int lx = -1; lx <= CHUNK_SIZE; ++lx) {
+        for (int lz = -1; lz <= CHUNK_SIZE; ++lz) {
+            float h = heights[(lx + 1) * CHUNK_APRON + (lz + 1)];
+            int height = static_cast<int>(std::floor(h));
+            bool own = lx >= 0 && lx < CHUNK_SIZE && lz >= 0 && lz < CHUNK_SIZE;
+
+            // 只生成地表与水面，减少实例数量
+            BlockType surfaceType = SurfaceTypeFor(height);
+            if (own) {
+                addBlock(lx, height, lz, surfaceType);
+
+                // 水面（仅一层水面，进一步减少数据）
+                if (height < g_terrainParams.waterLevel) {
+                    addBlock(lx, static_cast<int>(g_terrainParams.waterLevel), lz, BlockType::Water);
+                }
+            }
+
+            // 树木仅在草地表面生成
+            if (surfaceType != BlockType::Grass) continue;
+            int treeHeight = TreeHeightAt(key.x * CHUNK_SIZE + lx, key.z * CHUNK_SIZE + lz);
+            if (treeHeight == 0) continue;
+            if (own) {
+                for (int th = 1; th <= treeHeight; ++th) {
+                    addBlock(lx, height + th, lz, BlockType::Wood);
+                }
+            }
+            // 树冠向四周伸出一格：只写本区块的列，伸出去的部分由相邻区块生成时补上
+            for (int lx2 = -1; lx2 <= 1; ++lx2) {
+                for (int lz2 = -1; lz2 <= 1; ++lz2) {
+                    int leafX = lx + lx2;
+                    int leafZ = lz + lz2;
+                    if (leafX < 0 || leafX >= CHUNK_SIZE || leafZ < 0 || leafZ >= CHUNK_SIZE) continue;
+                    for (int ly2 = 0; ly2 <= 1; ++ly2) {
+                        if (lx2 == 0 && lz2 == 0 && ly2 == 0) continue;
+                        addBlock(leafX, height + treeHeight + ly2, leafZ, BlockType::Leaves);
+                    }
+                }
+            }
+        }
+    }
+
+    BuildChunkFromBlocks(key, std::move(blocks), chunk);
+    return chunk;
+}
+
+static_assert(ChunkOccupancy::SIZE == CHUNK_SIZE, "Collision occupancy must match chunk size");
+
+void RegisterChunkCollision(const ChunkKey& key, const ChunkVoxels& voxels)
+{
+    PW_PROFILE_ZONE("RegisterChunkCollision");
+    ChunkOccupancy occupancy(voxels.minY, voxels.maxY);
+    for (const auto& b : voxels.blocks) {
+        occupancy.Set(b.lx(), b.y, b.lz());
+    }
+    g_collisionWorld.SetChunk(key, std::move(occupancy));
+}
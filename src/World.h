@@ -0,0 +1,338 @@
+#pragma once
+
+#include "ChunkGrid.h"
+#include "ChunkMesh.h"
+#include "ChunkMesher.h"
+#include "ChunkTable.h"
+#include "CollisionWorld.h"
+#include "Perlin2D.h"
+#include "RegionCache.h"
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// ============================================================================
+// 体素世界：地形生成、区块方块存储、高度查询与射线检测
+// 不依赖窗口系统，主程序与基准测试程序 (PixelWarBench) 共用
+// ============================================================================
+
+enum class BlockType : std::uint8_t {
+    Air = 0,
+    Water,
+    Sand,
+    Grass,
+    Dirt,
+    Stone,
+    Snow,
+    Wood,
+    Leaves
+};
+constexpr int BLOCK_TYPE_COUNT = 9;
+
+struct TerrainParams {
+    float baseAmplitude = 30.0f;     
+    float baseFrequency = 0.02f;   
+    int   baseOctaves   = 4;
+
+    float waterLevel = 5.0f;
+    float beachHeight = 2.0f;        
+    float snowHeight  = 22.0f;      
+
+    float treeThreshold = 0.985f; // 只有非常高的随机值才生成树
+};
+
+inline float terrainHeight(const Perlin2D& perlin, const TerrainParams& tp, int x, int z)
+{
+    float nx = x * tp.baseFrequency;
+    float nz = z * tp.baseFrequency;
+    float h01 = perlin.fbm(nx, nz, tp.baseOctaves); 
+    return h01 * tp.baseAmplitude;
+}
+
+inline glm::vec3 getBlockColor(BlockType t)
+{
+    switch (t) {
+        case BlockType::Water:  return glm::vec3(0.0f, 0.4f, 0.8f);
+        case BlockType::Sand:   return glm::vec3(0.9f, 0.85f, 0.6f);
+        case BlockType::Grass:  return glm::vec3(0.2f, 0.6f, 0.2f);
+        case BlockType::Dirt:   return glm::vec3(0.4f, 0.25f, 0.15f);
+        case BlockType::Stone:  return glm::vec3(0.5f, 0.5f, 0.5f);
+        case BlockType::Snow:   return glm::vec3(0.95f, 0.95f, 0.98f);
+        case BlockType::Wood:   return glm::vec3(0.4f, 0.2f, 0.1f);
+        case BlockType::Leaves: return glm::vec3(0.1f, 0.5f, 0.1f);
+        default:                return glm::vec3(1.0f);
+    }
+}
+
+constexpr int CHUNK_SIZE = 16;
+constexpr std::uint32_t WORLD_SEED = 12345;
+
+using HeightTile = std::array<float, CHUNK_SIZE * CHUNK_SIZE>; // 下标 lx * CHUNK_SIZE + lz
+
+static_assert(CHUNK_SIZE == 16, "PackedBlock 用 4 位存储区块内列坐标");
+
+// 区块内的单个方块 (4 字节)：列坐标 (lx << 4 | lz) + 方块类型 + 高度，颜色由 getBlockColor 查表
+// 与磁盘缓存的 RegionBlockRecord 布局相同
+struct PackedBlock {
+    std::uint8_t column;
+    BlockType type;
+    std::int16_t y;
+
+    int lx() const { return column >> 4; }
+    int lz() const { return column & 0xF; }
+};
+static_assert(sizeof(PackedBlock) == 4, "PackedBlock must stay 4 bytes");
+
+inline PackedBlock MakePackedBlock(int lx, int y, int lz, BlockType type)
+{
+    return { static_cast<std::uint8_t>((lx << 4) | lz), type, static_cast<std::int16_t>(y) };
+}
+
+// 区块唯一的方块存储：按 (列, y) 排序的紧凑方块表 + 每列的起始下标
+// 渲染、碰撞按顺序遍历 blocks；射线等点查询从列底、列顶按 y 偏移直接定位
+struct ChunkVoxels {
+    static constexpr int COLUMN_COUNT = CHUNK_SIZE * CHUNK_SIZE;
+    static constexpr int GROUP_COLUMNS = 16;
+    static constexpr int GROUP_COUNT = COLUMN_COUNT / GROUP_COLUMNS;
+
+    std::vector<PackedBlock> blocks;
+    // 列起始下标 = groupStart[列 / 16] + columnOffset[列] (末项对应 blocks.size())：
+    // 每 16 列一个 2 字节基址，组内每列 1 字节偏移。组内方块超过 255 个 (编辑造成) 时改用 wideStart
+    std::array<std::uint16_t, GROUP_COUNT + 1> groupStart{};
+    std::array<std::uint8_t, COLUMN_COUNT + 1> columnOffset{};
+    std::vector<std::uint16_t> wideStart;
+    // 多于两段 y 连续方块的列 (编辑造成)，查询时二分查找
+    std::bitset<COLUMN_COUNT> multiRun;
+    int minY = 0;
+    int maxY = -1; // minY > maxY 表示空区块
+
+    int ColumnBegin(int column) const {
+        if (!wideStart.empty()) return wideStart[column];
+        return groupStart[static_cast<unsigned>(column) / GROUP_COLUMNS] + columnOffset[column];
+    }
+    int ColumnEnd(int column) const { return ColumnBegin(column + 1); }
+
+    // 常驻的索引字节数 (不含 blocks)
+    size_t IndexBytes() const {
+        return sizeof(groupStart) + sizeof(columnOffset) + sizeof(multiRun) + wideStart.size() * sizeof(std::uint16_t);
+    }
+
+    BlockType Get(int lx, int y, int lz) const {
+        if (y < minY || y > maxY) return BlockType::Air;
+        int column = (lx << 4) | lz;
+        int begin = ColumnBegin(column);
+        int end = ColumnEnd(column);
+        if (begin == end) return BlockType::Air;
+        // 第一段从列底按 y 偏移定位，最后一段从列顶倒推 (偏移都夹在本列内)；
+        // 不超过两段的列两处都不命中即为空气
+        unsigned last = static_cast<unsigned>(end - begin - 1);
+        const PackedBlock& lower = blocks[begin + std::min(static_cast<unsigned>(y - blocks[begin].y), last)];
+        if (lower.y == y) return lower.type;
+        const PackedBlock& upper = blocks[end - 1 - std::min(static_cast<unsigned>(blocks[end - 1].y - y), last)];
+        if (upper.y == y) return upper.type;
+        return multiRun[column] ? FindInColumn(begin, end, y) : BlockType::Air;
+    }
+
+    // 多段列的二分查找 (编辑造成，很少走到)
+    BlockType FindInColumn(int begin, int end, int y) const;
+
+    bool IsSolid(int lx, int y, int lz) const {
+        return Get(lx, y, lz) != BlockType::Air;
+    }
+};
+
+// 区块高度图 (每列 2 字节)：1/128 定点数，向下取整量化，保证 floor(h) 与原始高度一致
+struct ChunkHeights {
+    static constexpr float SCALE = 128.0f;
+    std::array<std::uint16_t, CHUNK_SIZE * CHUNK_SIZE> values{}; // 下标 lx * CHUNK_SIZE + lz
+
+    float Get(int index) const { return static_cast<float>(values[index]) / SCALE; }
+
+    void Set(int index, float h) {
+        values[index] = static_cast<std::uint16_t>(Quantize(h) * SCALE);
+    }
+
+    // 与存储后再读出的值相同
+    static float Quantize(float h) {
+        float q = std::floor(h * SCALE);
+        return std::min(std::max(q, 0.0f), 65535.0f) / SCALE;
+    }
+};
+
+inline glm::vec3 BlockWorldPosition(const ChunkKey& key, const PackedBlock& b)
+{
+    return glm::vec3(static_cast<float>(key.x * CHUNK_SIZE + b.lx()),
+                     static_cast<float>(b.y),
+                     static_cast<float>(key.z * CHUNK_SIZE + b.lz()));
+}
+
+struct ChunkData {
+    ChunkVoxels voxels;    // 渲染、碰撞、射线检测共用的方块存储
+    ChunkHeights heights;  // 生成时计算的高度图，供 SampleTerrainHeight 查询
+    int instanceSlot = -1; // 在 g_terrainMesh 实例缓冲中的槽位 (实例立方体模式)
+    std::vector<GLuint> faceMasks;    // 工作线程计算的可见面掩码 (与 voxels.blocks 对应)，上传后释放
+    size_t visibleFaces = 0;          // 掩码中可见面的总数
+    glm::vec3 boundsMin = glm::vec3(0.0f); // 世界空间 AABB (覆盖所有存储的方块)，用于视锥剔除
+    glm::vec3 boundsMax = glm::vec3(0.0f);
+    ChunkMeshData meshData;           // 工作线程生成的贪心网格，上传后释放
+    std::unique_ptr<ChunkMesh> mesh;  // 贪心网格模式下的 GPU 网格
+    std::uint8_t predictedSides = 0;  // 渲染数据生成时未加载、按噪声预测的相邻边 (位 = CHUNK_SIDE_*)
+    std::uint64_t geometrySerial = 0; // 渲染数据对应的任务序号，较旧的重建结果直接丢弃
+    std::uint64_t editSerial = 0;     // 最近一次玩家编辑的任务序号 (相邻区块据此判断抓取的边缘是否过期)
+};
+
+// 区块的四条边，相对的边下标异或 1
+enum ChunkSide { CHUNK_SIDE_NEG_X = 0, CHUNK_SIDE_POS_X, CHUNK_SIDE_NEG_Z, CHUNK_SIDE_POS_Z, CHUNK_SIDE_COUNT };
+constexpr int CHUNK_ALL_SIDES = (1 << CHUNK_SIDE_COUNT) - 1;
+
+inline ChunkKey ChunkNeighbour(const ChunkKey& key, int side)
+{
+    static const int OFFSETS[CHUNK_SIDE_COUNT][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+    return { key.x + OFFSETS[side][0], key.z + OFFSETS[side][1] };
+}
+
+// 区块 side 边上第 i 列 (沿边方向) 的区块内坐标
+inline void ChunkEdgeColumn(int side, int i, int& lx, int& lz)
+{
+    switch (side) {
+        case CHUNK_SIDE_NEG_X: lx = 0;              lz = i; break;
+        case CHUNK_SIDE_POS_X: lx = CHUNK_SIZE - 1; lz = i; break;
+        case CHUNK_SIDE_NEG_Z: lx = i; lz = 0;              break;
+        default:               lx = i; lz = CHUNK_SIZE - 1; break;
+    }
+}
+
+// 相邻区块紧贴本区块的边缘列：主线程提交生成/重建任务时抓取，工作线程据此剔除边界上的面。
+// 未加载的一侧在工作线程按噪声预测列顶，结果记入 ChunkData::predictedSides
+struct ChunkBorder {
+    struct Block {
+        std::uint8_t side;
+        std::uint8_t i;   // 沿边方向的列坐标
+        std::int16_t y;
+    };
+    std::uint8_t loadedSides = 0;                              // 位 = CHUNK_SIDE_*
+    std::array<int, CHUNK_SIDE_COUNT * CHUNK_SIZE> columnTops{}; // 下标 side * CHUNK_SIZE + i
+    std::vector<Block> blocks;                                 // 高于列顶的方块 (树木、放置的方块)
+};
+
+// 未加载区块的高度图 LRU 缓存 (仅主线程访问)
+// 容量随视距调整：覆盖视距窗口及外面一圈，窗口内尚未加载的区块都能命中 (每块 1 KB，视距 32 时约 4.4 MB)
+struct HeightTileCache {
+    static constexpr size_t DEFAULT_CAPACITY = 64;
+
+    static size_t CapacityForRadius(int radius) {
+        size_t side = static_cast<size_t>(2 * radius + 3);
+        return side * side;
+    }
+
+    size_t capacity = DEFAULT_CAPACITY;
+    std::list<ChunkKey> order; // 最近使用的在前
+    std::unordered_map<ChunkKey, std::pair<HeightTile, std::list<ChunkKey>::iterator>, ChunkKeyHash> tiles;
+
+    const HeightTile* Find(const ChunkKey& key) {
+        auto it = tiles.find(key);
+        if (it == tiles.end()) return nullptr;
+        order.splice(order.begin(), order, it->second.second);
+        return &it->second.first;
+    }
+
+    HeightTile& Insert(const ChunkKey& key) {
+        if (tiles.size() >= capacity) EvictOldest();
+        order.push_front(key);
+        auto& entry = tiles[key];
+        entry.second = order.begin();
+        return entry.first;
+    }
+
+    // 缩小时立即淘汰最久未用的高度图
+    void SetCapacity(size_t newCapacity) {
+        capacity = std::max<size_t>(newCapacity, 1);
+        while (tiles.size() > capacity) EvictOldest();
+    }
+
+    void Clear() {
+        order.clear();
+        tiles.clear();
+    }
+
+    void EvictOldest() {
+        tiles.erase(order.back());
+        order.pop_back();
+    }
+};
+
+// 射线结构体
+struct Ray
+{
+    glm::vec3 origin;
+    glm::vec3 direction;
+};
+
+// 体素射线检测结果
+struct VoxelHit
+{
+    bool hit = false;
+    int x = 0, y = 0, z = 0;          // 命中方块的整数坐标 (方块中心)
+    float t = 0.0f;                   // 沿射线的命中距离 (方向已归一化)
+    glm::vec3 normal = glm::vec3(0.0f); // 射线进入方块的面法线
+};
+
+// 世界状态 (除注明外仅主线程访问)
+extern Perlin2D g_perlin;               // 工作线程只读
+extern TerrainParams g_terrainParams;   // 工作线程只读
+extern ChunkGrid<ChunkData> g_loadedChunks; // 视距窗口内的区块 (环形槽位数组)
+extern HeightTileCache g_heightTileCache;
+extern CollisionWorld g_collisionWorld;  // 已加载区块的占用位图 (物理碰撞)
+extern bool g_useGreedyMeshing;         // 启动时由设置决定，运行中不切换
+extern RegionCache* g_regionCache;      // 区块磁盘缓存 (工作线程读取，后台线程写入)
+
+ChunkKey WorldToChunk(const glm::vec3& pos);
+
+// 地形高度：已加载区块读高度图，否则查 LRU 或整块批量计算 (仅主线程)；两条路径都返回 1/128 量化后的高度
+float SampleTerrainHeight(int x, int z);
+void ComputeChunkHeights(const ChunkKey& key, float* outHeights);
+BlockType GetTerrainBlock(int x, int y, int z);
+
+/**
+ * @brief 射线与 AABB 相交检测 (Slab Method)
+ * @param ray 射线
+ * @param boxMin AABB 最小点
+ * @param boxMax AABB 最大点
+ * @param t 返回相交距离
+ * @return 是否相交
+ */
+bool intersectRayAABB(const Ray& ray, const glm::vec3& invDir, const glm::vec3& boxMin, const glm::vec3& boxMax, float& t);
+
+// 3D DDA 体素射线检测 (射击使用)；Stepped 为旧版定步长实现，仅用于基准对比
+VoxelHit RaycastVoxels(const glm::vec3& origin, const glm::vec3& dir, float maxDist);
+VoxelHit RaycastVoxelsStepped(const glm::vec3& origin, const glm::vec3& dir, float maxDist);
+
+// 区块生成 (可在工作线程调用)
+std::uint32_t ComputeWorldTag();
+RegionChunkRecord EncodeChunkRecord(const ChunkData& chunk);
+ChunkData GenerateChunk(const ChunkKey& key);
+ChunkData LoadOrGenerateChunk(const ChunkKey& key);
+void BuildChunkFromBlocks(const ChunkKey& key, std::vector<PackedBlock> blocks, ChunkData& chunk);
+// 修改区块内的单个方块并重建方块表 (不涉及 GPU 资源与磁盘缓存)，方块未变化时返回 false
+bool EditChunkBlock(const ChunkKey& key, ChunkData& chunk, int lx, int y, int lz, BlockType type);
+// 列顶：地表只存储表层方块，列顶及以下视为实心 (隐式地基)
+int ColumnTop(const ChunkData& chunk, int lx, int lz);
+// 仅主线程：读取 key 四周已加载区块的边缘列
+ChunkBorder CaptureChunkBorder(const ChunkKey& key);
+// 区块 side 边的实际边缘列是否与噪声预测不同 (方块被编辑，或边缘列有树木等高于列顶的方块)
+bool ChunkEdgeDiffersFromPrediction(const ChunkData& chunk, int side);
+void BuildChunkMesh(const ChunkKey& key, ChunkData& chunk, const ChunkBorder& border);
+void ComputeChunkFaceMasks(const ChunkKey& key, ChunkData& chunk, const ChunkBorder& border);
+void PrepareChunkGeometry(const ChunkKey& key, ChunkData& chunk, const ChunkBorder& border);
+
+// 区块加载/编辑后更新其碰撞占用位图，卸载时由调用方 RemoveChunk
+void RegisterChunkCollision(const ChunkKey& key, const ChunkVoxels& voxels);
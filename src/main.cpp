@@ -42,6 +42,20 @@
 #include "EnemyPool.h"
 #include "AIDirector.h"
 #include "Settings.h"
+#include "ChunkWorkerPool.h"
+#include "Perlin2D.h"
+#include "RegionCache.h"
+#include "ChunkMesher.h"
+#include "ChunkMesh.h"
+#include "Frustum.h"
+#include "ChunkTable.h"
+#include "ChunkGrid.h"
+#include "LockFreeRing.h"
+#include "LockWaitStats.h"
+#include "World.h"
+#include "FlythroughBench.h"
+#include "Profiler.h"
+#include "PerfHud.h"
 #include <vector>
 #include <random>
 #include <cstdint>
@@ -51,160 +65,24 @@
 #include <sstream>
 #include <unordered_map>
 #include <unordered_set>
-#include <queue>
-#include <mutex>
-#include <thread>
-#include <condition_variable>
+#include <array>
+#include <list>
+#include <memory>
+#include <bitset>
+#include <atomic>
 #include <cstdio>
-
-// ------------------------- Perlin Noise 2D ----------------------------------
-struct Perlin2D {
-    std::uint8_t p[512];
-
-    explicit Perlin2D(std::uint32_t seed = 1337u) {
-        // Simple LCG to shuffle permutation deterministically by seed.
-        std::uint8_t perm[256];
-        for (int i = 0; i < 256; ++i) perm[i] = static_cast<std::uint8_t>(i);
-
-        auto lcg = [s = seed]() mutable -> std::uint32_t {
-            s = s * 1664525u + 1013904223u;
-            return s;
-        };
-
-        for (int i = 255; i > 0; --i) {
-            int j = static_cast<int>(lcg() % (i + 1));
-            std::uint8_t tmp = perm[i];
-            perm[i] = perm[j];
-            perm[j] = tmp;
-        }
-        for (int i = 0; i < 256; ++i) {
-            p[i] = perm[i];
-            p[i + 256] = perm[i];
-        }
-    }
-
-    static float fade(float t) {
-        return t * t * t * (t * (t * 6.f - 15.f) + 10.f); // 6t^5 - 15t^4 + 10t^3
-    }
-
-    static float lerp(float a, float b, float t) {
-        return a + t * (b - a);
-    }
-
-    static float grad2(int hash, float x, float y) {
-        // 8 gradient directions
-        switch (hash & 7) {
-            case 0: return  x + y;
-            case 1: return -x + y;
-            case 2: return  x - y;
-            case 3: return -x - y;
-            case 4: return  x;
-            case 5: return -x;
-            case 6: return  y;
-            default: return -y;
-        }
-    }
-
-    // 2D Perlin noise in [-1, 1]
-    float noise(float x, float y) const {
-        int X = static_cast<int>(std::floor(x)) & 255;
-        int Y = static_cast<int>(std::floor(y)) & 255;
-
-        float xf = x - std::floor(x);
-        float yf = y - std::floor(y);
-
-        float u = fade(xf);
-        float v = fade(yf);
-
-        int aa = p[p[X] + Y];
-        int ab = p[p[X] + Y + 1];
-        int ba = p[p[X + 1] + Y];
-        int bb = p[p[X + 1] + Y + 1];
-
-        float x1 = lerp(grad2(aa, xf,     yf    ),
-                        grad2(ba, xf-1.f, yf    ), u);
-        float x2 = lerp(grad2(ab, xf,     yf-1.f),
-                        grad2(bb, xf-1.f, yf-1.f), u);
-
-        return lerp(x1, x2, v); // [-1,1] ish
-    }
-
-    // Fractal Brownian Motion (FBM) using multiple octaves of 2D noise.
-    float fbm(float x, float y, int octaves = 5,
-              float lacunarity = 2.0f, float gain = 0.5f) const
-    {
-        float sum = 0.0f;
-        float amp = 1.0f;
-        float freq = 1.0f;
-        float maxSum = 0.0f;
-
-        for (int i = 0; i < octaves; ++i) {
-            sum += noise(x * freq, y * freq) * amp;
-            maxSum += amp;
-            freq *= lacunarity;
-            amp  *= gain;
-        }
-        // Normalize to [0,1]
-        return 0.5f * (sum / maxSum + 1.0f);
-    }
-};
-
-enum class BlockType : std::uint8_t {
-    Air = 0,
-    Water,
-    Sand,
-    Grass,
-    Dirt,
-    Stone,
-    Snow,
-    Wood,
-    Leaves
-};
-
-struct TerrainParams {
-    float baseAmplitude = 30.0f;     
-    float baseFrequency = 0.02f;   
-    int   baseOctaves   = 4;
-
-    float waterLevel = 5.0f;
-    float beachHeight = 2.0f;        
-    float snowHeight  = 22.0f;      
-
-    float treeThreshold = 0.985f; // 只有非常高的随机值才生成树
-};
-
-inline float terrainHeight(const Perlin2D& perlin, const TerrainParams& tp, int x, int z)
-{
-    float nx = x * tp.baseFrequency;
-    float nz = z * tp.baseFrequency;
-    float h01 = perlin.fbm(nx, nz, tp.baseOctaves); 
-    return h01 * tp.baseAmplitude;
-}
-
-inline glm::vec3 getBlockColor(BlockType t)
-{
-    switch (t) {
-        case BlockType::Water:  return glm::vec3(0.0f, 0.4f, 0.8f);
-        case BlockType::Sand:   return glm::vec3(0.9f, 0.85f, 0.6f);
-        case BlockType::Grass:  return glm::vec3(0.2f, 0.6f, 0.2f);
-        case BlockType::Dirt:   return glm::vec3(0.4f, 0.25f, 0.15f);
-        case BlockType::Stone:  return glm::vec3(0.5f, 0.5f, 0.5f);
-        case BlockType::Snow:   return glm::vec3(0.95f, 0.95f, 0.98f);
-        case BlockType::Wood:   return glm::vec3(0.4f, 0.2f, 0.1f);
-        case BlockType::Leaves: return glm::vec3(0.1f, 0.5f, 0.1f);
-        default:                return glm::vec3(1.0f);
-    }
-}
+#include <chrono>
 
 // 全局地形生成器配置
-constexpr int CHUNK_SIZE = 16;
-constexpr int VIEW_DISTANCE_CHUNKS = 4; // 视距按区块数量限制，平衡性能
-constexpr float VIEW_DISTANCE_WORLD = static_cast<float>(CHUNK_SIZE * VIEW_DISTANCE_CHUNKS);
+constexpr int DEFAULT_VIEW_DISTANCE_CHUNKS = 4; // 视距按区块数量限制 (settings.ini 的 viewDistance，运行时可调)
+constexpr int MIN_VIEW_DISTANCE_CHUNKS = 2;
+constexpr int MAX_VIEW_DISTANCE_CHUNKS = 32;
+constexpr float ENEMY_ACTIVE_RADIUS = 64.0f;    // 敌人生成/回收半径上限，视距调大时不把敌人刷得太远
 constexpr int CHUNK_MERGE_PER_FRAME = 1;
-constexpr int CHUNK_REBUILD_BATCH = 8;
-constexpr float CHUNK_REBUILD_INTERVAL = 0.3f;
-Perlin2D g_perlin(12345);
-TerrainParams g_terrainParams;
+constexpr unsigned int CHUNK_MAX_IN_FLIGHT_PER_WORKER = 2; // 每个工作线程最多同时持有的请求数
+constexpr float CHUNK_FACING_BONUS = 2.0f;                 // 正前方区块的优先级加成 (以区块距离计)
+constexpr float CHUNK_RESCORE_FACING_COS = 0.866f;         // 朝向变化超过 30 度时重新评分
+constexpr const char* REGION_DIRECTORY = "world/regions"; // 区块磁盘缓存目录
 
 // ============================================================================
 // 配置常量定义
@@ -244,6 +122,7 @@ std::string g_sfxKillPath = "assets/sfx_kill.wav";
 // 射击相关配置
 constexpr float FIRE_RATE = 0.1f;       // 射速 (秒/发)
 constexpr float SPREAD_AMOUNT = 0.05f;  // 弹道散布程度
+constexpr float DIG_REACH = 6.0f;       // 右键挖掘的最远距离
 float g_lastShootTime = 0.0f;           // 上次射击时间
 
 struct BulletTrail {
@@ -259,6 +138,11 @@ Shader* g_lineShader = nullptr;
 unsigned int g_lineVAO = 0;
 unsigned int g_lineVBO = 0;
 
+// 性能 HUD (F3)
+PerfHud* g_perfHud = nullptr;
+size_t g_uploadBytesThisFrame = 0; // 本帧上传的区块网格/实例与轨迹顶点字节数
+size_t g_drawnInstances = 0;       // 本帧提交的地形实例 (贪心网格为四边形) 与敌人数
+
 #include <random>
 
 // 渲染配置参数
@@ -277,6 +161,7 @@ GLFWwindow* g_window = nullptr;
 // 程序运行状态标志
 bool g_running = true;
 bool g_isPaused = false; // 暂停状态
+bool g_headless = false; // 无窗口模拟 (--headless)：不创建 GLFW 窗口与 GL 上下文
 
 // 全局摄像机对象
 Camera g_camera(glm::vec3(0.0f, 2.0f, 6.0f));
@@ -284,6 +169,7 @@ Camera g_camera(glm::vec3(0.0f, 2.0f, 6.0f));
 // 全局资源
 Shader* g_shader = nullptr;
 Shader* g_instancedShader = nullptr; 
+Shader* g_chunkShader = nullptr;     // 贪心网格地形 Shader
 Shader* g_crosshairShader = nullptr; // 准星 Shader
 Mesh* g_cubeMesh = nullptr; 
 InstancedMesh* g_terrainMesh = nullptr;
@@ -291,118 +177,74 @@ Mesh* g_planeMesh = nullptr;
 unsigned int g_crosshairVAO = 0, g_crosshairVBO = 0; // 准星资源
 unsigned int g_uiVAO = 0, g_uiVBO = 0; // UI 资源 (Quad)
 
-// 地形数据缓存 (用于物理碰撞)
-std::vector<glm::vec3> g_terrainPositions;
-
-
-// 全局资源
-// ... (其他资源)
-// ...
-
-// 游戏对象结构体
-struct CubeObject
-{
-    glm::vec3 position;
-    glm::vec3 color;
-    glm::vec3 scale;
-
-    // 获取 AABB
-    void getAABB(glm::vec3& min, glm::vec3& max) const
-    {
-        glm::vec3 halfSize = scale * 0.5f;
-        min = position - halfSize;
-        max = position + halfSize;
-    }
-};
-
-// 动态哈希空间网格，支持无限地图
-struct Int3 {
-    int x, y, z;
-    bool operator==(const Int3& other) const {
-        return x == other.x && y == other.y && z == other.z;
-    }
-};
-
-struct Int3Hash {
-    std::size_t operator()(const Int3& v) const noexcept {
-        std::size_t h1 = std::hash<int>()(v.x);
-        std::size_t h2 = std::hash<int>()(v.y);
-        std::size_t h3 = std::hash<int>()(v.z);
-        return h1 ^ (h2 << 1) ^ (h3 << 2);
-    }
-};
-
-struct SpatialHash {
-    std::unordered_map<Int3, std::vector<CubeObject*>, Int3Hash> cells;
-
-    void Clear() { cells.clear(); }
-
-    void Add(CubeObject* cube) {
-        Int3 key{ (int)std::floor(cube->position.x), (int)std::floor(cube->position.y), (int)std::floor(cube->position.z) };
-        cells[key].push_back(cube);
-    }
-
-    std::vector<CubeObject*>* Get(int x, int y, int z) {
-        Int3 key{ x, y, z };
-        auto it = cells.find(key);
-        if (it != cells.end()) return &it->second;
-        return nullptr;
-    }
-};
-
-struct ChunkKey {
-    int x;
-    int z;
-    bool operator==(const ChunkKey& other) const noexcept {
-        return x == other.x && z == other.z;
-    }
+int g_viewDistanceChunks = DEFAULT_VIEW_DISTANCE_CHUNKS;
+float g_viewDistanceWorld = static_cast<float>(CHUNK_SIZE * DEFAULT_VIEW_DISTANCE_CHUNKS);
+size_t g_visibleInstanceCount = 0;
+size_t g_terrainQuadCount = 0;   // 贪心网格模式下所有区块的四边形总数
+size_t g_terrainBlockCount = 0;  // 贪心网格模式下的方块数 (对比实例立方体的面数)
+size_t g_visibleFaceCount = 0;   // 实例立方体模式下掩码中可见的面数
+
+// 区块视锥剔除 (每帧统计)
+Frustum g_frustum;
+std::vector<int> g_visibleSlots;   // 实例立方体模式下本帧可见的槽位
+int g_culledChunks = 0;
+size_t g_culledInstances = 0;      // 被剔除的实例数 (贪心网格模式下为四边形数)
+float g_cullStatsTimer = 0.0f;
+int g_cullStatsFrames = 0;
+size_t g_cullStatsChunks = 0;
+size_t g_cullStatsInstances = 0;
+
+// 区块异步加载 (多线程生成)
+ChunkWorkerPool* g_chunkPool = nullptr;
+
+// 工作线程完成的结果；cancelled 表示请求在开始生成前已被取消
+struct ChunkResult {
+    ChunkKey key;
+    ChunkData data;
+    std::uint64_t serial = 0; // 任务序号，决定渲染数据的新旧
+    bool cancelled = false;
+    bool remesh = false;      // 已加载区块的重建任务：data 中只有渲染数据有效
 };
-
-struct ChunkKeyHash {
-    std::size_t operator()(const ChunkKey& k) const noexcept {
-        std::size_t h1 = std::hash<int>()(k.x);
-        std::size_t h2 = std::hash<int>()(k.z);
-        return h1 ^ (h2 << 1);
-    }
+// 每个工作线程一个无锁结果环 (工作线程写入，主线程读取)。
+// 未取走的结果数不超过在途请求数，容量按在途上限分配，写入不会失败
+std::vector<std::unique_ptr<SpscRing<ChunkResult>>> g_chunkResultRings;
+size_t g_chunkResultCursor = 0; // 轮流读取各结果环的起点
+
+// 请求调度 (仅主线程访问)：待提交的请求放在按优先级排序的堆中，
+// 提交给线程池的请求数有上限，视角或所在区块变化时重新评分并丢弃过期请求
+struct PendingChunk {
+    ChunkKey key;
+    float score; // 越小越优先
 };
-
-struct ChunkData {
-    std::vector<glm::vec3> positions;
-    std::vector<glm::vec3> colors;
-    std::vector<CubeObject> cubes;
+std::vector<PendingChunk> g_chunkPending; // 小顶堆 (按 score)
+std::unordered_set<ChunkKey, ChunkKeyHash> g_chunkPendingSet;
+ChunkTable<std::shared_ptr<std::atomic<bool>>> g_chunkInFlight; // 值为取消标记 (可能已离开视距，不放在视距网格中)
+std::uint64_t g_chunkJobSerial = 0; // 每次提交生成/重建任务或编辑区块时递增
+// 相邻区块加载或编辑后边界面需要修正的已加载区块，与生成请求共享在途上限
+std::vector<ChunkKey> g_chunkRemeshQueue;
+std::unordered_set<ChunkKey, ChunkKeyHash> g_chunkRemeshSet;
+size_t g_chunkRemeshInFlight = 0;
+ChunkKey g_scheduleCenter{ std::numeric_limits<int>::min(), std::numeric_limits<int>::min() };
+glm::vec3 g_scheduleFront(0.0f);
+bool g_scheduleRescan = false; // 需要重新扫描整个视距窗口 (取消的请求回到视距内、视距半径变化)
+
+// 请求统计：浪费 = 生成完成但合并时已不需要
+struct ChunkRequestStats {
+    size_t generated = 0;  // 工作线程完成生成 (含磁盘缓存命中)
+    size_t merged = 0;
+    size_t wasted = 0;
+    size_t dropped = 0;    // 提交前从优先队列中丢弃
+    size_t cancelled = 0;  // 已提交但在开始生成前取消
 };
+ChunkRequestStats g_chunkStats;
 
-SpatialHash g_spatialHash;
-std::unordered_map<ChunkKey, ChunkData, ChunkKeyHash> g_loadedChunks;
-size_t g_visibleInstanceCount = 0;
-
-// 区块异步加载
-std::thread g_chunkThread;
-std::mutex g_chunkMutex;
-std::condition_variable g_chunkCV;
-std::queue<ChunkKey> g_chunkRequestQueue;
-std::queue<std::pair<ChunkKey, ChunkData>> g_chunkReadyQueue;
-std::unordered_set<ChunkKey, ChunkKeyHash> g_chunkLoading;
-bool g_chunkThreadExit = false;
-bool g_chunkThreadStarted = false;
-int g_pendingMergedChunks = 0;
-float g_rebuildTimer = 0.0f;
-
-// 游戏对象结构体 (Removed from here)
-// struct CubeObject ... 
-
-
-std::vector<CubeObject> g_cubes;
 // std::vector<Enemy> g_enemies; // 移除旧的 vector
 EnemyPool* g_enemyPool = nullptr;
 AIDirector* g_director = nullptr;
+std::mt19937 g_enemyRng(std::random_device{}()); // 敌人重新放置用 (基准测试时固定种子)
 
-// 射线结构体
-struct Ray
-{
-    glm::vec3 origin;
-    glm::vec3 direction;
-};
+// 持久化设置 (退出时回写)
+GameSettings g_settings;
 
 // 鼠标输入相关变量
 bool g_firstMouse = true;              // 首次鼠标移动标志
@@ -413,21 +255,55 @@ float g_lastY = WINDOW_HEIGHT / 2.0f;  // 上次鼠标 Y 位置
 // 时间相关变量
 float g_deltaTime = 0.0f;              // 当前帧与上一帧的时间差
 float g_lastFrame = 0.0f;               // 上一帧的时间
+float g_simTime = 0.0f;                 // 模拟时钟 (射速等逻辑计时；窗口模式取 glfwGetTime，无窗口模式按固定步长累加)
+
+// 帧分析 trace 输出路径 (--trace)；为空时 F9 按帧号命名，非空时退出前也自动导出
+std::string g_traceOutputPath;
+
+// 每帧各阶段耗时 (UpdateSimulation 开始时清零)
+FlythroughFrame g_frameTimings;
+
+// 飞行基准 (--bench-flythrough)：程序化路径驱动摄像机，逐帧记录耗时，报告路径为空时不启用
+std::string g_flythroughReportPath;
+FlythroughPath* g_flythroughPath = nullptr;
+FlythroughRecorder* g_flythroughRecorder = nullptr;
+float g_flythroughStartTime = -1.0f;
+int g_flythroughSegment = 0;
+constexpr float FLYTHROUGH_EYE_HEIGHT = 2.0f; // 路径贴地高度 (与出生点一致)
+
+// 无窗口模拟参数 (--headless [--frames N] [--dt S])
+struct HeadlessOptions {
+    int frames = 3600;              // 模拟帧数
+    float deltaTime = 1.0f / 60.0f; // 固定步长 (秒)
+};
 
 // ============================================================================
 // 函数原型声明
 // ============================================================================
 
 void FramebufferSizeCallback(GLFWwindow* window, int width, int height);
-ChunkKey WorldToChunk(const glm::vec3& pos);
-ChunkData GenerateChunk(const ChunkKey& key);
-void RebuildVisibleTerrain();
-void UpdateVisibleChunks(const glm::vec3& playerPos, bool force = false);
-float SampleTerrainHeight(int x, int z);
+bool SetTerrainBlock(int x, int y, int z, BlockType type);
+void UploadChunkGeometry(const ChunkKey& key, ChunkData& chunk);
+void ReleaseChunkGeometry(ChunkData& chunk);
+void UpdateVisibleChunks(const glm::vec3& playerPos);
+void RunRaycastBenchmark();
+void RunChunkMemoryReport();
+void RunChunkTableBenchmark();
 glm::vec3 GetRandomPointInView(const glm::vec3& center, float minRadius, float maxRadius);
 void EnforceEnemyViewDistance(const glm::vec3& playerPos);
-void ChunkLoaderThread();
-int ProcessReadyChunks(const std::unordered_set<ChunkKey, ChunkKeyHash>& needed, int maxPerFrame = CHUNK_MERGE_PER_FRAME);
+bool SubmitChunkRequest(const ChunkKey& key);
+bool SubmitChunkRemesh(const ChunkKey& key, const ChunkData& chunk);
+void QueueChunkRemesh(const ChunkKey& key);
+void CheckChunkBorders(const ChunkKey& key, const ChunkData& chunk, std::uint64_t serial);
+void ScheduleChunkRequests(const std::vector<ChunkKey>& entered, const ChunkKey& center, const glm::vec3& playerPos);
+int ProcessReadyChunks(int maxPerFrame = CHUNK_MERGE_PER_FRAME);
+void SetViewDistance(int chunks);
+void InitializeWorld();
+void UpdateSimulation();
+int RunHeadless(const HeadlessOptions& options);
+void StartFlythrough();
+bool UpdateFlythrough();
+void RecordFlythroughFrame(float frameMs);
 
 /**
  * @brief 初始化 GLFW 库和创建渲染窗口
@@ -453,19 +329,14 @@ bool InitializeWindow();
 bool InitializeGLAD();
 
 /**
- * @brief 射线与 AABB 相交检测 (Slab Method)
- * @param ray 射线
- * @param boxMin AABB 最小点
- * @param boxMax AABB 最大点
- * @param t 返回相交距离
- * @return 是否相交
+ * @brief 处理射击逻辑
  */
-bool intersectRayAABB(const Ray& ray, const glm::vec3& invDir, const glm::vec3& boxMin, const glm::vec3& boxMax, float& t);
+void ProcessShooting();
 
 /**
- * @brief 处理射击逻辑
+ * @brief 挖掉准星指向的地形方块 (右键，无散布)
  */
-void ProcessShooting();
+void DigTargetBlock();
 
 /**
  * @brief 处理鼠标点击事件的回调函数
@@ -562,6 +433,7 @@ void RenderLoop();
 
 // 全局函数声明
 void UpdateWindowTitle();
+void WriteProfilerTrace();
 void EnsureSfxFiles();
 void PlaySfxShoot();
 void PlaySfxHit();
@@ -655,6 +527,7 @@ void EnsureSfxFiles()
 
 void PlaySfx(const std::string& path)
 {
+    if (g_headless) return;
     PlaySoundA(path.c_str(), NULL, SND_FILENAME | SND_ASYNC | SND_NODEFAULT);
 }
 
@@ -688,6 +561,7 @@ void KeyCallback([[maybe_unused]] GLFWwindow* window, int key, [[maybe_unused]]
             std::cout << "  [Pause Menu] Controls:" << std::endl;
             std::cout << "  ↑ / ↓ : Adjust mouse sensitivity" << std::endl;
             std::cout << "  ← / → : Adjust field of view (FOV)" << std::endl;
+            std::cout << "  PgUp / PgDn : Adjust view distance (chunks)" << std::endl;
             std::cout << "  ESC   : Resume game" << std::endl;
             std::cout << "  Current resolution: " << g_resolutionLabel << std::endl;
             std::cout << "----------------------------------------" << std::endl;
@@ -707,6 +581,36 @@ void KeyCallback([[maybe_unused]] GLFWwindow* window, int key, [[maybe_unused]]
         }
     }
 
+    // 暂停菜单中调整视距 (按键触发一次，立即生效)
+    if (g_isPaused && (action == GLFW_PRESS || action == GLFW_REPEAT) &&
+        (key == GLFW_KEY_PAGE_UP || key == GLFW_KEY_PAGE_DOWN))
+    {
+        SetViewDistance(g_viewDistanceChunks + (key == GLFW_KEY_PAGE_UP ? 1 : -1));
+        UpdateWindowTitle();
+    }
+
+    // F3：切换性能 HUD
+    if (key == GLFW_KEY_F3 && action == GLFW_PRESS && g_perfHud)
+    {
+        g_perfHud->Toggle();
+    }
+
+    // F9：导出最近若干帧的 CPU/GPU 区段为 Chrome trace
+    if (key == GLFW_KEY_F9 && action == GLFW_PRESS)
+    {
+        WriteProfilerTrace();
+    }
+
+}
+
+void WriteProfilerTrace()
+{
+    if (!Profiler::IsCompiledIn()) {
+        std::cout << "[Profiler] Zones are compiled out in this build (configure with -DPIXELWAR_PROFILER=ON)" << std::endl;
+        return;
+    }
+    std::string path = g_traceOutputPath.empty() ? "trace_frame" + std::to_string(Profiler::GetFrameIndex()) + ".json" : g_traceOutputPath;
+    Profiler::WriteChromeTrace(path);
 }
 
 void UpdateWindowTitle()
@@ -714,9 +618,10 @@ void UpdateWindowTitle()
     if (!g_window) return;
     char title[256];
     const char* resLabel = g_resolutionLabel.c_str();
-    snprintf(title, sizeof(title), "[Paused] Settings - Sensitivity: %.2f (↑↓) | FOV: %.1f (←→) | Res: %s", 
+    snprintf(title, sizeof(title), "[Paused] Settings - Sensitivity: %.2f (↑↓) | FOV: %.1f (←→) | View: %d chunks (PgUp/PgDn) | Res: %s",
              g_camera.GetMouseSensitivity(), 
              g_camera.GetFOV(),
+             g_viewDistanceChunks,
              resLabel);
     glfwSetWindowTitle(g_window, title);
 }
@@ -759,7 +664,7 @@ void WindowCloseCallback([[maybe_unused]] GLFWwindow* window)
     std::cout << "[Window Event] Close request received, shutting down gracefully..." << std::endl;
 }
 
-void MouseButtonCallback([[maybe_unused]] GLFWwindow* window, [[maybe_unused]] int button, [[maybe_unused]] int action, [[maybe_unused]] int mods)
+void MouseButtonCallback([[maybe_unused]] GLFWwindow* window, int button, int action, [[maybe_unused]] int mods)
 {
     // 暂停时不处理射击
     if (g_isPaused) return;
@@ -769,13 +674,23 @@ void MouseButtonCallback([[maybe_unused]] GLFWwindow* window, [[maybe_unused]] i
     // {
     //     ProcessShooting();
     // }
+
+    if (button == GLFW_MOUSE_BUTTON_RIGHT && action == GLFW_PRESS) DigTargetBlock();
+}
+
+void DigTargetBlock()
+{
+    VoxelHit hit = RaycastVoxels(g_camera.GetPosition(), g_camera.GetFront(), DIG_REACH);
+    if (!hit.hit) return;
+    SetTerrainBlock(hit.x, hit.y, hit.z, BlockType::Air);
 }
 
 void ProcessShooting()
 {
-    float currentTime = (float)glfwGetTime();
+    float currentTime = g_simTime;
     if (currentTime - g_lastShootTime < FIRE_RATE) return;
     g_lastShootTime = currentTime;
+    PW_PROFILE_ZONE("ProcessShooting");
     PlaySfxShoot();
 
     // 1. 创建射线
@@ -805,54 +720,28 @@ void ProcessShooting()
     g_isShooting = true; 
 
     float closestT = std::numeric_limits<float>::max();
-    CubeObject* hitCube = nullptr;
-    Enemy* hitEnemy = nullptr;
+    bool hitTerrain = false;
+    Enemy hitEnemy;
 
-    // 2. 射线步进 (Voxel Traversal / DDA 简化版)
-    glm::vec3 samplePos = ray.origin;
-    glm::vec3 step = ray.direction * 0.5f; // 步长 0.5
-    float currentDist = 0.0f;
     const float MAX_DIST = 80.0f; // 最大射程
 
-    // 2.1 快速地形检测 (Spatial Grid)
-    while (currentDist < MAX_DIST) {
-        int x = (int)std::floor(samplePos.x);
-        int y = (int)std::floor(samplePos.y);
-        int z = (int)std::floor(samplePos.z);
-        
-        auto* cell = g_spatialHash.Get(x, y, z);
-        if (cell && !cell->empty()) {
-            // 这个格子有方块，详细检测 AABB
-            for (auto* cube : *cell) {
-                glm::vec3 min, max;
-                cube->getAABB(min, max);
-                
-                float t = 0.0f;
-                if (intersectRayAABB(ray, invDir, min, max, t)) {
-                    if (t < closestT) {
-                        closestT = t;
-                        hitCube = cube;
-                        goto CheckEnemies; // 跳转到敌人检测
-                    }
-                }
-            }
-        }
-        
-        samplePos += step;
-        currentDist += 0.5f;
+    // 2. 地形检测：3D DDA 精确遍历射线穿过的体素，遇到第一个实心方块即停止
+    VoxelHit terrainHit = RaycastVoxels(ray.origin, ray.direction, MAX_DIST);
+    if (terrainHit.hit) {
+        closestT = terrainHit.t;
+        hitTerrain = true;
     }
 
-CheckEnemies:
     // 3. 遍历所有敌人
     const auto& activeEnemies = g_enemyPool->GetActiveEnemies();
-    for (auto enemy : activeEnemies)
+    for (const Enemy& enemy : activeEnemies)
     {
-        if (!enemy->IsActive()) continue;
+        if (!enemy.IsActive()) continue;
 
-        if (glm::distance(g_camera.GetPosition(), enemy->GetPosition()) > MAX_DIST) continue;
+        if (glm::distance(g_camera.GetPosition(), enemy.GetPosition()) > MAX_DIST) continue;
 
         glm::vec3 min, max;
-        enemy->getAABB(min, max);
+        enemy.getAABB(min, max);
 
         float t = 0.0f;
         if (intersectRayAABB(ray, invDir, min, max, t))
@@ -861,19 +750,15 @@ CheckEnemies:
             {
                 closestT = t;
                 hitEnemy = enemy;
-                hitCube = nullptr; // 敌人比地形更近
+                hitTerrain = false; // 敌人比地形更近
             }
         }
     }
 
-    // 4. 处理击中反馈
-    if (hitCube)
+    // 4. 处理击中反馈 (击中地形时子弹止于命中点)
+    if (!hitTerrain && hitEnemy.IsValid())
     {
-        hitCube->color = glm::vec3(1.0f, 0.0f, 0.0f); // 变红
-    }
-    else if (hitEnemy)
-    {
-        bool killed = hitEnemy->TakeDamage(BULLET_DAMAGE); 
+        bool killed = hitEnemy.TakeDamage(BULLET_DAMAGE); 
         if (killed) PlaySfxKill();
         else PlaySfxHit();
     }
@@ -893,230 +778,298 @@ CheckEnemies:
     g_bulletTrails.push_back(trail);
 }
 
-bool intersectRayAABB(const Ray& ray, const glm::vec3& invDir, const glm::vec3& boxMin, const glm::vec3& boxMax, float& t)
+void RunRaycastBenchmark()
 {
-    // Slab Method 实现 (使用预计算的 invDir)
-    glm::vec3 tMin = (boxMin - ray.origin) * invDir;
-    glm::vec3 tMax = (boxMax - ray.origin) * invDir;
-    
-    glm::vec3 t1 = glm::min(tMin, tMax);
-    glm::vec3 t2 = glm::max(tMin, tMax);
-    
-    float tNear = glm::max(glm::max(t1.x, t1.y), t1.z);
-    float tFar = glm::min(glm::min(t2.x, t2.y), t2.z);
-    
-    if (tNear > tFar || tFar < 0.0f)
-    {
-        return false;
+    std::cout << "[Bench] Raycast: DDA vs fixed 0.5 stepper (dense forest)" << std::endl;
+
+    // 密林场景：提高树木密度，同步生成视距内所有区块
+    g_terrainParams.treeThreshold = 0.9f;
+    g_loadedChunks.Clear();
+    g_loadedChunks.SetRadius(g_viewDistanceChunks, [](const ChunkKey&, ChunkData&) {});
+    g_loadedChunks.ForEachInView([](const ChunkKey& key) { g_loadedChunks.Insert(key, GenerateChunk(key)); });
+
+    const int RAY_COUNT = 20000;
+    const float MAX_DIST = 80.0f;
+    std::mt19937 rng(1234u);
+    std::uniform_real_distribution<float> posDist(-g_viewDistanceWorld * 0.5f, g_viewDistanceWorld * 0.5f);
+    std::uniform_real_distribution<float> angleDist(0.0f, 6.2831853f);
+    std::uniform_real_distribution<float> pitchDist(-0.6f, 0.2f);
+
+    std::vector<Ray> rays;
+    rays.reserve(RAY_COUNT);
+    for (int i = 0; i < RAY_COUNT; ++i) {
+        float x = posDist(rng);
+        float z = posDist(rng);
+        float y = SampleTerrainHeight(static_cast<int>(std::round(x)), static_cast<int>(std::round(z))) + 1.7f;
+        float yaw = angleDist(rng);
+        float pitch = pitchDist(rng);
+        glm::vec3 dir(std::cos(pitch) * std::cos(yaw), std::sin(pitch), std::cos(pitch) * std::sin(yaw));
+        rays.push_back({ glm::vec3(x, y, z), glm::normalize(dir) });
     }
-    
-    t = tNear;
-    return true;
-}
 
-ChunkKey WorldToChunk(const glm::vec3& pos)
-{
-    int cx = static_cast<int>(std::floor(pos.x / static_cast<float>(CHUNK_SIZE)));
-    int cz = static_cast<int>(std::floor(pos.z / static_cast<float>(CHUNK_SIZE)));
-    return { cx, cz };
+    std::vector<VoxelHit> ddaHits(RAY_COUNT), stepHits(RAY_COUNT);
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < RAY_COUNT; ++i) ddaHits[i] = RaycastVoxels(rays[i].origin, rays[i].direction, MAX_DIST);
+    auto t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < RAY_COUNT; ++i) stepHits[i] = RaycastVoxelsStepped(rays[i].origin, rays[i].direction, MAX_DIST);
+    auto t2 = std::chrono::steady_clock::now();
+
+    // DDA 按定义访问射线穿过的每个体素，作为参考结果
+    int ddaHitCount = 0, stepHitCount = 0, stepMissed = 0, stepWrongVoxel = 0;
+    for (int i = 0; i < RAY_COUNT; ++i) {
+        if (ddaHits[i].hit) ddaHitCount++;
+        if (stepHits[i].hit) stepHitCount++;
+        if (ddaHits[i].hit && !stepHits[i].hit) stepMissed++;
+        else if (ddaHits[i].hit && stepHits[i].hit &&
+                 (ddaHits[i].x != stepHits[i].x || ddaHits[i].y != stepHits[i].y || ddaHits[i].z != stepHits[i].z)) stepWrongVoxel++;
+    }
+
+    double ddaNs = std::chrono::duration<double, std::nano>(t1 - t0).count() / RAY_COUNT;
+    double stepNs = std::chrono::duration<double, std::nano>(t2 - t1).count() / RAY_COUNT;
+    std::cout << "[Bench] Rays: " << RAY_COUNT << ", chunks: " << g_loadedChunks.Size() << std::endl;
+    std::cout << "[Bench] DDA:     " << ddaNs << " ns/ray, hits " << ddaHitCount << std::endl;
+    std::cout << "[Bench] Stepper: " << stepNs << " ns/ray, hits " << stepHitCount
+              << ", missed " << stepMissed << ", wrong voxel " << stepWrongVoxel << std::endl;
 }
 
-float SampleTerrainHeight(int x, int z)
+void RunChunkMemoryReport()
 {
-    return terrainHeight(g_perlin, g_terrainParams, x, z);
+    std::cout << "[Bench] Chunk memory: packed block table vs legacy positions/colors/dense voxels" << std::endl;
+
+    g_loadedChunks.Clear();
+    g_loadedChunks.SetRadius(g_viewDistanceChunks, [](const ChunkKey&, ChunkData&) {});
+    g_loadedChunks.ForEachInView([](const ChunkKey& key) { g_loadedChunks.Insert(key, GenerateChunk(key)); });
+
+    // 只统计上传后常驻的区块数据 (网格、面掩码在上传后释放，两种格式都不计)
+    // 旧格式：positions + colors (各 12 字节/方块)、y 范围内的稠密体素 (1 字节/格) + 调色板、float 高度图
+    size_t blockCount = 0, packedBytes = 0, legacyBytes = 0;
+    g_loadedChunks.ForEach([&](const ChunkKey&, const ChunkData& chunk) {
+        size_t n = chunk.voxels.blocks.size();
+        size_t layers = static_cast<size_t>(std::max(chunk.voxels.maxY - chunk.voxels.minY + 1, 0));
+        std::bitset<BLOCK_TYPE_COUNT> types;
+        for (const auto& b : chunk.voxels.blocks) types.set(static_cast<size_t>(b.type));
+
+        blockCount += n;
+        packedBytes += n * sizeof(PackedBlock) + chunk.voxels.IndexBytes() + sizeof(ChunkHeights);
+        legacyBytes += n * 2 * sizeof(glm::vec3) + layers * CHUNK_SIZE * CHUNK_SIZE +
+                       (types.count() + 1) * sizeof(BlockType) + sizeof(HeightTile);
+    });
+
+    double chunks = static_cast<double>(g_loadedChunks.Size());
+    std::cout << "[Bench] Chunks: " << g_loadedChunks.Size() << ", avg blocks/chunk: " << blockCount / chunks << std::endl;
+    std::cout << "[Bench] Legacy: " << legacyBytes / chunks << " bytes/chunk" << std::endl;
+    std::cout << "[Bench] Packed: " << packedBytes / chunks << " bytes/chunk ("
+              << static_cast<double>(legacyBytes) / std::max<size_t>(packedBytes, 1) << "x smaller)" << std::endl;
 }
 
-ChunkData GenerateChunk(const ChunkKey& key)
+void RunChunkTableBenchmark()
 {
-    ChunkData chunk;
-    chunk.positions.reserve(CHUNK_SIZE * CHUNK_SIZE * 6);
-    chunk.colors.reserve(CHUNK_SIZE * CHUNK_SIZE * 6);
-    chunk.cubes.reserve(CHUNK_SIZE * CHUNK_SIZE * 6);
-
-    std::mt19937 rng(static_cast<std::uint32_t>((key.x * 73856093) ^ (key.z * 19349663) ^ 12345));
-
-    for (int lx = 0; lx < CHUNK_SIZE; ++lx) {
-        for (int lz = 0; lz < CHUNK_SIZE; ++lz) {
-            int worldX = key.x * CHUNK_SIZE + lx;
-            int worldZ = key.z * CHUNK_SIZE + lz;
-
-            float h = SampleTerrainHeight(worldX, worldZ);
-            int height = static_cast<int>(std::floor(h));
-
-            // 只生成地表与水面，减少实例数量
-            BlockType surfaceType = BlockType::Grass;
-            if (height < g_terrainParams.waterLevel) surfaceType = BlockType::Sand;
-            else if (height < g_terrainParams.waterLevel + g_terrainParams.beachHeight) surfaceType = BlockType::Sand;
-            else if (height > g_terrainParams.snowHeight) surfaceType = BlockType::Snow;
-            else surfaceType = BlockType::Grass;
-
-            glm::vec3 surfacePos(static_cast<float>(worldX), static_cast<float>(height), static_cast<float>(worldZ));
-            glm::vec3 surfaceColor = getBlockColor(surfaceType);
-
-            auto addBlock = [&](const glm::vec3& pos, const glm::vec3& color) {
-                chunk.positions.push_back(pos);
-                chunk.colors.push_back(color);
-                CubeObject cube;
-                cube.position = pos;
-                cube.scale = glm::vec3(1.0f);
-                cube.color = color;
-                chunk.cubes.push_back(cube);
-            };
-
-            addBlock(surfacePos, surfaceColor);
+    std::cout << "[Bench] Chunk table: open addressing (Morton keys) vs std::unordered_map" << std::endl;
 
-            // 水面（仅一层水面，进一步减少数据）
-            if (height < g_terrainParams.waterLevel) {
-                glm::vec3 waterPos(static_cast<float>(worldX), g_terrainParams.waterLevel, static_cast<float>(worldZ));
-                addBlock(waterPos, getBlockColor(BlockType::Water));
-            }
+    // 64 字节的占位负载，避免生成真实区块影响计时
+    struct BenchPayload {
+        std::array<std::uint64_t, 8> data{};
+    };
+    using Clock = std::chrono::steady_clock;
+    auto nsPerOp = [](Clock::time_point a, Clock::time_point b, size_t ops) {
+        return std::chrono::duration<double, std::nano>(b - a).count() / static_cast<double>(ops);
+    };
 
-            // 树木仅在草地表面生成
-            if (surfaceType == BlockType::Grass) {
-                float randVal = static_cast<float>(rng() % 1000) / 1000.0f;
-                if (randVal > g_terrainParams.treeThreshold) {
-                    int treeHeight = 4 + static_cast<int>(rng() % 3);
-                    for (int th = 1; th <= treeHeight; ++th) {
-                        glm::vec3 tPos = surfacePos + glm::vec3(0.0f, static_cast<float>(th), 0.0f);
-                        glm::vec3 tColor = getBlockColor(BlockType::Wood);
-                        addBlock(tPos, tColor);
-                    }
-                    for (int lx2 = -1; lx2 <= 1; ++lx2) {
-                        for (int lz2 = -1; lz2 <= 1; ++lz2) {
-                            for (int ly2 = 0; ly2 <= 1; ++ly2) {
-                                if (lx2 == 0 && lz2 == 0 && ly2 == 0) continue;
-                                glm::vec3 lPos = surfacePos + glm::vec3(static_cast<float>(lx2), static_cast<float>(treeHeight + ly2), static_cast<float>(lz2));
-                                glm::vec3 lColor = getBlockColor(BlockType::Leaves);
-                                addBlock(lPos, lColor);
-                            }
-                        }
-                    }
-                }
-            }
+    const int FIND_ROUNDS = 20;
+    std::uint64_t checksum = 0;
+    for (int radius : { 4, 8, 16, 32 }) {
+        // 以非原点为中心的视距窗口，模拟玩家走远后的坐标
+        std::vector<ChunkKey> keys;
+        for (int dz = -radius; dz <= radius; ++dz) {
+            for (int dx = -radius; dx <= radius; ++dx) keys.push_back({ 1000 + dx, -700 + dz });
+        }
+        std::vector<ChunkKey> lookups = keys;
+        std::shuffle(lookups.begin(), lookups.end(), std::mt19937(static_cast<std::uint32_t>(radius)));
+        const size_t findOps = lookups.size() * FIND_ROUNDS;
+
+        std::unordered_map<ChunkKey, BenchPayload, ChunkKeyHash> map;
+        auto m0 = Clock::now();
+        for (const auto& key : keys) map.emplace(key, BenchPayload{});
+        auto m1 = Clock::now();
+        for (int r = 0; r < FIND_ROUNDS; ++r) {
+            for (const auto& key : lookups) checksum += map.find(key)->second.data[0] + 1;
         }
+        auto m2 = Clock::now();
+        for (const auto& key : lookups) map.erase(key);
+        auto m3 = Clock::now();
+
+        ChunkTable<BenchPayload> table;
+        auto t0 = Clock::now();
+        for (const auto& key : keys) table.Insert(key, BenchPayload{});
+        auto t1 = Clock::now();
+        for (int r = 0; r < FIND_ROUNDS; ++r) {
+            for (const auto& key : lookups) checksum += table.Find(key)->data[0] + 1;
+        }
+        auto t2 = Clock::now();
+        for (const auto& key : lookups) table.Erase(key);
+        auto t3 = Clock::now();
+
+        std::cout << "[Bench] View distance " << radius << " (" << keys.size() << " chunks), ns/op insert/find/erase:" << std::endl;
+        std::cout << "[Bench]   unordered_map: " << nsPerOp(m0, m1, keys.size()) << " / " << nsPerOp(m1, m2, findOps)
+                  << " / " << nsPerOp(m2, m3, keys.size()) << std::endl;
+        std::cout << "[Bench]   ChunkTable:    " << nsPerOp(t0, t1, keys.size()) << " / " << nsPerOp(t1, t2, findOps)
+                  << " / " << nsPerOp(t2, t3, keys.size()) << std::endl;
     }
-
-    return chunk;
+    std::cout << "[Bench] Checksum: " << checksum << std::endl;
 }
 
-void RebuildVisibleTerrain()
+bool SetTerrainBlock(int x, int y, int z, BlockType type)
 {
-    size_t totalBlocks = 0;
-    for (const auto& kv : g_loadedChunks) totalBlocks += kv.second.positions.size();
-
-    std::vector<glm::vec3> instancePositions;
-    std::vector<glm::vec3> instanceColors;
-    instancePositions.reserve(totalBlocks);
-    instanceColors.reserve(totalBlocks);
-
-    g_cubes.clear();
-    g_terrainPositions.clear();
-    g_cubes.reserve(totalBlocks);
-    g_terrainPositions.reserve(totalBlocks);
-    g_spatialHash.Clear();
-
-    for (auto& kv : g_loadedChunks) {
-        auto& chunk = kv.second;
-        instancePositions.insert(instancePositions.end(), chunk.positions.begin(), chunk.positions.end());
-        instanceColors.insert(instanceColors.end(), chunk.colors.begin(), chunk.colors.end());
-        for (auto& cube : chunk.cubes) {
-            g_cubes.push_back(cube);
-            g_terrainPositions.push_back(cube.position);
-        }
+    // 玩家编辑 (仅主线程)：修改已加载区块，重新上传实例并写回磁盘缓存
+    ChunkKey key{ static_cast<int>(std::floor(static_cast<float>(x) / CHUNK_SIZE)),
+                  static_cast<int>(std::floor(static_cast<float>(z) / CHUNK_SIZE)) };
+    ChunkData* found = g_loadedChunks.Find(key);
+    if (!found) return false;
+    if (y < std::numeric_limits<std::int16_t>::min() || y > std::numeric_limits<std::int16_t>::max()) return false;
+
+    ChunkData& chunk = *found;
+    int lx = x - key.x * CHUNK_SIZE;
+    int lz = z - key.z * CHUNK_SIZE;
+    if (chunk.voxels.Get(lx, y, lz) == type) return false;
+
+    // 实例数量可能超过原槽位容量，释放后重新分配
+    ReleaseChunkGeometry(chunk);
+    EditChunkBlock(key, chunk, lx, y, lz, type);
+    chunk.editSerial = chunk.geometrySerial = ++g_chunkJobSerial;
+    PrepareChunkGeometry(key, chunk, CaptureChunkBorder(key));
+    UploadChunkGeometry(key, chunk);
+    // 边缘列变化时，共边的相邻区块在工作线程上重建
+    for (int side = 0; side < CHUNK_SIDE_COUNT; ++side) {
+        int edgeX, edgeZ;
+        ChunkEdgeColumn(side, side < CHUNK_SIDE_NEG_Z ? lz : lx, edgeX, edgeZ);
+        if (edgeX == lx && edgeZ == lz) QueueChunkRemesh(ChunkNeighbour(key, side));
     }
-
-    for (auto& cube : g_cubes) {
-        g_spatialHash.Add(&cube);
+    {
+        ScopedMsTimer timer(g_frameTimings.collisionUpdateMs);
+        RegisterChunkCollision(key, chunk.voxels);
     }
 
-    g_visibleInstanceCount = instancePositions.size();
-    if (g_terrainMesh) {
-        g_terrainMesh->updateInstanceData(instancePositions, instanceColors);
-    }
+    if (g_regionCache) g_regionCache->StoreAsync(key.x, key.z, EncodeChunkRecord(chunk));
+    return true;
 }
 
-void UpdateVisibleChunks(const glm::vec3& playerPos, bool force)
+void UploadChunkGeometry(const ChunkKey& key, ChunkData& chunk)
 {
-    ChunkKey center = WorldToChunk(playerPos);
-    std::unordered_set<ChunkKey, ChunkKeyHash> needed;
-    for (int dz = -VIEW_DISTANCE_CHUNKS; dz <= VIEW_DISTANCE_CHUNKS; ++dz) {
-        for (int dx = -VIEW_DISTANCE_CHUNKS; dx <= VIEW_DISTANCE_CHUNKS; ++dx) {
-            needed.insert({ center.x + dx, center.z + dz });
-        }
+    if (g_headless) {
+        // 无 GL 上下文：只丢弃工作线程准备的网格数据，体素仍用于碰撞与射线检测
+        chunk.meshData = ChunkMeshData();
+        chunk.faceMasks = std::vector<GLuint>();
+        return;
     }
-
-    bool removed = force;
-
-    for (auto it = g_loadedChunks.begin(); it != g_loadedChunks.end();) {
-        if (needed.find(it->first) == needed.end()) {
-            it = g_loadedChunks.erase(it);
-            removed = true;
-        } else {
-            ++it;
+    if (g_useGreedyMeshing) {
+        // 贪心网格：每个区块独立的顶点缓冲，上传后释放 CPU 端数据
+        if (!chunk.mesh) {
+            chunk.mesh = std::make_unique<ChunkMesh>();
+            g_terrainBlockCount += chunk.voxels.blocks.size();
         }
+        g_terrainQuadCount -= chunk.mesh->getQuadCount();
+        chunk.mesh->upload(chunk.meshData);
+        g_uploadBytesThisFrame += chunk.meshData.vertices.size() * sizeof(ChunkVertex);
+        g_terrainQuadCount += chunk.mesh->getQuadCount();
+        chunk.meshData = ChunkMeshData();
+        return;
     }
 
-    // 仅把缺失区块放入异步队列，按前方优先排序
-    std::vector<ChunkKey> toRequest;
-    glm::vec3 front = g_camera.GetFront();
-    glm::vec3 playerPosFlat = glm::vec3(playerPos.x, 0.0f, playerPos.z);
-    for (const auto& key : needed) {
-        if (g_loadedChunks.find(key) != g_loadedChunks.end()) continue;
-        if (g_chunkLoading.find(key) != g_chunkLoading.end()) continue;
-        toRequest.push_back(key);
+    if (!g_terrainMesh) return;
+    // 实例属性由紧凑方块表临时展开 (仅主线程，复用缓冲)；六个面都被遮挡的方块不占实例
+    static std::vector<glm::vec3> positions;
+    static std::vector<glm::vec3> colors;
+    static std::vector<GLuint> masks;
+    positions.clear();
+    colors.clear();
+    masks.clear();
+    bool haveMasks = chunk.faceMasks.size() == chunk.voxels.blocks.size();
+    for (size_t i = 0; i < chunk.voxels.blocks.size(); ++i) {
+        GLuint mask = haveMasks ? chunk.faceMasks[i] : InstancedMesh::ALL_FACES;
+        if (mask == 0) continue;
+        const PackedBlock& b = chunk.voxels.blocks[i];
+        positions.push_back(BlockWorldPosition(key, b));
+        colors.push_back(getBlockColor(b.type));
+        masks.push_back(mask);
     }
 
-    std::sort(toRequest.begin(), toRequest.end(), [&](const ChunkKey& a, const ChunkKey& b) {
-        glm::vec3 centerA(a.x * CHUNK_SIZE + CHUNK_SIZE * 0.5f, 0.0f, a.z * CHUNK_SIZE + CHUNK_SIZE * 0.5f);
-        glm::vec3 centerB(b.x * CHUNK_SIZE + CHUNK_SIZE * 0.5f, 0.0f, b.z * CHUNK_SIZE + CHUNK_SIZE * 0.5f);
-        glm::vec3 dirA = glm::normalize(centerA - playerPosFlat);
-        glm::vec3 dirB = glm::normalize(centerB - playerPosFlat);
-        float scoreA = glm::dot(dirA, glm::normalize(glm::vec3(front.x, 0.0f, front.z)));
-        float scoreB = glm::dot(dirB, glm::normalize(glm::vec3(front.x, 0.0f, front.z)));
-        // 更靠前优先，其次按距离近
-        if (std::abs(scoreA - scoreB) > 0.01f) return scoreA > scoreB;
-        float distA = glm::length(centerA - playerPosFlat);
-        float distB = glm::length(centerB - playerPosFlat);
-        return distA < distB;
-    });
+    // 每个区块独占一段实例区间 (按可见实例数分配)，合并时只上传该区块的数据
+    if (chunk.instanceSlot < 0) chunk.instanceSlot = g_terrainMesh->allocateSlot(positions.size());
+    else g_visibleFaceCount -= chunk.visibleFaces;
+    g_terrainMesh->updateSlot(chunk.instanceSlot, positions, colors, masks);
+    g_uploadBytesThisFrame += positions.size() * sizeof(glm::vec3) + colors.size() * sizeof(glm::vec3) + masks.size() * sizeof(GLuint);
+    chunk.visibleFaces = 0;
+    for (GLuint mask : masks) chunk.visibleFaces += std::bitset<6>(mask).count();
+    g_visibleFaceCount += chunk.visibleFaces;
+    chunk.faceMasks = std::vector<GLuint>();
+    g_visibleInstanceCount = g_terrainMesh->getSlotInstanceCount();
+}
 
-    {
-        std::lock_guard<std::mutex> lk(g_chunkMutex);
-        for (const auto& key : toRequest) {
-            if (g_loadedChunks.find(key) != g_loadedChunks.end()) continue;
-            if (g_chunkLoading.find(key) != g_chunkLoading.end()) continue;
-            g_chunkLoading.insert(key);
-            g_chunkRequestQueue.push(key);
-        }
-    }
-    if (!toRequest.empty()) g_chunkCV.notify_one();
-
-    // 处理已完成的区块，限制每帧合并数量
-    int merged = ProcessReadyChunks(needed, CHUNK_MERGE_PER_FRAME);
-    if (merged > 0) g_pendingMergedChunks += merged;
-
-    // 控制重建频率，避免每合并就全量重建
-    g_rebuildTimer += g_deltaTime;
-    bool needRebuild = false;
-    if (removed || force) needRebuild = true;
-    else if (g_pendingMergedChunks >= CHUNK_REBUILD_BATCH) needRebuild = true;
-    else if (g_pendingMergedChunks > 0 && g_rebuildTimer >= CHUNK_REBUILD_INTERVAL) needRebuild = true;
-
-    if (needRebuild) {
-        RebuildVisibleTerrain();
-        g_pendingMergedChunks = 0;
-        g_rebuildTimer = 0.0f;
+void ReleaseChunkGeometry(ChunkData& chunk)
+{
+    if (chunk.mesh) {
+        g_terrainQuadCount -= chunk.mesh->getQuadCount();
+        g_terrainBlockCount -= chunk.voxels.blocks.size();
+        chunk.mesh.reset();
     }
+    if (!g_terrainMesh || chunk.instanceSlot < 0) return;
+    g_terrainMesh->freeSlot(chunk.instanceSlot);
+    chunk.instanceSlot = -1;
+    g_visibleFaceCount -= chunk.visibleFaces;
+    chunk.visibleFaces = 0;
+    g_visibleInstanceCount = g_terrainMesh->getSlotInstanceCount();
+}
+
+void UpdateVisibleChunks(const glm::vec3& playerPos)
+{
+    PW_PROFILE_ZONE("UpdateVisibleChunks");
+    // 视距窗口只在所在区块变化时移动：回收离开视距的行/列，新进入的坐标交给调度器。
+    // 玩家停留在同一区块内时，这里不做任何与视距大小相关的工作
+    ChunkKey center = WorldToChunk(playerPos);
+    static std::vector<ChunkKey> entered;
+    entered.clear();
+    g_loadedChunks.Recenter(center,
+        [](const ChunkKey& key, ChunkData& chunk) {
+            ReleaseChunkGeometry(chunk);
+            ScopedMsTimer timer(g_frameTimings.collisionUpdateMs);
+            g_collisionWorld.RemoveChunk(key);
+        },
+        [](const ChunkKey& key) { entered.push_back(key); });
+
+    // 缺失区块进入优先队列，按上限逐步提交给线程池
+    ScheduleChunkRequests(entered, center, playerPos);
+
+    // 处理已完成的区块，限制每帧合并数量 (随工作线程数放宽，避免合并成为瓶颈)
+    int mergeLimit = CHUNK_MERGE_PER_FRAME;
+    if (g_chunkPool) mergeLimit = std::max(mergeLimit, static_cast<int>(g_chunkPool->GetWorkerCount()));
+    // 碰撞占用位图随区块合并/回收增量更新，不再全量重建
+    ProcessReadyChunks(mergeLimit);
+}
+
+void SetViewDistance(int chunks)
+{
+    chunks = std::min(std::max(chunks, MIN_VIEW_DISTANCE_CHUNKS), MAX_VIEW_DISTANCE_CHUNKS);
+    g_viewDistanceChunks = chunks;
+    g_viewDistanceWorld = static_cast<float>(CHUNK_SIZE * chunks);
+    g_settings.viewDistance = chunks;
+
+    // 半径变化时整体搬移槽位，视距外的区块释放；下一帧重新扫描窗口并取消视距外的请求
+    g_loadedChunks.SetRadius(chunks, [](const ChunkKey& key, ChunkData& chunk) {
+        ReleaseChunkGeometry(chunk);
+        g_collisionWorld.RemoveChunk(key);
+    });
+    g_heightTileCache.SetCapacity(HeightTileCache::CapacityForRadius(chunks));
+    g_scheduleRescan = true;
+    std::cout << "[Chunk] View distance: " << chunks << " chunks (" << g_viewDistanceWorld << " blocks)" << std::endl;
 }
 
 glm::vec3 GetRandomPointInView(const glm::vec3& center, float minRadius, float maxRadius)
 {
-    static std::mt19937 rng(std::random_device{}());
     std::uniform_real_distribution<float> radius(minRadius, maxRadius);
     std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
 
-    float r = radius(rng);
-    float a = angle(rng);
+    float r = radius(g_enemyRng);
+    float a = angle(g_enemyRng);
 
     float x = center.x + std::cos(a) * r;
     float z = center.z + std::sin(a) * r;
@@ -1128,66 +1081,261 @@ void EnforceEnemyViewDistance(const glm::vec3& playerPos)
 {
     if (!g_enemyPool) return;
 
-    const float maxDist = VIEW_DISTANCE_WORLD;
-    std::vector<Enemy*> toCull;
+    // Release/Acquire 都是 O(1)，列表在帧间复用，成批回收/补充也不会产生尖峰
+    const float maxDist = std::min(g_viewDistanceWorld, ENEMY_ACTIVE_RADIUS);
+    static std::vector<Enemy> toCull;
+    toCull.clear();
     const auto& activeEnemies = g_enemyPool->GetActiveEnemies();
-    for (auto enemy : activeEnemies) {
-        if (!enemy->IsActive()) continue;
-        if (glm::distance(playerPos, enemy->GetPosition()) > maxDist) {
+    for (const Enemy& enemy : activeEnemies) {
+        if (!enemy.IsActive()) continue;
+        if (glm::distance(playerPos, enemy.GetPosition()) > maxDist) {
             toCull.push_back(enemy);
         }
     }
 
-    for (auto enemy : toCull) {
+    for (const Enemy& enemy : toCull) {
         g_enemyPool->Release(enemy);
     }
 
     for (size_t i = 0; i < toCull.size(); ++i) {
-        glm::vec3 spawnPos = GetRandomPointInView(playerPos, VIEW_DISTANCE_WORLD * 0.3f, VIEW_DISTANCE_WORLD * 0.8f);
+        glm::vec3 spawnPos = GetRandomPointInView(playerPos, maxDist * 0.3f, maxDist * 0.8f);
         g_enemyPool->Acquire(spawnPos);
     }
 }
 
-void ChunkLoaderThread()
+float ScoreChunkRequest(const ChunkKey& key, const glm::vec3& playerPosFlat, const glm::vec3& frontFlat)
 {
-    while (true) {
-        ChunkKey key;
-        {
-            std::unique_lock<std::mutex> lk(g_chunkMutex);
-            g_chunkCV.wait(lk, [] { return g_chunkThreadExit || !g_chunkRequestQueue.empty(); });
-            if (g_chunkThreadExit) break;
-            key = g_chunkRequestQueue.front();
-            g_chunkRequestQueue.pop();
+    // 距离 (以区块为单位) 减去朝向加成：前方区块优先，但近处的身后区块仍先于远处的前方区块
+    glm::vec3 center(key.x * CHUNK_SIZE + CHUNK_SIZE * 0.5f, 0.0f, key.z * CHUNK_SIZE + CHUNK_SIZE * 0.5f);
+    glm::vec3 toChunk = center - playerPosFlat;
+    float dist = glm::length(toChunk);
+    float facing = dist > 1e-3f ? glm::dot(toChunk / dist, frontFlat) : 1.0f;
+    return dist / CHUNK_SIZE - CHUNK_FACING_BONUS * facing;
+}
+
+void ScheduleChunkRequests(const std::vector<ChunkKey>& entered, const ChunkKey& center, const glm::vec3& playerPos)
+{
+    PW_PROFILE_ZONE("ScheduleChunkRequests");
+    auto heapCompare = [](const PendingChunk& a, const PendingChunk& b) { return a.score > b.score; };
+
+    glm::vec3 playerPosFlat(playerPos.x, 0.0f, playerPos.z);
+    glm::vec3 front = g_camera.GetFront();
+    glm::vec3 frontFlat(front.x, 0.0f, front.z);
+    float frontLen = glm::length(frontFlat);
+    frontFlat = frontLen > 1e-3f ? frontFlat / frontLen : glm::vec3(0.0f, 0.0f, -1.0f);
+
+    // 1. 所在区块、视距或朝向明显变化：取消已离开视距的在途请求，丢弃过期的待提交请求并重新评分
+    bool rescan = g_scheduleRescan;
+    bool centerChanged = !(center == g_scheduleCenter) || rescan;
+    bool turned = glm::dot(frontFlat, g_scheduleFront) < CHUNK_RESCORE_FACING_COS;
+    if (centerChanged) {
+        g_chunkInFlight.ForEach([](const ChunkKey& key, std::shared_ptr<std::atomic<bool>>& cancelFlag) {
+            // 重新进入视距的请求恢复 (工作线程尚未检查标记时仍会正常生成)
+            cancelFlag->store(!g_loadedChunks.InView(key), std::memory_order_relaxed);
+        });
+    }
+    if (centerChanged || turned) {
+        g_scheduleCenter = center;
+        g_scheduleFront = frontFlat;
+        size_t kept = 0;
+        for (size_t i = 0; i < g_chunkPending.size(); ++i) {
+            PendingChunk item = g_chunkPending[i];
+            if (!g_loadedChunks.InView(item.key)) {
+                g_chunkPendingSet.erase(item.key);
+                g_chunkStats.dropped++;
+                continue;
+            }
+            item.score = ScoreChunkRequest(item.key, playerPosFlat, frontFlat);
+            g_chunkPending[kept++] = item;
         }
+        g_chunkPending.resize(kept);
+        std::make_heap(g_chunkPending.begin(), g_chunkPending.end(), heapCompare);
+    }
 
-        ChunkData data = GenerateChunk(key);
+    // 2. 新进入视距的坐标入堆；需要重新扫描时遍历整个视距窗口
+    auto enqueue = [&](const ChunkKey& key) {
+        if (g_loadedChunks.Contains(key)) return;
+        if (g_chunkInFlight.Contains(key)) return;
+        if (!g_chunkPendingSet.insert(key).second) return;
+        g_chunkPending.push_back({ key, ScoreChunkRequest(key, playerPosFlat, frontFlat) });
+        std::push_heap(g_chunkPending.begin(), g_chunkPending.end(), heapCompare);
+    };
+    if (rescan) {
+        g_scheduleRescan = false;
+        g_loadedChunks.ForEachInView(enqueue);
+    } else {
+        for (const auto& key : entered) enqueue(key);
+    }
 
-        {
-            std::lock_guard<std::mutex> lk(g_chunkMutex);
-            g_chunkReadyQueue.push({ key, std::move(data) });
+    // 3. 先提交已显示区块的边界重建，再按优先级提交生成请求。
+    // 在途任务数受限 (也是结果环的容量)，线程池队列保持很短，转向后新的优先级能立即生效
+    size_t maxInFlight = CHUNK_MAX_IN_FLIGHT_PER_WORKER * (g_chunkPool ? g_chunkPool->GetWorkerCount() : 1u);
+    auto inFlight = []() { return g_chunkInFlight.Size() + g_chunkRemeshInFlight; };
+    size_t remeshDone = 0;
+    for (; remeshDone < g_chunkRemeshQueue.size() && inFlight() < maxInFlight; ++remeshDone) {
+        ChunkKey key = g_chunkRemeshQueue[remeshDone];
+        const ChunkData* chunk = g_loadedChunks.Find(key);
+        if (!chunk) {
+            g_chunkRemeshSet.erase(key);
+            continue;
+        }
+        if (!SubmitChunkRemesh(key, *chunk)) break;
+        g_chunkRemeshSet.erase(key);
+    }
+    g_chunkRemeshQueue.erase(g_chunkRemeshQueue.begin(), g_chunkRemeshQueue.begin() + remeshDone);
+
+    while (!g_chunkPending.empty() && inFlight() < maxInFlight) {
+        std::pop_heap(g_chunkPending.begin(), g_chunkPending.end(), heapCompare);
+        ChunkKey key = g_chunkPending.back().key;
+        g_chunkPending.pop_back();
+        g_chunkPendingSet.erase(key);
+        if (!g_loadedChunks.InView(key)) {
+            g_chunkStats.dropped++;
+            continue;
+        }
+        if (g_loadedChunks.Contains(key)) continue;
+        if (!SubmitChunkRequest(key)) {
+            // 任务环已满：放回堆中，下一帧再提交
+            g_chunkPendingSet.insert(key);
+            g_chunkPending.push_back({ key, ScoreChunkRequest(key, playerPosFlat, frontFlat) });
+            std::push_heap(g_chunkPending.begin(), g_chunkPending.end(), heapCompare);
+            break;
         }
     }
 }
 
-int ProcessReadyChunks(const std::unordered_set<ChunkKey, ChunkKeyHash>& needed, int maxPerFrame)
+bool SubmitChunkRequest(const ChunkKey& key)
 {
-    int merged = 0;
-    int processed = 0;
-    while (processed < maxPerFrame) {
-        std::pair<ChunkKey, ChunkData> item;
-        {
-            std::lock_guard<std::mutex> lk(g_chunkMutex);
-            if (g_chunkReadyQueue.empty()) break;
-            item = std::move(g_chunkReadyQueue.front());
-            g_chunkReadyQueue.pop();
-            g_chunkLoading.erase(item.first);
+    if (!g_chunkPool) return false;
+    auto cancelFlag = std::make_shared<std::atomic<bool>>(false);
+    // 相邻已加载区块的边缘在主线程抓取，工作线程不访问 g_loadedChunks
+    auto border = std::make_shared<ChunkBorder>(CaptureChunkBorder(key));
+    std::uint64_t serial = ++g_chunkJobSerial;
+    // 在工作线程上生成区块，完成后写入该线程的结果环等待主线程合并
+    bool submitted = g_chunkPool->Submit([key, cancelFlag, border, serial]() {
+        ChunkResult result;
+        result.key = key;
+        result.serial = serial;
+        if (cancelFlag->load(std::memory_order_relaxed)) {
+            // 开始前已离开视距：不做任何生成工作
+            result.cancelled = true;
+        } else {
+            {
+                PW_PROFILE_ZONE("LoadOrGenerateChunk");
+                result.data = LoadOrGenerateChunk(key);
+            }
+            PW_PROFILE_ZONE("PrepareChunkGeometry");
+            PrepareChunkGeometry(key, result.data, *border);
         }
+        SpscRing<ChunkResult>& ring = *g_chunkResultRings[ChunkWorkerPool::GetCurrentWorkerIndex()];
+        while (!ring.TryPush(std::move(result))) std::this_thread::yield();
+    });
+    if (submitted) g_chunkInFlight.Insert(key, std::move(cancelFlag));
+    return submitted;
+}
 
-        if (needed.find(item.first) != needed.end()) {
-            g_loadedChunks.emplace(item.first, std::move(item.second));
+bool SubmitChunkRemesh(const ChunkKey& key, const ChunkData& chunk)
+{
+    if (!g_chunkPool) return false;
+    // 工作线程只读方块表与高度图的副本，区块本身在结果合并前可能被编辑或卸载
+    auto source = std::make_shared<ChunkData>();
+    source->voxels = chunk.voxels;
+    source->heights = chunk.heights;
+    auto border = std::make_shared<ChunkBorder>(CaptureChunkBorder(key));
+    std::uint64_t serial = ++g_chunkJobSerial;
+    bool submitted = g_chunkPool->Submit([key, source, border, serial]() {
+        PW_PROFILE_ZONE("PrepareChunkGeometry");
+        PrepareChunkGeometry(key, *source, *border);
+        ChunkResult result;
+        result.key = key;
+        result.serial = serial;
+        result.remesh = true;
+        result.data = std::move(*source);
+        SpscRing<ChunkResult>& ring = *g_chunkResultRings[ChunkWorkerPool::GetCurrentWorkerIndex()];
+        while (!ring.TryPush(std::move(result))) std::this_thread::yield();
+    });
+    if (submitted) g_chunkRemeshInFlight++;
+    return submitted;
+}
+
+void QueueChunkRemesh(const ChunkKey& key)
+{
+    // 无 GL 上下文时网格不上传，没有需要修正的边界
+    if (g_headless || !g_loadedChunks.Contains(key)) return;
+    if (g_chunkRemeshSet.insert(key).second) g_chunkRemeshQueue.push_back(key);
+}
+
+void CheckChunkBorders(const ChunkKey& key, const ChunkData& chunk, std::uint64_t serial)
+{
+    // 渲染数据生成后与四周已加载区块核对共边：生成时按噪声预测的一侧与实际边缘不同，
+    // 或抓取后相邻区块又被编辑，则重建；反过来相邻区块对本区块的预测不符时重建相邻区块
+    for (int side = 0; side < CHUNK_SIDE_COUNT; ++side) {
+        ChunkKey neighbourKey = ChunkNeighbour(key, side);
+        const ChunkData* neighbour = g_loadedChunks.Find(neighbourKey);
+        if (!neighbour) continue;
+        bool predicted = (chunk.predictedSides >> side) & 1;
+        if (predicted ? ChunkEdgeDiffersFromPrediction(*neighbour, side ^ 1) : neighbour->editSerial > serial) {
+            QueueChunkRemesh(key);
+        }
+        if (((neighbour->predictedSides >> (side ^ 1)) & 1) && ChunkEdgeDiffersFromPrediction(chunk, side)) {
+            QueueChunkRemesh(neighbourKey);
+        }
+    }
+}
+
+int ProcessReadyChunks(int maxPerFrame)
+{
+    PW_PROFILE_ZONE("ProcessReadyChunks");
+    int merged = 0;
+    size_t emptyRings = 0;
+    ChunkResult item;
+    // 轮流读取各工作线程的结果环，全部为空时结束 (从不等待工作线程)
+    while (merged < maxPerFrame && !g_chunkResultRings.empty() && emptyRings < g_chunkResultRings.size()) {
+        SpscRing<ChunkResult>& ring = *g_chunkResultRings[g_chunkResultCursor];
+        g_chunkResultCursor = (g_chunkResultCursor + 1) % g_chunkResultRings.size();
+        if (!ring.TryPop(item)) {
+            emptyRings++;
+            continue;
+        }
+        emptyRings = 0;
+        if (item.remesh) {
+            g_chunkRemeshInFlight--;
+            // 区块已卸载，或合并前又被编辑/重建 (结果过期) 时丢弃
+            ChunkData* chunk = g_loadedChunks.Find(item.key);
+            if (!chunk || item.serial <= chunk->geometrySerial) continue;
+            // 实例数量可能超过原槽位容量，释放后重新分配
+            ReleaseChunkGeometry(*chunk);
+            chunk->meshData = std::move(item.data.meshData);
+            chunk->faceMasks = std::move(item.data.faceMasks);
+            chunk->predictedSides = item.data.predictedSides;
+            chunk->geometrySerial = item.serial;
+            UploadChunkGeometry(item.key, *chunk);
+            CheckChunkBorders(item.key, *chunk, item.serial);
             merged++;
+            continue;
         }
-        processed++;
+        g_chunkInFlight.Erase(item.key);
+
+        if (item.cancelled) {
+            g_chunkStats.cancelled++;
+            if (g_loadedChunks.InView(item.key)) g_scheduleRescan = true;
+            continue;
+        }
+        g_chunkStats.generated++;
+        if (!g_loadedChunks.InView(item.key)) {
+            g_chunkStats.wasted++;
+            continue;
+        }
+        item.data.geometrySerial = item.serial;
+        auto result = g_loadedChunks.Insert(item.key, std::move(item.data));
+        if (result.second) {
+            UploadChunkGeometry(item.key, *result.first);
+            CheckChunkBorders(item.key, *result.first, item.serial);
+            ScopedMsTimer timer(g_frameTimings.collisionUpdateMs);
+            RegisterChunkCollision(item.key, result.first->voxels);
+        }
+        g_chunkStats.merged++;
+        merged++;
     }
     return merged;
 }
@@ -1273,9 +1421,9 @@ bool InitializeWindow()
     g_camera.SetMovementSpeed(5.0f); // 稍微快一点
     
     // 加载设置
-    GameSettings settings = Settings::Load("settings.ini");
-    g_camera.SetMouseSensitivity(settings.sensitivity);
-    g_camera.SetFOV(settings.fov);
+    g_settings = Settings::Load("settings.ini");
+    g_camera.SetMouseSensitivity(g_settings.sensitivity);
+    g_camera.SetFOV(g_settings.fov);
     
     std::cout << "[Init] Camera parameters configured" << std::endl;
 
@@ -1339,7 +1487,8 @@ bool InitializeScene()
     // 1. 加载着色器
     g_shader = new Shader("shaders/phong.vert", "shaders/phong.frag");
     g_instancedShader = new Shader("shaders/instanced.vert", "shaders/instanced.frag"); // 加载实例化着色器
-    if (g_shader->ID == 0 || g_instancedShader->ID == 0) return false;
+    g_chunkShader = new Shader("shaders/chunk.vert", "shaders/instanced.frag"); // 贪心网格与实例化共用片段着色器
+    if (g_shader->ID == 0 || g_instancedShader->ID == 0 || g_chunkShader->ID == 0) return false;
 
     // 获取原始数据以创建 InstancedMesh
     Geometry::MeshData cubeData = Geometry::createCubeData(1.0f);
@@ -1351,29 +1500,8 @@ bool InitializeScene()
     g_terrainMesh = new InstancedMesh(cubeData.vertices, cubeData.indices);
 
 
-    // 3. 初始化分块地形并基于视距加载
-    g_cubes.clear();
-    g_terrainPositions.clear();
-    g_spatialHash.Clear();
-    if (!g_chunkThreadStarted) {
-        g_chunkThreadExit = false;
-        g_chunkThread = std::thread(ChunkLoaderThread);
-        g_chunkThreadStarted = true;
-    }
-
-    // 先同步生成玩家所在区块，避免首帧掉落
-    ChunkKey origin = WorldToChunk(g_camera.GetPosition());
-    g_loadedChunks.emplace(origin, GenerateChunk(origin));
-    RebuildVisibleTerrain();
-    // 再异步加载视距内其他区块
-    UpdateVisibleChunks(g_camera.GetPosition(), true);
-    std::cout << "[Init] Terrain generated (streaming). Block count: " << g_visibleInstanceCount << std::endl;
-
-    // 4. 调整摄像机高度以防出生在地底
-    float spawnY = SampleTerrainHeight(0, 0) + 2.0f;
-    if (spawnY < g_terrainParams.waterLevel + 2.0f) spawnY = g_terrainParams.waterLevel + 2.0f;
-    g_camera.SetPosition(glm::vec3(0.0f, spawnY, 0.0f));
-    std::cout << "[Init] Adjusted spawn height: " << spawnY << std::endl;
+    // 3. 地形、出生点与 AI (与无窗口模式共用)
+    InitializeWorld();
 
     // 初始化准星
     g_crosshairShader = new Shader("shaders/crosshair.vert", "shaders/crosshair.frag");
@@ -1425,14 +1553,73 @@ bool InitializeScene()
     glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 7 * sizeof(float), (void*)(3 * sizeof(float)));
     glBindVertexArray(0);
 
-    // 4. 初始化 AI 系统
-    g_enemyPool = new EnemyPool(100); // 初始池大小 100
-    g_director = new AIDirector(g_enemyPool);
+    // 11. 性能 HUD (默认隐藏)
+    g_perfHud = new PerfHud();
 
     std::cout << "[Init] Scene build complete" << std::endl;
     return true;
 }
 
+// 不依赖 GL 的场景部分：区块线程池、磁盘缓存、初始地形、出生点与 AI 系统
+void InitializeWorld()
+{
+    g_useGreedyMeshing = g_settings.greedyMeshing != 0;
+    if (!g_headless) std::cout << "[Init] Terrain path: " << (g_useGreedyMeshing ? "greedy mesh" : "instanced cubes") << std::endl;
+
+    // 初始化分块地形并基于视距加载
+    g_collisionWorld.Clear();
+    if (!g_chunkPool) {
+        g_chunkPool = new ChunkWorkerPool(static_cast<unsigned int>(std::max(0, g_settings.chunkWorkers)));
+        size_t maxInFlight = CHUNK_MAX_IN_FLIGHT_PER_WORKER * g_chunkPool->GetWorkerCount();
+        for (unsigned int i = 0; i < g_chunkPool->GetWorkerCount(); ++i) {
+            g_chunkResultRings.push_back(std::make_unique<SpscRing<ChunkResult>>(maxInFlight));
+        }
+        std::cout << "[Init] Chunk worker pool started with " << g_chunkPool->GetWorkerCount() << " worker(s)" << std::endl;
+    }
+    // 飞行基准不读写磁盘缓存，每次运行都从生成开始，结果可重复
+    if (!g_regionCache && g_flythroughReportPath.empty()) {
+        g_regionCache = new RegionCache(REGION_DIRECTORY, ComputeWorldTag());
+    }
+    const char* noisePath = "Scalar";
+    if (Perlin2D::GetBatchPath() == Perlin2D::BatchPath::AVX2) noisePath = "AVX2";
+    else if (Perlin2D::GetBatchPath() == Perlin2D::BatchPath::SSE2) noisePath = "SSE2";
+    std::cout << "[Init] Terrain noise batch path: " << noisePath << std::endl;
+
+    // 先同步生成玩家所在区块，避免首帧掉落
+    ChunkKey origin = WorldToChunk(g_camera.GetPosition());
+    SetViewDistance(g_settings.viewDistance);
+    g_loadedChunks.Recenter(origin, [](const ChunkKey&, ChunkData&) {}, [](const ChunkKey&) {});
+    ChunkData* originChunk = g_loadedChunks.Insert(origin, LoadOrGenerateChunk(origin)).first;
+    PrepareChunkGeometry(origin, *originChunk, ChunkBorder());
+    UploadChunkGeometry(origin, *originChunk);
+    RegisterChunkCollision(origin, originChunk->voxels);
+    // 再异步加载视距内其他区块
+    UpdateVisibleChunks(g_camera.GetPosition());
+    if (g_headless) {
+        std::cout << "[Init] Terrain generated (streaming, no GPU upload). Origin chunk blocks: "
+                  << originChunk->voxels.blocks.size() << std::endl;
+    } else if (g_useGreedyMeshing) {
+        std::cout << "[Init] Terrain generated (streaming). Blocks: " << g_terrainBlockCount
+                  << ", greedy quads: " << g_terrainQuadCount << " (cube faces: " << g_terrainBlockCount * 6 << ")" << std::endl;
+    } else {
+        std::cout << "[Init] Terrain generated (streaming). Origin chunk blocks: " << originChunk->voxels.blocks.size()
+                  << ", instances: " << g_visibleInstanceCount << " (fully hidden cubes dropped)"
+                  << ", visible faces: " << g_visibleFaceCount << " of " << g_visibleInstanceCount * 6 << std::endl;
+    }
+
+    // 调整摄像机高度以防出生在地底
+    float spawnY = SampleTerrainHeight(0, 0) + 2.0f;
+    if (spawnY < g_terrainParams.waterLevel + 2.0f) spawnY = g_terrainParams.waterLevel + 2.0f;
+    g_camera.SetPosition(glm::vec3(0.0f, spawnY, 0.0f));
+    std::cout << "[Init] Adjusted spawn height: " << spawnY << std::endl;
+
+    // 初始化 AI 系统
+    g_enemyPool = new EnemyPool(100); // 初始池大小 100
+    g_director = new AIDirector(g_enemyPool);
+
+    if (!g_flythroughReportPath.empty()) StartFlythrough();
+}
+
 // 移除旧的 SpawnEnemies 函数，现在由 AIDirector 接管
 
 // ============================================================================
@@ -1442,26 +1629,58 @@ bool InitializeScene()
 void Cleanup()
 {
     std::cout << "[Cleanup] Releasing system resources..." << std::endl;
-
-    // 停止区块线程
-    if (g_chunkThreadStarted) {
-        {
-            std::lock_guard<std::mutex> lk(g_chunkMutex);
-            g_chunkThreadExit = true;
-        }
-        g_chunkCV.notify_all();
-        if (g_chunkThread.joinable()) g_chunkThread.join();
-        g_chunkThreadStarted = false;
+    if (!g_traceOutputPath.empty()) WriteProfilerTrace();
+
+    // 停止区块线程池，丢弃尚未合并的结果
+    delete g_chunkPool;
+    g_chunkPool = nullptr;
+    g_chunkResultRings.clear();
+    g_chunkInFlight.Clear();
+    g_chunkRemeshQueue.clear();
+    g_chunkRemeshSet.clear();
+    g_chunkRemeshInFlight = 0;
+
+    const auto frameWaits = LockWaitHistogram::FrameThread().Snapshot();
+    const auto backgroundWaits = LockWaitHistogram::Background().Snapshot();
+    std::cout << "[Cleanup] Lock waits (frame thread / background):";
+    for (int i = 0; i < LockWaitHistogram::BUCKET_COUNT; ++i) {
+        std::cout << " " << LockWaitHistogram::BUCKET_LABELS[i] << " " << frameWaits[i] << "/" << backgroundWaits[i];
+    }
+    std::cout << std::endl;
+
+    // 线程池停止后再关闭磁盘缓存，写完所有排队的区块
+    if (g_regionCache) {
+        std::cout << "[Cleanup] Region cache: " << g_regionCache->GetHitCount() << " hit(s), "
+                  << g_regionCache->GetMissCount() << " miss(es), " << g_regionCache->GetWriteCount() << " write(s)" << std::endl;
+        delete g_regionCache;
+        g_regionCache = nullptr;
     }
 
     delete g_shader;
     delete g_instancedShader;
+    delete g_chunkShader;
     delete g_cubeMesh;
     // delete g_planeMesh;
     
     delete g_director;
     delete g_enemyPool;
+    delete g_flythroughPath;
+    delete g_flythroughRecorder;
+    g_flythroughPath = nullptr;
+    g_flythroughRecorder = nullptr;
     delete g_terrainMesh; // 记得删除
+    // 区块网格持有 GL 资源，必须在销毁上下文之前释放
+    g_loadedChunks.Clear();
+    g_collisionWorld.Clear();
+    if (g_headless) {
+        // 无窗口模式没有 GL 资源与窗口，也不回写玩家设置
+        std::cout << "[Cleanup] Cleanup finished (headless)" << std::endl;
+        return;
+    }
+    ChunkMesh::releaseSharedResources();
+    Profiler::SetGpuEnabled(false); // 删除 GPU 计时查询
+    delete g_perfHud;
+    g_perfHud = nullptr;
     delete g_crosshairShader;
     delete g_lineShader; // 删除 LineShader
     glDeleteVertexArrays(1, &g_crosshairVAO);
@@ -1471,11 +1690,10 @@ void Cleanup()
     glDeleteVertexArrays(1, &g_uiVAO);
     glDeleteBuffers(1, &g_uiVBO);
 
-    // 保存设置
-    GameSettings settings;
-    settings.sensitivity = g_camera.GetMouseSensitivity();
-    settings.fov = g_camera.GetFOV();
-    Settings::Save("settings.ini", settings);
+    // 保存设置 (保留文件中的其他配置项)
+    g_settings.sensitivity = g_camera.GetMouseSensitivity();
+    g_settings.fov = g_camera.GetFOV();
+    Settings::Save("settings.ini", g_settings);
 
     if (g_window)
     {
@@ -1492,6 +1710,112 @@ void Cleanup()
 // 主循环函数实现
 // ============================================================================
 
+/**
+ * @brief 按 g_deltaTime 推进一步模拟 (窗口与无窗口模式共用)
+ *
+ * 功能详解:
+ *  - 区块流式加载与合并、吞吐统计
+ *  - 玩家物理、AI 导演与敌人更新 (暂停时跳过)
+ *  - 子弹轨迹寿命推进
+ */
+void UpdateSimulation()
+{
+    PW_PROFILE_ZONE("Simulation");
+    g_frameTimings = FlythroughFrame();
+
+    // 视距内加载地形
+    {
+        ScopedMsTimer timer(g_frameTimings.updateChunksMs);
+        UpdateVisibleChunks(g_camera.GetPosition());
+    }
+    if (g_chunkPool && g_chunkPool->UpdateThroughput(g_deltaTime) && g_chunkPool->GetThroughput() > 0.0f) {
+        std::cout << "[Chunk] Throughput: " << g_chunkPool->GetThroughput() << " chunks/s ("
+                  << g_chunkPool->GetWorkerCount() << " workers)" << std::endl;
+        std::cout << "[Chunk] Requests: generated " << g_chunkStats.generated << ", merged " << g_chunkStats.merged
+                  << ", wasted " << g_chunkStats.wasted << ", dropped " << g_chunkStats.dropped
+                  << ", cancelled " << g_chunkStats.cancelled << ", pending " << g_chunkPending.size() << std::endl;
+        std::cout << "[Chunk] Lock waits: frame thread " << LockWaitHistogram::FrameThread().GetWaitCount()
+                  << ", background " << LockWaitHistogram::Background().GetWaitCount() << std::endl;
+        if (g_useGreedyMeshing) {
+            std::cout << "[Chunk] Terrain quads: " << g_terrainQuadCount << " (instanced cubes would draw "
+                      << g_terrainBlockCount * 6 << " faces)" << std::endl;
+        } else {
+            std::cout << "[Chunk] Visible cube faces: " << g_visibleFaceCount << " of "
+                      << g_visibleInstanceCount * 6 << std::endl;
+        }
+    }
+
+    // 物理更新
+    g_camera.UpdatePhysics(g_deltaTime, g_collisionWorld);
+
+    // 敌人逻辑 (暂停时冻结)
+    if (!g_isPaused) {
+        ScopedMsTimer timer(g_frameTimings.enemyUpdateMs);
+        glm::vec3 playerPos = g_camera.GetPosition();
+        g_director->Update(g_deltaTime, g_isShooting, playerPos, std::min(g_viewDistanceWorld, ENEMY_ACTIVE_RADIUS));
+        g_isShooting = false;
+        g_enemyPool->UpdateAll(g_deltaTime, playerPos, g_collisionWorld);
+        EnforceEnemyViewDistance(playerPos);
+    }
+
+    // 子弹轨迹到期移除
+    for (auto it = g_bulletTrails.begin(); it != g_bulletTrails.end(); ) {
+        it->timeAlive += g_deltaTime;
+        if (it->timeAlive >= it->maxLifetime) it = g_bulletTrails.erase(it);
+        else ++it;
+    }
+}
+
+// 创建飞行路径与记录器，并固定所有随机序列 (射击散布、生成点、敌人重新放置)
+void StartFlythrough()
+{
+    const glm::vec3& pos = g_camera.GetPosition();
+    g_flythroughPath = new FlythroughPath(FlythroughPath::Default(pos.x, pos.z, g_camera.GetYaw()));
+    g_flythroughRecorder = new FlythroughRecorder();
+    g_flythroughStartTime = -1.0f;
+
+    std::srand(WORLD_SEED);
+    g_enemyRng.seed(WORLD_SEED);
+    g_director->SetSeed(WORLD_SEED);
+    std::cout << "[Flythrough] " << g_flythroughPath->GetSegments().size() << " segment(s), "
+              << g_flythroughPath->GetDuration() << "s, report: " << g_flythroughReportPath << std::endl;
+}
+
+// 按路径放置摄像机；路径结束时写出报告并结束主循环。返回本帧是否处于飞行中
+bool UpdateFlythrough()
+{
+    if (!g_flythroughRecorder || !g_running) return false;
+    if (g_flythroughStartTime < 0.0f) g_flythroughStartTime = g_simTime;
+
+    float t = g_simTime - g_flythroughStartTime;
+    if (t > g_flythroughPath->GetDuration()) {
+        FlythroughRunInfo info;
+        info.mode = g_headless ? "headless" : "windowed";
+        info.seed = WORLD_SEED;
+        info.viewDistance = g_viewDistanceChunks;
+        info.workers = g_chunkPool ? g_chunkPool->GetWorkerCount() : 0;
+        g_flythroughRecorder->PrintSummary();
+        g_flythroughRecorder->WriteReport(g_flythroughReportPath, *g_flythroughPath, info);
+        g_running = false;
+        return false;
+    }
+
+    FlythroughPose pose = g_flythroughPath->Sample(t);
+    float ground = SampleTerrainHeight(static_cast<int>(std::round(pose.x)), static_cast<int>(std::round(pose.z)));
+    g_camera.SetPosition(glm::vec3(pose.x, ground + FLYTHROUGH_EYE_HEIGHT, pose.z));
+    g_camera.SetOrientation(pose.yaw, 0.0f);
+    g_flythroughSegment = pose.segment;
+    return true;
+}
+
+void RecordFlythroughFrame(float frameMs)
+{
+    FlythroughFrame frame = g_frameTimings;
+    frame.frameMs = frameMs;
+    frame.segment = g_flythroughSegment;
+    g_flythroughRecorder->Record(frame);
+}
+
 void RenderLoop()
 {
     std::cout << "[Loop] Entering main render loop..." << std::endl;
@@ -1500,6 +1824,10 @@ void RenderLoop()
     // 主事件循环：处理窗口事件、更新逻辑、渲染画面
     while (g_running && !glfwWindowShouldClose(g_window))
     {
+        auto frameStart = std::chrono::steady_clock::now();
+        PW_PROFILE_FRAME();
+        PW_PROFILE_ZONE("Frame");
+
         // -------- 时间计算阶段 --------
         // 计算当前帧时间
         float currentFrame = static_cast<float>(glfwGetTime());
@@ -1507,38 +1835,42 @@ void RenderLoop()
         g_lastFrame = currentFrame;
         // Clamp delta time to avoid physics tunneling during window resize stalls
         g_deltaTime = std::min(g_deltaTime, 0.05f);
+        g_simTime = currentFrame;
+        g_uploadBytesThisFrame = 0;
 
         // -------- 事件处理阶段 --------
         // 处理所有待处理的窗口事件 (键盘、鼠标、窗口大小调整等)
         glfwPollEvents();
 
         // -------- 输入处理阶段 --------
+        // 飞行基准期间由路径驱动摄像机，并按住射击
+        bool flying = UpdateFlythrough();
+
         // 处理键盘输入（WASD 移动）
-        if (glfwGetKey(g_window, GLFW_KEY_W) == GLFW_PRESS)
-            g_camera.ProcessKeyboard(Camera::Movement::FORWARD, g_deltaTime);
-        if (glfwGetKey(g_window, GLFW_KEY_S) == GLFW_PRESS)
-            g_camera.ProcessKeyboard(Camera::Movement::BACKWARD, g_deltaTime);
-        if (glfwGetKey(g_window, GLFW_KEY_A) == GLFW_PRESS)
-            g_camera.ProcessKeyboard(Camera::Movement::LEFT, g_deltaTime);
-        if (glfwGetKey(g_window, GLFW_KEY_D) == GLFW_PRESS)
-            g_camera.ProcessKeyboard(Camera::Movement::RIGHT, g_deltaTime);
-        
-        // 跳跃输入
-        if (glfwGetKey(g_window, GLFW_KEY_SPACE) == GLFW_PRESS)
-            g_camera.ProcessJump();
-
-        // 视距内加载地形
-        UpdateVisibleChunks(g_camera.GetPosition());
-        
+        if (!flying)
+        {
+            if (glfwGetKey(g_window, GLFW_KEY_W) == GLFW_PRESS)
+                g_camera.ProcessKeyboard(Camera::Movement::FORWARD, g_deltaTime);
+            if (glfwGetKey(g_window, GLFW_KEY_S) == GLFW_PRESS)
+                g_camera.ProcessKeyboard(Camera::Movement::BACKWARD, g_deltaTime);
+            if (glfwGetKey(g_window, GLFW_KEY_A) == GLFW_PRESS)
+                g_camera.ProcessKeyboard(Camera::Movement::LEFT, g_deltaTime);
+            if (glfwGetKey(g_window, GLFW_KEY_D) == GLFW_PRESS)
+                g_camera.ProcessKeyboard(Camera::Movement::RIGHT, g_deltaTime);
+
+            // 跳跃输入
+            if (glfwGetKey(g_window, GLFW_KEY_SPACE) == GLFW_PRESS)
+                g_camera.ProcessJump();
+        }
+
         // 射击输入 (连发)
-        if (!g_isPaused && glfwGetMouseButton(g_window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS)
+        if (!g_isPaused && (flying || glfwGetMouseButton(g_window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS))
         {
             ProcessShooting();
         }
-            
-        // 物理更新
-        g_camera.UpdatePhysics(g_deltaTime, g_terrainPositions);
 
+        // -------- 模拟更新阶段 --------
+        UpdateSimulation();
 
         // -------- 清除缓冲区阶段 --------
         // 清除颜色缓冲和深度缓冲
@@ -1554,7 +1886,7 @@ void RenderLoop()
         glm::mat4 view = g_camera.GetViewMatrix();
         // 投影矩阵使用当前窗口宽高比，支持任意窗口拉伸
         float aspect = (g_windowHeight > 0) ? (static_cast<float>(g_windowWidth) / static_cast<float>(g_windowHeight)) : (16.0f / 9.0f);
-        float farClip = VIEW_DISTANCE_WORLD + 40.0f;
+        float farClip = g_viewDistanceWorld + 40.0f;
         glm::mat4 projection = g_camera.GetProjectionMatrix(
             g_camera.GetFOV(),                        // FOV (动态获取)
             aspect,                                   // 当前窗口宽高比
@@ -1590,27 +1922,74 @@ void RenderLoop()
             // g_planeMesh->draw(); // 不再绘制平面，使用生成的体素地图
         }
 
-        // 2. 渲染立方体 (地形)
+        // 2. 渲染地形 (贪心网格或实例化立方体)
         {
-            // 切换到实例化着色器
-            g_instancedShader->use();
+            PW_PROFILE_ZONE("Render.Terrain");
+            PW_PROFILE_GPU_ZONE("Terrain");
+            Shader* terrainShader = g_useGreedyMeshing ? g_chunkShader : g_instancedShader;
+            terrainShader->use();
             
             // 设置公共 Uniforms (View, Proj, Light)
-            g_instancedShader->setMat4("uView", view);
-            g_instancedShader->setMat4("uProjection", projection);
-            g_instancedShader->setVec3("uCameraPos", g_camera.GetPosition());
+            terrainShader->setMat4("uView", view);
+            terrainShader->setMat4("uProjection", projection);
+            terrainShader->setVec3("uCameraPos", g_camera.GetPosition());
             
-            g_instancedShader->setVec3("uLight_Position", lightPos);
-            g_instancedShader->setVec3("uLight_Ambient", glm::vec3(0.3f, 0.3f, 0.3f));
-            g_instancedShader->setVec3("uLight_Diffuse", glm::vec3(0.8f, 0.8f, 0.8f));
-            g_instancedShader->setVec3("uLight_Specular", glm::vec3(1.0f, 1.0f, 1.0f));
-
-            g_instancedShader->setVec3("uMaterial_Ambient", glm::vec3(0.1f, 0.1f, 0.1f)); 
-            g_instancedShader->setVec3("uMaterial_Specular", glm::vec3(0.1f, 0.1f, 0.1f));
-            g_instancedShader->setFloat("uMaterial_Shininess", 8.0f);
+            terrainShader->setVec3("uLight_Position", lightPos);
+            terrainShader->setVec3("uLight_Ambient", glm::vec3(0.3f, 0.3f, 0.3f));
+            terrainShader->setVec3("uLight_Diffuse", glm::vec3(0.8f, 0.8f, 0.8f));
+            terrainShader->setVec3("uLight_Specular", glm::vec3(1.0f, 1.0f, 1.0f));
+
+            terrainShader->setVec3("uMaterial_Ambient", glm::vec3(0.1f, 0.1f, 0.1f)); 
+            terrainShader->setVec3("uMaterial_Specular", glm::vec3(0.1f, 0.1f, 0.1f));
+            terrainShader->setFloat("uMaterial_Shininess", 8.0f);
             
-            // 绘制调用：只需要一次！
-            g_terrainMesh->drawInstanced(static_cast<unsigned int>(g_visibleInstanceCount));
+            // 区块级视锥剔除：只提交与视锥相交的区块
+            g_frustum.Update(projection * view);
+            g_culledChunks = 0;
+            g_culledInstances = 0;
+            if (g_useGreedyMeshing) {
+                // 每个区块一次绘制，只包含暴露面
+                g_loadedChunks.ForEach([](const ChunkKey&, const ChunkData& chunk) {
+                    if (!chunk.mesh) return;
+                    if (!g_frustum.IntersectsAABB(chunk.boundsMin, chunk.boundsMax)) {
+                        g_culledChunks++;
+                        g_culledInstances += chunk.mesh->getQuadCount();
+                        return;
+                    }
+                    chunk.mesh->draw();
+                });
+            } else {
+                // 可见槽位合并为一次 MultiDraw
+                g_visibleSlots.clear();
+                g_loadedChunks.ForEach([](const ChunkKey&, const ChunkData& chunk) {
+                    if (chunk.instanceSlot < 0) return;
+                    if (!g_frustum.IntersectsAABB(chunk.boundsMin, chunk.boundsMax)) {
+                        g_culledChunks++;
+                        g_culledInstances += g_terrainMesh->getSlotCount(chunk.instanceSlot);
+                        return;
+                    }
+                    g_visibleSlots.push_back(chunk.instanceSlot);
+                });
+                g_terrainMesh->drawSlots(g_visibleSlots);
+            }
+
+            // 剔除统计：每秒输出一次平均值
+            size_t terrainSubmitted = g_useGreedyMeshing ? g_terrainQuadCount : g_visibleInstanceCount;
+            g_drawnInstances = terrainSubmitted - g_culledInstances;
+
+            g_cullStatsFrames++;
+            g_cullStatsChunks += static_cast<size_t>(g_culledChunks);
+            g_cullStatsInstances += g_culledInstances;
+            g_cullStatsTimer += g_deltaTime;
+            if (g_cullStatsTimer >= 1.0f) {
+                std::cout << "[Render] Frustum culled per frame: " << g_cullStatsChunks / g_cullStatsFrames << "/"
+                          << g_loadedChunks.Size() << " chunks, " << g_cullStatsInstances / g_cullStatsFrames << "/"
+                          << terrainSubmitted << (g_useGreedyMeshing ? " quads" : " instances") << std::endl;
+                g_cullStatsTimer = 0.0f;
+                g_cullStatsFrames = 0;
+                g_cullStatsChunks = 0;
+                g_cullStatsInstances = 0;
+            }
         }
 
         // 切换回标准着色器绘制其他物体
@@ -1626,15 +2005,10 @@ void RenderLoop()
 
         // 3. 更新并渲染敌人
         {
-            // 如果没暂停，才更新逻辑
-            if (!g_isPaused) {
-                glm::vec3 playerPos = g_camera.GetPosition();
-                g_director->Update(g_deltaTime, g_isShooting, playerPos, VIEW_DISTANCE_WORLD);
-                g_isShooting = false; 
-                g_enemyPool->UpdateAll(g_deltaTime, playerPos, g_terrainPositions);
-                EnforceEnemyViewDistance(playerPos);
-            }
-            else 
+            PW_PROFILE_ZONE("Render.Enemies");
+            PW_PROFILE_GPU_ZONE("Enemies");
+            // 敌人逻辑已在 UpdateSimulation 中更新，暂停时处理设置调整
+            if (g_isPaused)
             {
                 // 暂停时的设置逻辑 (处理连续按键)
                 bool changed = false;
@@ -1674,18 +2048,19 @@ void RenderLoop()
 
             // 获取活跃敌人列表进行渲染
             const auto& activeEnemies = g_enemyPool->GetActiveEnemies();
-            for (auto enemy : activeEnemies)
+            g_drawnInstances += activeEnemies.size();
+            for (const Enemy& enemy : activeEnemies)
             {
                 // 渲染 (即使是尸体也渲染，直到被回收)
-                g_shader->setVec3("uMaterial_Diffuse", enemy->GetColor());
+                g_shader->setVec3("uMaterial_Diffuse", enemy.GetColor());
 
                 glm::mat4 model = glm::mat4(1.0f);
-                model = glm::translate(model, enemy->GetPosition());
+                model = glm::translate(model, enemy.GetPosition());
                 
                 // 应用旋转 (包含倒地动画)
-                model *= glm::mat4_cast(enemy->GetRotation());
+                model *= glm::mat4_cast(enemy.GetRotation());
                 
-                model = glm::scale(model, enemy->GetScale());
+                model = glm::scale(model, enemy.GetScale());
                 
                 g_shader->setMat4("uModel", model);
                 
@@ -1718,10 +2093,10 @@ void RenderLoop()
             };
 
             const auto& activeEnemies = g_enemyPool->GetActiveEnemies();
-            for (auto enemy : activeEnemies)
+            for (const Enemy& enemy : activeEnemies)
             {
-                if (!enemy->IsActive()) continue;
-                glm::vec3 headPos = enemy->GetPosition() + glm::vec3(0.0f, enemy->GetScale().y * 0.6f + 0.4f, 0.0f);
+                if (!enemy.IsActive()) continue;
+                glm::vec3 headPos = enemy.GetPosition() + glm::vec3(0.0f, enemy.GetScale().y * 0.6f + 0.4f, 0.0f);
                 glm::vec4 clip = projection * view * glm::vec4(headPos, 1.0f);
                 if (clip.w <= 0.0f) continue;
                 glm::vec3 ndc = glm::vec3(clip) / clip.w;
@@ -1736,7 +2111,7 @@ void RenderLoop()
                 float pad = 2.0f / winW * 2.0f;         // 2px (x)
                 float startX = ndc.x - barWidth * 0.5f;
                 float startY = ndc.y + (24.0f / winH * 2.0f); // 24px above
-                float hp = glm::clamp(enemy->GetHealth(), 0.0f, ENEMY_MAX_HEALTH);
+                float hp = glm::clamp(enemy.GetHealth(), 0.0f, ENEMY_MAX_HEALTH);
                 float ratio = hp / ENEMY_MAX_HEALTH;
                 glm::vec3 bgColor(0.08f, 0.08f, 0.08f);
                 glm::vec3 hpColor = (ratio > 0.5f) ? glm::vec3(0.25f, 0.8f, 0.25f) : glm::vec3(0.95f, 0.35f, 0.1f);
@@ -1756,6 +2131,8 @@ void RenderLoop()
 
         // 4. 渲染武器 (右下角小尺寸，避免遮挡视野)
         {
+            PW_PROFILE_ZONE("Render.Weapon");
+            PW_PROFILE_GPU_ZONE("Weapon");
             glEnable(GL_DEPTH_TEST);
 
             glm::mat4 viewIdentity = glm::mat4(1.0f);
@@ -1779,6 +2156,8 @@ void RenderLoop()
 
         // 渲染子弹轨迹 (透明混合)
         if (!g_bulletTrails.empty()) {
+            PW_PROFILE_ZONE("Render.BulletTrails");
+            PW_PROFILE_GPU_ZONE("BulletTrails");
             glEnable(GL_BLEND);
             glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
             
@@ -1788,13 +2167,7 @@ void RenderLoop()
             
             std::vector<float> lineData;
             for (auto it = g_bulletTrails.begin(); it != g_bulletTrails.end(); ) {
-                it->timeAlive += g_deltaTime;
-                if (it->timeAlive >= it->maxLifetime) {
-                    it = g_bulletTrails.erase(it);
-                    continue;
-                }
-                
-                // 渐变透明度
+                // 渐变透明度 (轨迹寿命在 UpdateSimulation 中推进)
                 float alpha = 1.0f - (it->timeAlive / it->maxLifetime);
                 
                 // Start Point
@@ -1823,6 +2196,7 @@ void RenderLoop()
                 glBindBuffer(GL_ARRAY_BUFFER, g_lineVBO);
                 // 使用 glBufferData 重新分配并上传数据
                 glBufferData(GL_ARRAY_BUFFER, lineData.size() * sizeof(float), lineData.data(), GL_DYNAMIC_DRAW);
+                g_uploadBytesThisFrame += lineData.size() * sizeof(float);
                 
                 // 正确的顶点数量是 float 总数 / 7
                 glDrawArrays(GL_LINES, 0, (GLsizei)lineData.size() / 7);
@@ -1835,6 +2209,8 @@ void RenderLoop()
         // 5. 绘制准星 (UI 层，最后绘制，关闭深度测试)
         if (!g_isPaused)
         {
+            PW_PROFILE_ZONE("Render.Crosshair");
+            PW_PROFILE_GPU_ZONE("Crosshair");
             glDisable(GL_DEPTH_TEST); // 关闭深度测试，确保准星在最上层
             g_crosshairShader->use();
             g_crosshairShader->setFloat("uAlpha", 1.0f);
@@ -1851,6 +2227,8 @@ void RenderLoop()
         else
         {
             // 绘制暂停菜单 UI (进度条)
+            PW_PROFILE_ZONE("Render.PauseMenu");
+            PW_PROFILE_GPU_ZONE("PauseMenu");
             glDisable(GL_DEPTH_TEST);
             g_crosshairShader->use(); // 复用这个简单的 2D Shader
             g_crosshairShader->setFloat("uAlpha", 0.4f); // 半透明，避免遮挡视野
@@ -1951,26 +2329,173 @@ void RenderLoop()
             glEnable(GL_DEPTH_TEST);
         }
 
+        // 6. 性能 HUD (最上层，一次绘制调用)
+        if (g_perfHud->IsVisible())
+        {
+            PW_PROFILE_ZONE("Render.PerfHud");
+            PW_PROFILE_GPU_ZONE("PerfHud");
+            PerfHudCounters counters;
+            counters.drawnInstances = g_drawnInstances;
+            counters.loadedChunks = g_loadedChunks.Size();
+            counters.queuedRequests = g_chunkPending.size();
+            counters.inFlightRequests = g_chunkInFlight.Size();
+            counters.activeEnemies = g_enemyPool->GetActiveCount();
+            counters.bulletTrails = g_bulletTrails.size();
+            counters.uploadBytes = g_uploadBytesThisFrame;
+            g_perfHud->Draw(counters, g_windowWidth, g_windowHeight);
+        }
+
         // -------- 缓冲区交换阶段 --------
         // 交换前后缓冲区 (双缓冲)，将渲染结果显示到屏幕
         // 这可以防止画面闪烁
-        glfwSwapBuffers(g_window);
+        {
+            PW_PROFILE_ZONE("SwapBuffers");
+            glfwSwapBuffers(g_window);
+        }
+        g_perfHud->RecordFrame(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - frameStart).count());
+
+        if (flying) {
+            RecordFlythroughFrame(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - frameStart).count());
+        }
     }
 
     std::cout << "[Loop] Exited main render loop" << std::endl;
 }
 
+/**
+ * @brief 无窗口模拟 (不创建 GLFW 窗口与 GL 上下文)
+ *
+ * 功能详解:
+ *  - 以固定步长运行与窗口模式相同的 UpdateSimulation，不等待垂直同步，快于实时
+ *  - 脚本化输入：持续前进并缓慢转向，按住射击，定期跳跃越过障碍
+ *  - 结束时输出模拟时长与实际耗时，用于无显卡环境下的回归与性能测量
+ */
+int RunHeadless(const HeadlessOptions& options)
+{
+    constexpr float TURN_RATE_DEGREES = 12.0f; // 每秒转向角度
+    constexpr float JUMP_INTERVAL = 1.5f;      // 跳跃间隔 (秒)
+
+    g_headless = true;
+    std::cout << "[Headless] Simulating at dt = " << options.deltaTime << "s" << std::endl;
+
+    g_settings = Settings::Load("settings.ini");
+    g_camera.SetMovementSpeed(5.0f);
+    g_camera.SetMouseSensitivity(g_settings.sensitivity);
+    InitializeWorld();
+
+    // 飞行基准的帧数由路径时长决定
+    const bool flythrough = g_flythroughRecorder != nullptr;
+    float nextJump = JUMP_INTERVAL;
+    int frames = 0;
+    auto wallStart = std::chrono::steady_clock::now();
+    while (g_running && (flythrough || frames < options.frames)) {
+        auto stepStart = std::chrono::steady_clock::now();
+        PW_PROFILE_FRAME();
+        PW_PROFILE_ZONE("Frame");
+        g_deltaTime = options.deltaTime;
+        g_simTime += g_deltaTime;
+
+        // 脚本化输入 (转向按鼠标灵敏度换算为偏移量)
+        bool flying = UpdateFlythrough();
+        if (!flying && !g_running) break;
+        if (!flying) {
+            g_camera.ProcessKeyboard(Camera::Movement::FORWARD, g_deltaTime);
+            g_camera.ProcessMouseMovement(TURN_RATE_DEGREES * g_deltaTime / g_camera.GetMouseSensitivity(), 0.0f);
+            if (g_simTime >= nextJump) {
+                g_camera.ProcessJump();
+                nextJump += JUMP_INTERVAL;
+            }
+        }
+        ProcessShooting();
+
+        UpdateSimulation();
+        frames++;
+        if (flying) RecordFlythroughFrame(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - stepStart).count());
+    }
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+    const glm::vec3& pos = g_camera.GetPosition();
+    std::cout << "[Headless] Simulated " << g_simTime << "s in " << wallSeconds << "s wall ("
+              << (wallSeconds > 0.0 ? g_simTime / wallSeconds : 0.0) << "x real time, "
+              << (frames > 0 ? wallSeconds * 1000.0 / frames : 0.0) << " ms/frame)" << std::endl;
+    std::cout << "[Headless] Loaded chunks: " << g_loadedChunks.Size() << ", merged " << g_chunkStats.merged
+              << ", pending " << g_chunkPending.size() << ", in flight " << g_chunkInFlight.Size() << std::endl;
+    std::cout << "[Headless] Active enemies: " << g_enemyPool->GetActiveCount()
+              << (g_director->IsHordeActive() ? " (horde active)" : "") << ", player at ("
+              << pos.x << ", " << pos.y << ", " << pos.z << ")" << std::endl;
+    std::cout << "[Headless] Enemy pool: capacity " << g_enemyPool->GetCapacity()
+              << ", slab allocations " << g_enemyPool->GetAllocationCount() << std::endl;
+
+    Cleanup();
+    return EXIT_SUCCESS;
+}
+
 // ============================================================================
 // 主程序入口
 // ============================================================================
 
-int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[])
+int main(int argc, char* argv[])
 {
 #ifdef _WIN32
     // 设置控制台代码页为 UTF-8，解决乱码问题
     SetConsoleOutputCP(65001);
 #endif
 
+    LockWaitHistogram::MarkFrameThread();
+    PW_PROFILE_THREAD("Main");
+
+    // 命令行基准模式 (不创建窗口)
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--bench-raycast") {
+            RunRaycastBenchmark();
+            return EXIT_SUCCESS;
+        }
+        if (std::string(argv[i]) == "--bench-chunk-memory") {
+            RunChunkMemoryReport();
+            return EXIT_SUCCESS;
+        }
+        if (std::string(argv[i]) == "--bench-chunktable") {
+            RunChunkTableBenchmark();
+            return EXIT_SUCCESS;
+        }
+    }
+
+    // 无窗口模拟：--headless [--frames N] [--dt S]
+    // 飞行基准：--bench-flythrough [--out report.json] (可与 --headless 组合)
+    // 报告对比：--bench-compare baseline.json current.json [--tolerance 0.1]
+    bool headless = false;
+    HeadlessOptions headlessOptions;
+    std::string flythroughOut = "flythrough.json";
+    bool flythrough = false;
+    const char* compareBaseline = nullptr;
+    const char* compareCurrent = nullptr;
+    float compareTolerance = 0.1f;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--headless") headless = true;
+        else if (arg == "--frames" && i + 1 < argc) headlessOptions.frames = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--dt" && i + 1 < argc) headlessOptions.deltaTime = std::max(0.001f, static_cast<float>(std::atof(argv[++i])));
+        else if (arg == "--bench-flythrough") flythrough = true;
+        else if (arg == "--out" && i + 1 < argc) flythroughOut = argv[++i];
+        else if (arg == "--bench-compare" && i + 2 < argc) {
+            compareBaseline = argv[++i];
+            compareCurrent = argv[++i];
+        }
+        else if (arg == "--tolerance" && i + 1 < argc) compareTolerance = std::max(0.0f, static_cast<float>(std::atof(argv[++i])));
+        else if (arg == "--trace" && i + 1 < argc) g_traceOutputPath = argv[++i];
+    }
+    if (compareBaseline) return CompareFlythroughReports(compareBaseline, compareCurrent, compareTolerance);
+    if (flythrough) g_flythroughReportPath = flythroughOut;
+    if (headless) {
+        try {
+            return RunHeadless(headlessOptions);
+        } catch (const std::exception& e) {
+            std::cerr << "[Exception] Unexpected error during headless simulation: " << e.what() << std::endl;
+            Cleanup();
+            return EXIT_FAILURE;
+        }
+    }
+
     std::cout << "===========================================================" << std::endl;
     std::cout << "  OpenGL baseline renderer starting" << std::endl;
     std::cout << "  Standard: C++17 | Display: OpenGL 4.6 Core" << std::endl;
@@ -1994,6 +2519,7 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[])
             Cleanup();
             return EXIT_FAILURE;
         }
+        Profiler::SetGpuEnabled(true);
 
         // 初始化场景
         if (!InitializeScene())
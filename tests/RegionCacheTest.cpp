@@ -0,0 +1,202 @@
+// ============================================================================
+// RegionCacheTest - 区域文件缓存的读写测试 (不创建窗口，只链接引擎库)
+// 覆盖：读者仍持有映射时重写区域文件、覆盖写入后的压缩、方块编辑写回后重新加载
+// ============================================================================
+
+#include "RegionCache.h"
+#include "World.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+int g_failures = 0;
+
+#define CHECK(cond)                                                                      \
+    do {                                                                                 \
+        if (!(cond)) {                                                                   \
+            std::cerr << "[Test] " << __FILE__ << ":" << __LINE__ << " CHECK failed: " #cond \
+                      << std::endl;                                                      \
+            g_failures++;                                                                \
+        }                                                                                \
+    } while (0)
+
+// 每个测试使用独立的临时目录
+std::filesystem::path MakeTempDir(const std::string& name)
+{
+    auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / ("pixelwar_" + name + "_" + std::to_string(stamp));
+    std::filesystem::remove_all(dir);
+    return dir;
+}
+
+// 高度图全部取 tag，方块数量可控，便于区分不同版本的记录
+RegionChunkRecord MakeRecord(float tag, std::size_t blockCount)
+{
+    RegionChunkRecord record;
+    record.heights.assign(CHUNK_SIZE * CHUNK_SIZE, tag);
+    record.blocks.resize(blockCount);
+    for (std::size_t i = 0; i < blockCount; ++i) {
+        record.blocks[i] = { static_cast<std::uint8_t>(i & 0xff), static_cast<std::uint8_t>(BlockType::Stone),
+                             static_cast<std::int16_t>(i >> 8) };
+    }
+    return record;
+}
+
+bool SameRecord(const RegionChunkRecord& a, const RegionChunkRecord& b)
+{
+    if (a.heights != b.heights || a.blocks.size() != b.blocks.size()) return false;
+    for (std::size_t i = 0; i < a.blocks.size(); ++i) {
+        if (a.blocks[i].column != b.blocks[i].column || a.blocks[i].type != b.blocks[i].type || a.blocks[i].y != b.blocks[i].y) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 等待写线程写完 count 个区块
+void WaitForWrites(const RegionCache& cache, std::size_t count)
+{
+    while (cache.GetWriteCount() < count) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+// 1. 另一个缓存实例仍映射着旧文件时，世界标签变化导致整个区域重写 (旧实现原地截断，旧映射读取时 SIGBUS)
+void TestRewriteWhileMapped()
+{
+    std::filesystem::path dir = MakeTempDir("region_rewrite");
+    const RegionChunkRecord large = MakeRecord(1.0f, 8192);
+    const RegionChunkRecord small = MakeRecord(2.0f, 4);
+    {
+        RegionCache writer(dir.string(), 1);
+        writer.StoreAsync(0, 0, large);
+        writer.Shutdown();
+    }
+
+    RegionCache reader(dir.string(), 1);
+    RegionChunkRecord loaded;
+    CHECK(reader.Load(0, 0, loaded)); // 此后 reader 一直持有该区域的映射
+    CHECK(SameRecord(loaded, large));
+
+    {
+        RegionCache rewriter(dir.string(), 2);
+        rewriter.StoreAsync(0, 0, small);
+        rewriter.Shutdown();
+        CHECK(rewriter.GetWriteCount() == 1);
+    }
+
+    // 旧映射仍指向被替换掉的旧文件，读取完整且不会越过新文件末尾
+    loaded = RegionChunkRecord();
+    CHECK(reader.Load(0, 0, loaded));
+    CHECK(SameRecord(loaded, large));
+
+    RegionCache fresh(dir.string(), 2);
+    loaded = RegionChunkRecord();
+    CHECK(fresh.Load(0, 0, loaded));
+    CHECK(SameRecord(loaded, small));
+    fresh.Shutdown();
+    reader.Shutdown();
+    std::filesystem::remove_all(dir);
+}
+
+// 2. 同一区块反复覆盖写入：文件大小保持有界 (发生压缩)，并发读取始终得到某个完整版本
+void TestCompactionUnderConcurrentReads()
+{
+    std::filesystem::path dir = MakeTempDir("region_compact");
+    const int WRITES = 200;
+    const std::size_t BLOCKS = 2048; // 每条记录约 9 KB
+    const RegionChunkRecord neighbour = MakeRecord(-1.0f, 16);
+    {
+        RegionCache cache(dir.string(), 7);
+        cache.StoreAsync(1, 0, neighbour);
+        WaitForWrites(cache, 1);
+
+        std::atomic<bool> stop{ false };
+        std::atomic<int> badReads{ 0 };
+        std::thread readerThread([&]() {
+            RegionChunkRecord r;
+            while (!stop.load()) {
+                if (cache.Load(0, 0, r)) {
+                    float tag = r.heights.empty() ? -2.0f : r.heights[0];
+                    if (tag < 0.0f || tag >= static_cast<float>(WRITES) || !SameRecord(r, MakeRecord(tag, BLOCKS))) badReads++;
+                }
+                if (!cache.Load(1, 0, r) || !SameRecord(r, neighbour)) badReads++;
+            }
+        });
+
+        for (int i = 0; i < WRITES; ++i) {
+            cache.StoreAsync(0, 0, MakeRecord(static_cast<float>(i), BLOCKS));
+            WaitForWrites(cache, static_cast<std::size_t>(i) + 2);
+        }
+        stop = true;
+        readerThread.join();
+        CHECK(badReads.load() == 0);
+        CHECK(cache.GetCompactionCount() > 0);
+        cache.Shutdown();
+    }
+
+    // 不压缩时文件约 1.8 MB；压缩后垃圾不超过 max(256 KB, 有效数据) 再加一条记录
+    std::uintmax_t size = std::filesystem::file_size(dir / "r.0.0.pwr");
+    CHECK(size < 600 * 1024);
+
+    RegionCache reopened(dir.string(), 7);
+    RegionChunkRecord loaded;
+    CHECK(reopened.Load(0, 0, loaded));
+    CHECK(SameRecord(loaded, MakeRecord(static_cast<float>(WRITES - 1), BLOCKS)));
+    CHECK(reopened.Load(1, 0, loaded));
+    CHECK(SameRecord(loaded, neighbour));
+    reopened.Shutdown();
+    std::filesystem::remove_all(dir);
+}
+
+// 3. 方块编辑写回 (SetTerrainBlock 的持久化路径)：重新加载后编辑仍在
+void TestEditPersistence()
+{
+    std::filesystem::path dir = MakeTempDir("region_edit");
+    const ChunkKey key{ 3, -2 };
+    int lx = 5, lz = 9;
+    int y = 0;
+    {
+        RegionCache cache(dir.string(), ComputeWorldTag());
+        g_regionCache = &cache;
+        ChunkData chunk = LoadOrGenerateChunk(key); // 未命中：生成并排队写入
+        y = static_cast<int>(std::floor(chunk.heights.Get(lx * CHUNK_SIZE + lz))) + 3;
+        CHECK(EditChunkBlock(key, chunk, lx, y, lz, BlockType::Wood));
+        CHECK(!EditChunkBlock(key, chunk, lx, y, lz, BlockType::Wood));
+        cache.StoreAsync(key.x, key.z, EncodeChunkRecord(chunk));
+        cache.Shutdown();
+        g_regionCache = nullptr;
+    }
+
+    RegionCache cache(dir.string(), ComputeWorldTag());
+    g_regionCache = &cache;
+    ChunkData reloaded = LoadOrGenerateChunk(key);
+    CHECK(cache.GetHitCount() == 1);
+    CHECK(reloaded.voxels.Get(lx, y, lz) == BlockType::Wood);
+    CHECK(EditChunkBlock(key, reloaded, lx, y, lz, BlockType::Air));
+    CHECK(reloaded.voxels.Get(lx, y, lz) == BlockType::Air);
+    cache.Shutdown();
+    g_regionCache = nullptr;
+    std::filesystem::remove_all(dir);
+}
+
+} // namespace
+
+int main()
+{
+    TestRewriteWhileMapped();
+    TestCompactionUnderConcurrentReads();
+    TestEditPersistence();
+
+    if (g_failures > 0) {
+        std::cerr << "[Test] RegionCache: " << g_failures << " failure(s)" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "[Test] RegionCache: all passed" << std::endl;
+    return EXIT_SUCCESS;
+}